@@ -0,0 +1,457 @@
+/*
+   V5: ceval.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <setjmp.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "ptrmap.h"
+#include "ipa.h"
+#include "ceval.h"
+
+extern int verbose;
+
+/*
+  Compile-time evaluation of calls.
+
+  A call to a pure function, see ipa.c, with constant arguments gives
+  the same value whenever it is made, so it is made once here and
+  replaced by its value.  The evaluator computes like the machine
+  would: arithmetic wraps around, && and || leave out their right
+  operand when the left one decides, and running off the end of a
+  function returns 0.
+
+  A pure function may still loop forever, recurse too deep or divide
+  by zero.  Each statement and expression node run costs a unit of
+  fuel; a call that runs out of fuel, nests too deep or fails is left
+  to the program, so the failure happens when it would have, and is
+  not tried again.  The whole program gets a budget too, to keep the
+  compile time bounded.
+*/
+
+#define CEVAL_FUEL 100000          /* fuel for one call */
+#define CEVAL_BUDGET 1000000       /* fuel for the whole program */
+#define CEVAL_DEPTH 1000           /* deepest call allowed */
+
+enum exec_status
+{
+  EXEC_NORMAL,
+  EXEC_BREAK,
+  EXEC_CONTINUE,
+  EXEC_RETURN
+};
+
+struct cell
+{
+  long value;
+  struct cell *next;               /* next cell allocated */
+};
+
+static struct ptrmap cells;        /* (symbol, depth) -> cell */
+static struct cell *all_cells;
+static long *stack;                /* arguments being computed */
+static size_t sp, stack_size;
+static size_t depth;               /* depth of the call being run */
+static long retval;                /* value of the last return */
+static unsigned jump_level;        /* loops left to leave by a jump */
+static unsigned long fuel;         /* fuel left for this call */
+static unsigned long budget = CEVAL_BUDGET; /* left for the program */
+static jmp_buf give_up;
+static struct ptrmap failed;       /* (call, node id) -> call */
+
+static size_t nfolded;
+static unsigned long fuel_used;
+
+static long eval (NODE *);
+static enum exec_status exec_list (NODE *);
+
+static void
+burn (void)
+{
+  if (fuel == 0)
+    longjmp (give_up, 1);
+  fuel--;
+}
+
+static long *
+cell (SYMBOL *s)
+{
+  struct cell *c = ptrmap_get (&cells, s, depth);
+
+  if (!c)
+    {
+      c = calloc (1, sizeof (*c));
+      if (!c)
+	exit (EXIT_FAILURE);
+      c->next = all_cells;
+      all_cells = c;
+      ptrmap_put (&cells, s, depth, c);
+    }
+  return &c->value;
+}
+
+static long
+call (NODE *node)
+{
+  SYMBOL *fnc = node->v.funcall.symbol;
+  ARGLIST *arg;
+  SYMLIST *param;
+  size_t base = sp, n = 0, i;
+
+  if (!fnc->v.fnc->pure || depth == CEVAL_DEPTH)
+    longjmp (give_up, 1);
+
+  for (arg = node->v.funcall.args; arg; arg = arg->next)
+    n++;
+  if (sp + n > stack_size)
+    {
+      stack_size = stack_size ? stack_size * 2 + n : 256 + n;
+      stack = realloc (stack, stack_size * sizeof (*stack));
+      if (!stack)
+	exit (EXIT_FAILURE);
+    }
+  sp += n;
+  /* The argument list is kept backwards; the values of the pure
+     arguments do not depend on the order they are computed in */
+  for (arg = node->v.funcall.args, i = 0; arg; arg = arg->next, i++)
+    stack[base + i] = eval (arg->node);
+
+  depth++;
+  /* The parameters are kept backwards too */
+  for (param = fnc->v.fnc->param, i = 0; param && i < n;
+       param = param->next, i++)
+    *cell (param->symbol) = stack[base + i];
+  sp = base;
+
+  if (exec_list (fnc->v.fnc->entry_point) != EXEC_RETURN)
+    retval = 0;
+  depth--;
+  return retval;
+}
+
+static long
+eval (NODE *node)
+{
+  unsigned long l, r;
+
+  burn ();
+  switch (node->type) {
+  case NODE_CONST:
+    return node->v.number;
+  case NODE_VAR:
+    return *cell (node->v.symbol);
+  case NODE_EXPR:
+    return eval (node->v.expr);
+  case NODE_CALL:
+    return call (node);
+  case NODE_UNOP:
+    l = eval (node->left);
+    if (node->v.opcode == OPCODE_NEG)
+      return -l;
+    return !l;
+  case NODE_BINOP:
+    if (node->v.opcode == OPCODE_AND)
+      return eval (node->left) ? eval (node->right) != 0 : 0;
+    if (node->v.opcode == OPCODE_OR)
+      return eval (node->left) ? 1 : eval (node->right) != 0;
+    l = eval (node->left);
+    r = eval (node->right);
+    switch (node->v.opcode) {
+    case OPCODE_ADD:
+      return l + r;
+    case OPCODE_SUB:
+      return l - r;
+    case OPCODE_MUL:
+      return l * r;
+    case OPCODE_DIV:
+      if (r == 0)
+	longjmp (give_up, 1);
+      if ((long) r == -1)
+	return -l;
+      return (long) l / (long) r;
+    case OPCODE_EQ:
+      return l == r;
+    case OPCODE_NE:
+      return l != r;
+    case OPCODE_LT:
+      return (long) l < (long) r;
+    case OPCODE_GT:
+      return (long) l > (long) r;
+    case OPCODE_LE:
+      return (long) l <= (long) r;
+    case OPCODE_GE:
+      return (long) l >= (long) r;
+    case OPCODE_MOD:
+      if (r == 0)
+	longjmp (give_up, 1);
+      if ((long) r == -1)
+	return 0;
+      return (long) l % (long) r;
+    case OPCODE_SHL:
+      return l << (r & 63);
+    case OPCODE_SHR:
+      return (long) l >> (r & 63);
+    case OPCODE_BAND:
+      return l & r;
+    default:
+      break;
+    }
+    break;
+  default:
+    break;
+  }
+  longjmp (give_up, 1);
+  return 0;
+}
+
+static enum exec_status
+exec (NODE *node)
+{
+  enum exec_status status;
+
+  burn ();
+  switch (node->type) {
+  case NODE_NOOP:
+  case NODE_FNC_DECL:
+    return EXEC_NORMAL;
+  case NODE_CALL:
+    call (node);
+    return EXEC_NORMAL;
+  case NODE_EXPR:
+    eval (node->v.expr);
+    return EXEC_NORMAL;
+  case NODE_ASGN:
+    *cell (node->v.asgn.symbol) = eval (node->v.asgn.expr);
+    return EXEC_NORMAL;
+  case NODE_VAR_DECL:
+    *cell (node->v.vardecl.symbol) =
+      node->v.vardecl.expr ? eval (node->v.vardecl.expr) : 0;
+    return EXEC_NORMAL;
+  case NODE_RETURN:
+    retval = node->v.expr ? eval (node->v.expr) : 0;
+    return EXEC_RETURN;
+  case NODE_JUMP:
+    jump_level = node->v.jump.level ? node->v.jump.level : 1;
+    if (node->v.jump.type == JUMP_BREAK)
+      return EXEC_BREAK;
+    return EXEC_CONTINUE;
+  case NODE_COMPOUND:
+    return exec_list (node->v.expr);
+  case NODE_CONDITION:
+    if (eval (node->v.condition.cond))
+      return exec_list (node->v.condition.iftrue_stmt);
+    return exec_list (node->v.condition.iffalse_stmt);
+  case NODE_ITERATION:
+    while (eval (node->v.iteration.cond))
+      {
+	status = exec_list (node->v.iteration.stmt);
+	if (status == EXEC_RETURN)
+	  return status;
+	if (status != EXEC_NORMAL && --jump_level > 0)
+	  return status;
+	if (status == EXEC_BREAK)
+	  break;
+      }
+    return EXEC_NORMAL;
+  default:
+    /* A pure function prints nothing */
+    longjmp (give_up, 1);
+    return EXEC_NORMAL;
+  }
+}
+
+static enum exec_status
+exec_list (NODE *node)
+{
+  enum exec_status status;
+
+  for (; node; node = node->right)
+    if ((status = exec (node)) != EXEC_NORMAL)
+      return status;
+  return EXEC_NORMAL;
+}
+
+static void
+free_cells (void)
+{
+  while (all_cells)
+    {
+      struct cell *c = all_cells;
+      all_cells = c->next;
+      free (c);
+    }
+  ptrmap_free (&cells);
+}
+
+/* Run the call NODE; returns nonzero and its value in *VALUE if it
+   finished */
+static int
+run (NODE *node, long *value)
+{
+  unsigned long start = budget < CEVAL_FUEL ? budget : CEVAL_FUEL;
+  volatile int ok = 0;
+
+  fuel = start;
+  ptrmap_init (&cells);
+  depth = sp = 0;
+  if (setjmp (give_up) == 0)
+    {
+      *value = call (node);
+      ok = 1;
+    }
+  free_cells ();
+
+  budget -= start - fuel;
+  fuel_used += start - fuel;
+  return ok;
+}
+
+static int
+constant (NODE *node)
+{
+  return strip (node)->type == NODE_CONST;
+}
+
+/* Fold the calls of the expression NODE, the innermost first */
+static void
+fold_expr (NODE *node)
+{
+  ARGLIST *arg, *next;
+  long value;
+
+  if (!node)
+    return;
+  switch (node->type) {
+  case NODE_EXPR:
+    fold_expr (node->v.expr);
+    return;
+  case NODE_UNOP:
+    fold_expr (node->left);
+    return;
+  case NODE_BINOP:
+    fold_expr (node->left);
+    fold_expr (node->right);
+    return;
+  case NODE_CALL:
+    break;
+  default:
+    return;
+  }
+
+  for (arg = node->v.funcall.args; arg; arg = arg->next)
+    fold_expr (arg->node);
+  if (!node->v.funcall.symbol->v.fnc->pure || budget == 0)
+    return;
+  for (arg = node->v.funcall.args; arg; arg = arg->next)
+    if (!constant (arg->node))
+      return;
+  /* A call that failed once fails again */
+  if (ptrmap_get (&failed, node, node->node_id))
+    return;
+  if (!run (node, &value))
+    {
+      if (verbose > 1)
+	printf ("Cannot evaluate the call at node %4.4lu\n", node->node_id);
+      ptrmap_put (&failed, node, node->node_id, node);
+      return;
+    }
+
+  if (verbose > 1)
+    printf ("Evaluating the call to %s at node %4.4lu: %ld\n",
+	    node->v.funcall.symbol->name, node->node_id, value);
+
+  /* The arguments are left to the sweep */
+  for (arg = node->v.funcall.args; arg; arg = next)
+    {
+      next = arg->next;
+      mm_free (MEM_ARGLIST, arg, sizeof (ARGLIST));
+    }
+  du_unlink (node);
+  node->v.funcall.args = NULL;
+  node->type = NODE_CONST;
+  node->v.number = value;
+  nfolded++;
+}
+
+static void
+fold_list (NODE *node)
+{
+  ARGLIST *arg;
+
+  for (; node; node = node->right)
+    switch (node->type) {
+    case NODE_CALL:
+      /* Its value is not used, see dce */
+      for (arg = node->v.funcall.args; arg; arg = arg->next)
+	fold_expr (arg->node);
+      break;
+    case NODE_ASGN:
+      fold_expr (node->v.asgn.expr);
+      break;
+    case NODE_VAR_DECL:
+      fold_expr (node->v.vardecl.expr);
+      break;
+    case NODE_EXPR:
+    case NODE_RETURN:
+    case NODE_PRINT:
+      fold_expr (node->v.expr);
+      break;
+    case NODE_COMPOUND:
+      fold_list (node->v.expr);
+      break;
+    case NODE_ITERATION:
+      fold_expr (node->v.iteration.cond);
+      fold_list (node->v.iteration.stmt);
+      break;
+    case NODE_CONDITION:
+      fold_expr (node->v.condition.cond);
+      fold_list (node->v.condition.iftrue_stmt);
+      fold_list (node->v.condition.iffalse_stmt);
+      break;
+    case NODE_FNC_DECL:
+      fold_list (node->v.fncdecl.stmt);
+      break;
+    default:
+      break;
+    }
+}
+
+/* Replace the calls to pure functions with constant arguments in the
+   program rooted at *ROOTP by their values.  Returns the number of
+   calls replaced. */
+size_t
+ceval_run (NODE **rootp)
+{
+  nfolded = 0;
+  fuel_used = 0;
+
+  ipa_analyze (*rootp);
+  fold_list (*rootp);
+  ipa_free ();
+  free (stack);
+  stack = NULL;
+  stack_size = 0;
+
+  if (verbose > 1)
+    printf ("Compile-time evaluation: %lu calls folded, %lu fuel used\n",
+	    (unsigned long) nfolded, fuel_used);
+  return nfolded;
+}
@@ -0,0 +1,27 @@
+/*
+   V5: ceval.h
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _CEVAL_H
+#define _CEVAL_H
+
+#include "tree.h"
+
+size_t ceval_run (NODE **);
+
+#endif /* not _CEVAL_H */
@@ -0,0 +1,632 @@
+/*
+   V5: cfg.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cfg.h"
+#include "mm.h"
+
+/*
+  Control-flow graphs.
+
+  cfg_build turns the top-level statement list and every function
+  body into a graph of basic blocks.  The first graph is the top-level
+  code, the following ones are the functions in the order of their
+  declarations.  Function declarations do not take part in the flow
+  of the code around them.
+
+  `break N' and `continue N' leave N enclosing loops (0 counts as 1);
+  a jump out of more loops than there are leaves the function, and
+  so does `return'.  Statements following a jump start a new block
+  without predecessors, which stays unreachable.
+
+  Every graph comes with its dominator tree (Cooper, Harvey and
+  Kennedy, "A Simple, Fast Dominance Algorithm") and its natural
+  loops.  The code of v5 is structured, so the graphs are reducible
+  and two loops are either nested or disjoint.
+*/
+
+struct loop_ctx
+{
+  struct cfg_block *header;
+  struct cfg_block *exit;
+};
+
+static struct cfg *graph;             /* graph being built */
+static struct cfg_block *cur;         /* block being filled */
+static struct loop_ctx *loops;        /* enclosing loops */
+static size_t nloops, loops_size;
+static struct cfg *first, **last;     /* graphs built so far */
+static NODE **pending;                /* function declarations to build */
+static size_t npending, pending_size;
+
+static struct cfg_block *
+new_block (void)
+{
+  struct cfg_block *b = calloc (1, sizeof (*b));
+
+  if (!b)
+    exit (EXIT_FAILURE);
+  if (graph->nblocks == graph->blocks_size)
+    {
+      graph->blocks_size = graph->blocks_size ? graph->blocks_size * 2 : 16;
+      graph->blocks = xrealloc (graph->blocks,
+				graph->blocks_size * sizeof (*graph->blocks));
+    }
+  b->index = graph->nblocks;
+  graph->blocks[graph->nblocks++] = b;
+  return b;
+}
+
+static void
+add_stmt (struct cfg_block *b, NODE *node)
+{
+  if (b->nstmts == b->stmts_size)
+    {
+      b->stmts_size = b->stmts_size ? b->stmts_size * 2 : 4;
+      b->stmts = xrealloc (b->stmts, b->stmts_size * sizeof (*b->stmts));
+    }
+  b->stmts[b->nstmts++] = node;
+  ptrmap_put (&graph->stmt_block, node, 0, b);
+}
+
+static void
+add_pred (struct cfg_block *b, struct cfg_block *pred)
+{
+  if (b->npreds == b->preds_size)
+    {
+      b->preds_size = b->preds_size ? b->preds_size * 2 : 2;
+      b->preds = xrealloc (b->preds, b->preds_size * sizeof (*b->preds));
+    }
+  b->preds[b->npreds++] = pred;
+}
+
+/* Leave the current block to TO, and continue in a fresh block */
+static void
+jump_to (struct cfg_block *to)
+{
+  cur->succ[0] = to;
+  cur = new_block ();
+}
+
+static void build_list (NODE *);
+
+static void
+build_stmt (NODE *node)
+{
+  struct cfg_block *b, *join;
+  unsigned level;
+
+  switch (node->type) {
+  case NODE_NOOP:
+    break;
+
+  case NODE_ASGN:
+  case NODE_VAR_DECL:
+  case NODE_PRINT:
+  case NODE_CALL:
+  case NODE_EXPR:
+    add_stmt (cur, node);
+    break;
+
+  case NODE_RETURN:
+    add_stmt (cur, node);
+    jump_to (graph->exit);
+    break;
+
+  case NODE_JUMP:
+    ptrmap_put (&graph->stmt_block, node, 0, cur);
+    level = node->v.jump.level ? node->v.jump.level : 1;
+    if (level > nloops)
+      jump_to (graph->exit);
+    else if (node->v.jump.type == JUMP_BREAK)
+      jump_to (loops[nloops - level].exit);
+    else
+      jump_to (loops[nloops - level].header);
+    break;
+
+  case NODE_COMPOUND:
+    build_list (node->v.expr);
+    break;
+
+  case NODE_CONDITION:
+    b = cur;
+    b->branch = node;
+    ptrmap_put (&graph->stmt_block, node, 0, b);
+    join = new_block ();
+    b->succ[0] = cur = new_block ();
+    build_list (node->v.condition.iftrue_stmt);
+    cur->succ[0] = join;
+    if (node->v.condition.iffalse_stmt)
+      {
+	b->succ[1] = cur = new_block ();
+	build_list (node->v.condition.iffalse_stmt);
+	cur->succ[0] = join;
+      }
+    else
+      b->succ[1] = join;
+    cur = join;
+    break;
+
+  case NODE_ITERATION:
+    b = new_block ();
+    cur->succ[0] = b;
+    b->branch = node;
+    ptrmap_put (&graph->stmt_block, node, 0, b);
+    join = new_block ();
+    b->succ[1] = join;
+    b->succ[0] = cur = new_block ();
+
+    if (nloops == loops_size)
+      {
+	loops_size = loops_size ? loops_size * 2 : 8;
+	loops = xrealloc (loops, loops_size * sizeof (*loops));
+      }
+    loops[nloops].header = b;
+    loops[nloops].exit = join;
+    nloops++;
+    build_list (node->v.iteration.stmt);
+    nloops--;
+
+    cur->succ[0] = b;
+    cur = join;
+    break;
+
+  case NODE_FNC_DECL:
+    if (npending == pending_size)
+      {
+	pending_size = pending_size ? pending_size * 2 : 8;
+	pending = xrealloc (pending, pending_size * sizeof (*pending));
+      }
+    pending[npending++] = node;
+    break;
+
+  default:
+    abort ();
+  }
+}
+
+static void
+build_list (NODE *node)
+{
+  for (; node; node = node->right)
+    build_stmt (node);
+}
+
+/* Number the reachable blocks in reverse postorder and collect
+   their predecessors; edges from unreachable blocks are dropped. */
+static void
+order_blocks (struct cfg *g)
+{
+  struct cfg_block **stack;
+  size_t *next_succ;
+  size_t i, sp = 0, n = 0;
+
+  stack = xrealloc (NULL, g->nblocks * sizeof (*stack));
+  next_succ = xrealloc (NULL, g->nblocks * sizeof (*next_succ));
+  g->rpo = xrealloc (NULL, g->nblocks * sizeof (*g->rpo));
+
+  g->entry->reachable = 1;
+  next_succ[g->entry->index] = 0;
+  stack[sp++] = g->entry;
+  while (sp)
+    {
+      struct cfg_block *b = stack[sp - 1];
+      if (next_succ[b->index] < 2)
+	{
+	  struct cfg_block *s = b->succ[next_succ[b->index]++];
+	  if (s && !s->reachable)
+	    {
+	      s->reachable = 1;
+	      next_succ[s->index] = 0;
+	      stack[sp++] = s;
+	    }
+	}
+      else
+	{
+	  /* postorder, filled from the end */
+	  g->rpo[g->nblocks - 1 - n++] = b;
+	  sp--;
+	}
+    }
+
+  /* move the reverse postorder to the front */
+  for (i = 0; i < n; i++)
+    {
+      g->rpo[i] = g->rpo[g->nblocks - n + i];
+      g->rpo[i]->rpo = i;
+    }
+  g->nrpo = n;
+
+  for (i = 0; i < n; i++)
+    {
+      struct cfg_block *b = g->rpo[i];
+      int k;
+      for (k = 0; k < 2; k++)
+	if (b->succ[k])
+	  {
+	    b->succ_pred[k] = b->succ[k]->npreds;
+	    add_pred (b->succ[k], b);
+	  }
+    }
+
+  free (stack);
+  free (next_succ);
+}
+
+
+/* Dominators */
+
+static void
+add_dom_child (struct cfg_block *b, struct cfg_block *child)
+{
+  if (b->ndom_children == b->dom_children_size)
+    {
+      b->dom_children_size = b->dom_children_size
+	? b->dom_children_size * 2 : 2;
+      b->dom_children = xrealloc (b->dom_children, b->dom_children_size
+				  * sizeof (*b->dom_children));
+    }
+  b->dom_children[b->ndom_children++] = child;
+}
+
+static struct cfg_block *
+intersect (struct cfg_block *a, struct cfg_block *b)
+{
+  while (a != b)
+    {
+      while (a->rpo > b->rpo)
+	a = a->idom;
+      while (b->rpo > a->rpo)
+	b = b->idom;
+    }
+  return a;
+}
+
+static void
+compute_dominators (struct cfg *g)
+{
+  struct cfg_block **stack;
+  size_t *next_child;
+  size_t i, j, sp = 0, pre = 0, post = 0;
+  int changed;
+
+  g->entry->idom = g->entry;
+  do {
+    changed = 0;
+    for (i = 1; i < g->nrpo; i++)
+      {
+	struct cfg_block *b = g->rpo[i];
+	struct cfg_block *idom = NULL;
+
+	for (j = 0; j < b->npreds; j++)
+	  if (b->preds[j]->idom)
+	    idom = idom ? intersect (b->preds[j], idom) : b->preds[j];
+	if (b->idom != idom)
+	  {
+	    b->idom = idom;
+	    changed = 1;
+	  }
+      }
+  } while (changed);
+  g->entry->idom = NULL;
+
+  for (i = 1; i < g->nrpo; i++)
+    add_dom_child (g->rpo[i]->idom, g->rpo[i]);
+
+  /* Number the tree, so that dominance is a range check */
+  stack = xrealloc (NULL, g->nrpo * sizeof (*stack));
+  next_child = xrealloc (NULL, g->nblocks * sizeof (*next_child));
+  stack[sp++] = g->entry;
+  next_child[g->entry->index] = 0;
+  g->entry->dom_pre = pre++;
+  while (sp)
+    {
+      struct cfg_block *b = stack[sp - 1];
+      if (next_child[b->index] < b->ndom_children)
+	{
+	  struct cfg_block *c = b->dom_children[next_child[b->index]++];
+	  c->dom_pre = pre++;
+	  next_child[c->index] = 0;
+	  stack[sp++] = c;
+	}
+      else
+	{
+	  b->dom_post = post++;
+	  sp--;
+	}
+    }
+  free (stack);
+  free (next_child);
+}
+
+/* Does A dominate B?  Both must be reachable. */
+int
+cfg_dominates (struct cfg_block *a, struct cfg_block *b)
+{
+  return a->dom_pre <= b->dom_pre && b->dom_post <= a->dom_post;
+}
+
+
+/* Natural loops */
+
+static int
+loop_cmp (const void *a, const void *b)
+{
+  const struct cfg_loop *x = *(const struct cfg_loop * const *) a;
+  const struct cfg_loop *y = *(const struct cfg_loop * const *) b;
+
+  if (x->nblocks != y->nblocks)
+    return x->nblocks > y->nblocks ? -1 : 1;
+  return x->header->rpo < y->header->rpo ? -1 : x->header->rpo > y->header->rpo;
+}
+
+static void
+add_loop_block (struct cfg_loop *l, struct cfg_block *b)
+{
+  if (l->nblocks == l->blocks_size)
+    {
+      l->blocks_size = l->blocks_size ? l->blocks_size * 2 : 8;
+      l->blocks = xrealloc (l->blocks, l->blocks_size * sizeof (*l->blocks));
+    }
+  l->blocks[l->nblocks++] = b;
+}
+
+static void
+find_loops (struct cfg *g)
+{
+  struct cfg_block **stack;
+  size_t *mark;
+  size_t i, j, k, sp;
+
+  stack = xrealloc (NULL, (g->nrpo + 1) * sizeof (*stack));
+  mark = calloc (g->nblocks ? g->nblocks : 1, sizeof (*mark));
+  if (!mark)
+    exit (EXIT_FAILURE);
+
+  for (i = 0; i < g->nrpo; i++)
+    {
+      struct cfg_block *h = g->rpo[i];
+      struct cfg_loop *l = NULL;
+
+      for (j = 0; j < h->npreds; j++)
+	{
+	  if (!cfg_dominates (h, h->preds[j]))
+	    continue;
+	  if (!l)
+	    {
+	      l = calloc (1, sizeof (*l));
+	      if (!l)
+		exit (EXIT_FAILURE);
+	      l->header = h;
+	      add_loop_block (l, h);
+	      mark[h->index] = i + 1;
+	      if (g->nloops == g->loops_size)
+		{
+		  g->loops_size = g->loops_size ? g->loops_size * 2 : 4;
+		  g->loops = xrealloc (g->loops,
+				       g->loops_size * sizeof (*g->loops));
+		}
+	      g->loops[g->nloops++] = l;
+	    }
+
+	  /* Walk back from the latch to the header */
+	  sp = 0;
+	  if (mark[h->preds[j]->index] != i + 1)
+	    {
+	      mark[h->preds[j]->index] = i + 1;
+	      stack[sp++] = h->preds[j];
+	    }
+	  while (sp)
+	    {
+	      struct cfg_block *b = stack[--sp];
+	      add_loop_block (l, b);
+	      for (k = 0; k < b->npreds; k++)
+		if (mark[b->preds[k]->index] != i + 1)
+		  {
+		    mark[b->preds[k]->index] = i + 1;
+		    stack[sp++] = b->preds[k];
+		  }
+	    }
+	}
+    }
+
+  /* Larger loops first; a loop is nested in the innermost of them
+     holding its header. */
+  if (g->nloops)
+    qsort (g->loops, g->nloops, sizeof (*g->loops), loop_cmp);
+  for (i = 0; i < g->nloops; i++)
+    {
+      struct cfg_loop *l = g->loops[i];
+      l->parent = l->header->loop;
+      l->depth = l->parent ? l->parent->depth + 1 : 1;
+      for (j = 0; j < l->nblocks; j++)
+	l->blocks[j]->loop = l;
+    }
+
+  free (stack);
+  free (mark);
+}
+
+/* Loop nesting depth of B, 0 outside of loops */
+unsigned
+cfg_loop_depth (struct cfg_block *b)
+{
+  return b->loop ? b->loop->depth : 0;
+}
+
+/* Is B inside the loop L? */
+int
+cfg_in_loop (struct cfg_loop *l, struct cfg_block *b)
+{
+  struct cfg_loop *p;
+
+  for (p = b->loop; p; p = p->parent)
+    if (p == l)
+      return 1;
+  return 0;
+}
+
+
+static struct cfg *
+build_graph (SYMBOL *function, NODE *body)
+{
+  struct cfg *g = calloc (1, sizeof (*g));
+
+  if (!g)
+    exit (EXIT_FAILURE);
+  g->function = function;
+  g->body = body;
+  ptrmap_init (&g->stmt_block);
+  graph = g;
+  g->entry = cur = new_block ();
+  g->exit = new_block ();
+  nloops = 0;
+  build_list (body);
+  cur->succ[0] = g->exit;
+  order_blocks (g);
+  compute_dominators (g);
+  find_loops (g);
+
+  *last = g;
+  last = &g->next;
+  return g;
+}
+
+/* Build the graphs of the program rooted at ROOT */
+struct cfg *
+cfg_build (NODE *root)
+{
+  size_t i;
+
+  first = NULL;
+  last = &first;
+  npending = 0;
+  build_graph (NULL, root);
+  for (i = 0; i < npending; i++)
+    build_graph (pending[i]->v.fncdecl.symbol, pending[i]->v.fncdecl.stmt);
+
+  free (pending);
+  free (loops);
+  pending = NULL;
+  loops = NULL;
+  pending_size = loops_size = 0;
+  graph = NULL;
+  cur = NULL;
+  return first;
+}
+
+void
+cfg_free (struct cfg *g)
+{
+  struct cfg *next;
+  size_t i;
+
+  for (; g; g = next)
+    {
+      next = g->next;
+      for (i = 0; i < g->nblocks; i++)
+	{
+	  free (g->blocks[i]->stmts);
+	  free (g->blocks[i]->preds);
+	  free (g->blocks[i]->dom_children);
+	  free (g->blocks[i]);
+	}
+      for (i = 0; i < g->nloops; i++)
+	{
+	  free (g->loops[i]->blocks);
+	  free (g->loops[i]);
+	}
+      free (g->blocks);
+      free (g->rpo);
+      free (g->loops);
+      ptrmap_free (&g->stmt_block);
+      free (g);
+    }
+}
+
+/* The graph of the function F, or of the top-level code if F is NULL */
+struct cfg *
+cfg_find (struct cfg *g, SYMBOL *f)
+{
+  for (; g; g = g->next)
+    if (g->function == f)
+      return g;
+  return NULL;
+}
+
+/* The block holding a simple statement, or ending in a branch or
+   a jump; NULL for statements not in the graph. */
+struct cfg_block *
+cfg_block_of (struct cfg *g, NODE *node)
+{
+  return ptrmap_get (&g->stmt_block, node, 0);
+}
+
+/* The condition (a NODE_EXPR) evaluated at the end of B, if any */
+NODE *
+cfg_branch_cond (struct cfg_block *b)
+{
+  if (!b->branch)
+    return NULL;
+  if (b->branch->type == NODE_ITERATION)
+    return b->branch->v.iteration.cond;
+  return b->branch->v.condition.cond;
+}
+
+void
+cfg_print (struct cfg *g)
+{
+  size_t i, j;
+
+  printf ("=== Control flow graph of %s ===\n\n",
+	  g->function ? g->function->name : "the top level");
+  for (i = 0; i < g->nrpo; i++)
+    {
+      struct cfg_block *b = g->rpo[i];
+
+      printf ("B%lu:", (unsigned long) b->index);
+      if (b == g->entry)
+	printf (" entry");
+      if (b == g->exit)
+	printf (" exit");
+      if (b->npreds)
+	{
+	  printf (" preds");
+	  for (j = 0; j < b->npreds; j++)
+	    printf (" B%lu", (unsigned long) b->preds[j]->index);
+	}
+      if (b->idom)
+	printf (" idom B%lu", (unsigned long) b->idom->index);
+      if (b->loop)
+	printf (" loop B%lu depth %u", (unsigned long) b->loop->header->index,
+		b->loop->depth);
+      printf ("\n");
+      for (j = 0; j < b->nstmts; j++)
+	printf ("\t node %4.4lu\n", b->stmts[j]->node_id);
+      if (b->branch)
+	printf ("\t branch %4.4lu ? B%lu : B%lu\n", b->branch->node_id,
+		(unsigned long) b->succ[0]->index,
+		(unsigned long) b->succ[1]->index);
+      else if (b->succ[0])
+	printf ("\t goto B%lu\n", (unsigned long) b->succ[0]->index);
+    }
+  printf ("\n");
+}
@@ -0,0 +1,90 @@
+/*
+   V5: cfg.h
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _CFG_H
+#define _CFG_H
+
+#include "tree.h"
+#include "ptrmap.h"
+
+/* A basic block holds the simple statements (assignments, variable
+   declarations, prints, calls, expressions and returns) executed in
+   sequence.  A block ending in a branch has the CONDITION or
+   ITERATION statement as `branch'; succ[0] is taken when its
+   condition is true and succ[1] when it is false. */
+
+struct cfg_block
+{
+  size_t index;                   /* position in cfg->blocks */
+  NODE **stmts;                   /* statements, in execution order */
+  size_t nstmts, stmts_size;
+  NODE *branch;                   /* statement owning the condition */
+  struct cfg_block *succ[2];      /* successors */
+  size_t succ_pred[2];            /* our index in succ[i]->preds */
+  struct cfg_block **preds;       /* reachable predecessors */
+  size_t npreds, preds_size;
+  int reachable;                  /* reachable from the entry */
+  size_t rpo;                     /* position in reverse postorder */
+
+  struct cfg_block *idom;         /* immediate dominator */
+  struct cfg_block **dom_children;/* blocks it immediately dominates */
+  size_t ndom_children, dom_children_size;
+  size_t dom_pre, dom_post;       /* dominator tree numbering */
+  struct cfg_loop *loop;          /* innermost loop, or NULL */
+};
+
+/* A natural loop: the header and every block that reaches one of
+   the back edges into it without passing through the header. */
+
+struct cfg_loop
+{
+  struct cfg_block *header;
+  struct cfg_loop *parent;        /* enclosing loop, or NULL */
+  struct cfg_block **blocks;      /* header first */
+  size_t nblocks, blocks_size;
+  unsigned depth;                 /* 1 for an outermost loop */
+};
+
+struct cfg
+{
+  SYMBOL *function;               /* NULL for the top-level code */
+  NODE *body;                     /* statement list */
+  struct cfg_block **blocks;      /* all blocks, in creation order */
+  size_t nblocks, blocks_size;
+  struct cfg_block *entry;
+  struct cfg_block *exit;
+  struct cfg_block **rpo;         /* reachable blocks in reverse postorder */
+  size_t nrpo;
+  struct cfg_loop **loops;        /* natural loops, outer ones first */
+  size_t nloops, loops_size;
+  struct ptrmap stmt_block;       /* statement -> block */
+  struct cfg *next;               /* next function */
+};
+
+struct cfg *cfg_build (NODE *);
+void cfg_free (struct cfg *);
+struct cfg *cfg_find (struct cfg *, SYMBOL *);
+NODE *cfg_branch_cond (struct cfg_block *);
+struct cfg_block *cfg_block_of (struct cfg *, NODE *);
+int cfg_dominates (struct cfg_block *, struct cfg_block *);
+unsigned cfg_loop_depth (struct cfg_block *);
+int cfg_in_loop (struct cfg_loop *, struct cfg_block *);
+void cfg_print (struct cfg *);
+
+#endif /* not _CFG_H */
@@ -0,0 +1,524 @@
+/*
+   V5: dse.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "cfg.h"
+#include "ipa.h"
+#include "ptrmap.h"
+#include "motion.h"
+#include "optimize.h"
+#include "dse.h"
+
+extern int verbose;
+
+/*
+  Dead-store elimination.
+
+  A variable is live at a point of a function when some path from
+  there reads it before writing it.  The live variables are found
+  backwards over the control-flow graph, block by block until
+  nothing changes.  An assignment or an initializer whose variable
+  is not live after it stores a value nobody reads.
+
+  A variable declared in a block is written by its declaration each
+  time the block is entered, so it is dead once the block is left.
+  The variables that other functions read, the globals, are live at
+  the exit of a function, and a call reads them unless the function
+  is pure.  A variable referred to by more than one function is
+  treated as a global, whatever its qualifier.
+
+  A dead assignment goes away with its value, and a dead initializer
+  leaves a declaration of 0.  A value that may fail or have side
+  effects, a division by a variable or a call to a function that is
+  not total, is still computed by an expression statement.  Removing
+  a store makes the values its expression read dead in turn, so the
+  function is done again until nothing is removed.
+*/
+
+#define BITS (CHAR_BIT * sizeof (unsigned long))
+
+static struct cfg *graph;
+static struct ptrmap index_of;     /* variable -> its index + 1 */
+static SYMBOL **vars;              /* variables by index */
+static size_t nvars, vars_size, words;
+static struct ptrmap owner;        /* variable -> graph reading it */
+static struct ptrmap shared;       /* variables of several graphs */
+static unsigned long *exposed;     /* variables that calls read */
+static unsigned long *use, *def, *live_in, *live_out;
+static size_t nasgns, ninits, nkept;
+
+static void *
+xcalloc (size_t n, size_t size)
+{
+  void *p = calloc (n ? n : 1, size);
+  if (!p)
+    exit (EXIT_FAILURE);
+  return p;
+}
+
+static int
+bit (unsigned long *v, size_t i)
+{
+  return (v[i / BITS] >> (i % BITS)) & 1;
+}
+
+static void
+set_bit (unsigned long *v, size_t i)
+{
+  v[i / BITS] |= 1UL << (i % BITS);
+}
+
+static void
+clear_bit (unsigned long *v, size_t i)
+{
+  v[i / BITS] &= ~(1UL << (i % BITS));
+}
+
+/* The index of the variable S + 1, or 0 if the graph does not
+   refer to it */
+static size_t
+var_index (SYMBOL *s)
+{
+  return (size_t) ptrmap_get (&index_of, s, 0);
+}
+
+
+/* Numbering the variables */
+
+static void
+number_var (SYMBOL *s)
+{
+  struct cfg *g;
+
+  if (!s || var_index (s))
+    return;
+  if (nvars == vars_size)
+    {
+      vars_size = vars_size ? vars_size * 2 : 16;
+      vars = xrealloc (vars, vars_size * sizeof (*vars));
+    }
+  vars[nvars++] = s;
+  ptrmap_put (&index_of, s, 0, (void *) nvars);
+  g = ptrmap_get (&owner, s, 0);
+  if (!g)
+    ptrmap_put (&owner, s, 0, graph);
+  else if (g != graph)
+    ptrmap_put (&shared, s, 0, s);
+}
+
+static void
+number_node (NODE *node)
+{
+  number_var (node->v.symbol);
+}
+
+traverse_fp dse_number_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  number_node, /* NODE_VAR */
+  NULL,        /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+/* The variable a statement writes, or NULL */
+static SYMBOL *
+stmt_def (NODE *node)
+{
+  if (node->type == NODE_ASGN)
+    return node->v.asgn.symbol;
+  if (node->type == NODE_VAR_DECL)
+    return node->v.vardecl.symbol;
+  return NULL;
+}
+
+/* The NODE_EXPR holding the expression evaluated by a statement */
+static NODE *
+stmt_expr (NODE *node)
+{
+  switch (node->type) {
+  case NODE_ASGN:
+    return node->v.asgn.expr;
+  case NODE_VAR_DECL:
+    return node->v.vardecl.expr;
+  case NODE_RETURN:
+  case NODE_PRINT:
+    return node->v.expr;
+  case NODE_EXPR:
+    return node;
+  default:
+    return NULL;
+  }
+}
+
+/* Apply FPTAB to the expression EXPR of the statement STMT, or to
+   the call STMT is */
+static void
+stmt_traverse (NODE *stmt, NODE *expr, traverse_fp *fptab)
+{
+  ARGLIST *arg;
+
+  if (expr)
+    traverse_expr (expr->v.expr, fptab);
+  else if (stmt && stmt->type == NODE_CALL)
+    {
+      for (arg = stmt->v.funcall.args; arg; arg = arg->next)
+	traverse_expr (arg->node, fptab);
+      if (fptab[NODE_CALL])
+	fptab[NODE_CALL] (stmt);
+    }
+}
+
+/* Number the variables of GRAPH */
+static void
+number_graph (void)
+{
+  size_t i, j;
+
+  ptrmap_free (&index_of);
+  nvars = 0;
+  for (i = 0; i < graph->nrpo; i++)
+    {
+      struct cfg_block *b = graph->rpo[i];
+      for (j = 0; j < b->nstmts; j++)
+	{
+	  number_var (stmt_def (b->stmts[j]));
+	  stmt_traverse (b->stmts[j], stmt_expr (b->stmts[j]),
+			 dse_number_fptab);
+	}
+      stmt_traverse (NULL, cfg_branch_cond (b), dse_number_fptab);
+    }
+}
+
+
+/* Reads */
+
+static unsigned long *set;         /* variables read */
+static unsigned long *kill;        /* but written before, or NULL */
+static int reads_globals;
+
+static void
+read_var (NODE *node)
+{
+  size_t i = var_index (node->v.symbol);
+
+  if (i && !(kill && bit (kill, i - 1)))
+    set_bit (set, i - 1);
+}
+
+static void
+read_call (NODE *node)
+{
+  if (!node->v.funcall.symbol->v.fnc->pure)
+    reads_globals = 1;
+}
+
+traverse_fp dse_read_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  read_var,    /* NODE_VAR */
+  read_call,   /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+/* Add the variables the statement STMT, or the expression EXPR of
+   it, reads to V, unless K has them */
+static void
+add_reads (unsigned long *v, unsigned long *k, NODE *stmt, NODE *expr)
+{
+  size_t w;
+
+  set = v;
+  kill = k;
+  reads_globals = 0;
+  stmt_traverse (stmt, expr, dse_read_fptab);
+  if (reads_globals)
+    for (w = 0; w < words; w++)
+      v[w] |= exposed[w] & ~(k ? k[w] : 0);
+}
+
+
+/* Liveness */
+
+static void
+block_sets (struct cfg_block *b)
+{
+  unsigned long *u = use + b->index * words;
+  unsigned long *d = def + b->index * words;
+  size_t j;
+  SYMBOL *s;
+
+  for (j = 0; j < b->nstmts; j++)
+    {
+      add_reads (u, d, b->stmts[j], stmt_expr (b->stmts[j]));
+      if ((s = stmt_def (b->stmts[j])))
+	set_bit (d, var_index (s) - 1);
+    }
+  add_reads (u, d, NULL, cfg_branch_cond (b));
+  if (b == graph->exit)
+    for (j = 0; j < words; j++)
+      u[j] |= exposed[j];
+}
+
+static void
+solve (void)
+{
+  size_t i, w, k;
+  int changed;
+
+  do {
+    changed = 0;
+    for (i = graph->nrpo; i-- > 0; )
+      {
+	struct cfg_block *b = graph->rpo[i];
+	unsigned long *out = live_out + b->index * words;
+	unsigned long *in = live_in + b->index * words;
+	unsigned long *u = use + b->index * words;
+	unsigned long *d = def + b->index * words;
+
+	for (k = 0; k < 2; k++)
+	  if (b->succ[k])
+	    {
+	      unsigned long *sin = live_in + b->succ[k]->index * words;
+	      for (w = 0; w < words; w++)
+		out[w] |= sin[w];
+	    }
+	for (w = 0; w < words; w++)
+	  {
+	    unsigned long x = u[w] | (out[w] & ~d[w]);
+	    if (x != in[w])
+	      {
+		in[w] = x;
+		changed = 1;
+	      }
+	  }
+      }
+  } while (changed);
+}
+
+
+/* Removal */
+
+/* Put the statement NODE in front of the J-th statement of B */
+static void
+insert_stmt (struct cfg_block *b, size_t j, NODE *node)
+{
+  if (b->nstmts == b->stmts_size)
+    {
+      b->stmts_size = b->stmts_size ? b->stmts_size * 2 : 4;
+      b->stmts = xrealloc (b->stmts, b->stmts_size * sizeof (*b->stmts));
+    }
+  memmove (b->stmts + j + 1, b->stmts + j,
+	   (b->nstmts - j) * sizeof (*b->stmts));
+  b->stmts[j] = node;
+  b->nstmts++;
+}
+
+/* Remove the dead store of the J-th statement of B.  Returns the
+   expression still computed, or NULL. */
+static NODE *
+remove_store (struct cfg_block *b, size_t j)
+{
+  NODE *node = b->stmts[j];
+  NODE *expr = stmt_expr (node);
+
+  if (verbose > 1)
+    printf ("Removing dead %s of %s (node %4.4lu)\n",
+	    node->type == NODE_ASGN ? "assignment" : "initializer",
+	    stmt_def (node)->name, node->node_id);
+  if (node->type == NODE_ASGN)
+    nasgns++;
+  else
+    ninits++;
+
+  if (!ipa_may_fail (expr))
+    {
+      traverse_expr (expr, unlink_fptab);
+      if (node->type == NODE_ASGN)
+	{
+	  du_unlink (node);
+	  node->type = NODE_NOOP;
+	}
+      else
+	node->v.vardecl.expr = NULL;
+      return NULL;
+    }
+
+  nkept++;
+  if (node->type == NODE_ASGN)
+    {
+      /* The assignment becomes an expression statement */
+      du_unlink (node);
+      node->type = NODE_EXPR;
+      node->v.expr = expr->v.expr;
+      return node;
+    }
+  /* The initializer becomes an expression statement before it */
+  node->v.vardecl.expr = NULL;
+  expr->left = expr->right = NULL;
+  motion_insert_before (node, expr);
+  insert_stmt (b, j, expr);
+  return expr;
+}
+
+/* Remove the dead stores of the block B.  Returns the number of
+   stores removed. */
+static size_t
+sweep_block (struct cfg_block *b)
+{
+  unsigned long *cur = xcalloc (words, sizeof (*cur));
+  size_t j, n = 0, i;
+  NODE *node, *expr;
+  SYMBOL *s;
+
+  memcpy (cur, live_out + b->index * words, words * sizeof (*cur));
+  add_reads (cur, NULL, NULL, cfg_branch_cond (b));
+  for (j = b->nstmts; j-- > 0; )
+    {
+      node = b->stmts[j];
+      expr = stmt_expr (node);
+      if ((s = stmt_def (node)))
+	{
+	  i = var_index (s) - 1;
+	  if (!bit (cur, i) && expr)
+	    {
+	      expr = remove_store (b, j);
+	      n++;
+	    }
+	  clear_bit (cur, i);
+	}
+      add_reads (cur, NULL, node, expr);
+    }
+  free (cur);
+  return n;
+}
+
+/* Remove the dead stores of GRAPH until none is left */
+static void
+dse_graph (void)
+{
+  size_t i, n;
+
+  do {
+    number_graph ();
+    words = (nvars + BITS - 1) / BITS;
+    exposed = xcalloc (words, sizeof (*exposed));
+    use = xcalloc (graph->nblocks * words, sizeof (*use));
+    def = xcalloc (graph->nblocks * words, sizeof (*def));
+    live_in = xcalloc (graph->nblocks * words, sizeof (*live_in));
+    live_out = xcalloc (graph->nblocks * words, sizeof (*live_out));
+    n = 0;
+    if (nvars)
+      {
+	for (i = 0; i < nvars; i++)
+	  if (vars[i]->v.var->qualifier == QUA_GLOBAL
+	      || ptrmap_get (&shared, vars[i], 0))
+	    set_bit (exposed, i);
+	for (i = 0; i < graph->nrpo; i++)
+	  block_sets (graph->rpo[i]);
+	solve ();
+	for (i = 0; i < graph->nrpo; i++)
+	  n += sweep_block (graph->rpo[i]);
+      }
+    free (exposed);
+    free (use);
+    free (def);
+    free (live_in);
+    free (live_out);
+  } while (n);
+}
+
+/* Remove the dead stores of the program rooted at *ROOTP.  Returns
+   the number of stores removed. */
+size_t
+dse_run (NODE **rootp)
+{
+  struct cfg *graphs;
+  size_t i, j;
+
+  nasgns = ninits = nkept = 0;
+  ipa_analyze (*rootp);
+  motion_begin (rootp);
+  graphs = cfg_build (*rootp);
+
+  /* The variables more than one function refers to, in the code
+     that cannot be reached too */
+  for (graph = graphs; graph; graph = graph->next)
+    {
+      for (i = 0; i < graph->nblocks; i++)
+	{
+	  struct cfg_block *b = graph->blocks[i];
+	  for (j = 0; j < b->nstmts; j++)
+	    {
+	      number_var (stmt_def (b->stmts[j]));
+	      stmt_traverse (b->stmts[j], stmt_expr (b->stmts[j]),
+			     dse_number_fptab);
+	    }
+	  stmt_traverse (NULL, cfg_branch_cond (b), dse_number_fptab);
+	}
+      ptrmap_free (&index_of);
+      nvars = 0;
+    }
+
+  for (graph = graphs; graph; graph = graph->next)
+    dse_graph ();
+
+  cfg_free (graphs);
+  motion_end ();
+  ipa_free ();
+  ptrmap_free (&index_of);
+  ptrmap_free (&owner);
+  ptrmap_free (&shared);
+  free (vars);
+  vars = NULL;
+  nvars = vars_size = 0;
+
+  if (verbose > 1)
+    printf ("Dead stores: %lu assignments, %lu initializers removed, "
+	    "%lu values kept\n", (unsigned long) nasgns,
+	    (unsigned long) ninits, (unsigned long) nkept);
+  return nasgns + ninits;
+}
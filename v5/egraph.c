@@ -0,0 +1,796 @@
+/*
+   V5: egraph.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "rewrite.h"
+#include "egraph.h"
+
+extern int verbose;
+
+/*
+  Equality saturation.
+
+  An e-graph holds many equal forms of an expression at once.  Its
+  classes are sets of nodes computing the same value, and the
+  operands of a node are classes, not nodes, so a class stands for
+  every way of computing its value.  A rule applied to the graph adds
+  its result to the class it matched, and the matched form stays, so
+  it does not matter in which order the rules are applied: a rule
+  making the expression bigger may open the way to others making it
+  much smaller, as x * 2 - x becoming x * 2 + x * -1, then x * (2 +
+  -1), then x.  The rules, see egraph.rules, are applied until none
+  adds anything, or a limit on the nodes, the rounds or the matches of
+  a round is reached, and the cheapest expression of the class of the
+  root is taken out by a cost model.  The graphs of a run share a
+  budget of nodes, and the expressions coming after it is spent stay
+  as they are.  -fegraph-time=MSEC adds a limit on the time spent on
+  an expression, which makes the output depend on the machine.
+
+  Only pure expressions are worked on, see rewrite_pure, so that the
+  operands may be dropped, duplicated and computed in any order.  The
+  calls and the divisions that may fail stay as they are, and the
+  pure expressions under them are worked on separately.  The rules
+  hold for arithmetic wrapping around, so (x * 2) / 2 is not x, and
+  none of them divides.  A class knows the constant it equals, if
+  any, which folds the constants without rules for it.
+*/
+
+#define EGRAPH_NODES 10000         /* nodes in the graph of an expression */
+#define EGRAPH_GROWTH 128          /* ... for a node of the expression */
+#define EGRAPH_BUDGET 1000000      /* ... of all the expressions of a run */
+#define EGRAPH_ROUNDS 30           /* rounds of rule application */
+#define EGRAPH_MATCHES 50000       /* matches applied in a round */
+#define EGRAPH_TODO 16             /* patterns left to match */
+
+struct enode
+{
+  int op;                       /* RW_KEY of the node */
+  long number;                  /* op == RW_TYPE (NODE_CONST) */
+  SYMBOL *symbol;               /* op == RW_TYPE (NODE_VAR) */
+  int kid[2];                   /* classes of the operands */
+  int cls;
+  int dead;                     /* the same as another node */
+  int next;                     /* next node of the class */
+};
+
+struct eclass
+{
+  int parent;                   /* union-find */
+  int constant;                 /* the class equals VALUE */
+  long value;
+  int head;                     /* first node */
+  long cost;                    /* of the cheapest node */
+  int best;
+};
+
+struct ematch
+{
+  int rule;
+  int cls;
+  int env[EGRAPH_VARS];
+};
+
+struct todo
+{
+  const struct egraph_pat *pat;
+  int cls;
+};
+
+egraph_cost_fp egraph_cost = egraph_cost_speed;
+long egraph_msec;
+
+static struct enode *nodes;
+static int nnodes, nodes_size;
+static int max_nodes;
+static long budget;                /* nodes left for the run */
+static struct eclass *classes;
+static int nclasses, classes_size;
+static int *table;                 /* hash of the nodes */
+static unsigned table_size;
+static struct ematch *matches;
+static int nmatches, matches_size;
+static int changed;                /* unions and nodes added */
+static clock_t started;
+
+static size_t nimproved, ntimeouts;
+
+/* Cost models */
+
+static int
+arity (int op)
+{
+  if (op >> 5 == NODE_BINOP)
+    return 2;
+  if (op >> 5 == NODE_UNOP)
+    return 1;
+  return 0;
+}
+
+/* Nodes of the tree */
+long
+egraph_cost_size (int op, long left, long right)
+{
+  return 1 + left + right;
+}
+
+/* Nodes evaluated, the multiplications and divisions weighing more,
+   like the interpreter counts them */
+long
+egraph_cost_speed (int op, long left, long right)
+{
+  switch (op) {
+  case RW_OP (NODE_BINOP, OPCODE_MUL):
+  case RW_OP (NODE_BINOP, OPCODE_DIV):
+  case RW_OP (NODE_BINOP, OPCODE_MOD):
+    return 4 + left + right;
+  default:
+    return 1 + left + right;
+  }
+}
+
+static long
+tree_cost (NODE *node)
+{
+  switch (node->type) {
+  case NODE_UNOP:
+    return egraph_cost (RW_KEY (node), tree_cost (node->left), 0);
+  case NODE_BINOP:
+    return egraph_cost (RW_KEY (node), tree_cost (node->left),
+			tree_cost (node->right));
+  default:
+    return egraph_cost (RW_KEY (node), 0, 0);
+  }
+}
+
+/* The graph */
+
+static int
+find (int c)
+{
+  while (classes[c].parent != c)
+    {
+      classes[c].parent = classes[classes[c].parent].parent;
+      c = classes[c].parent;
+    }
+  return c;
+}
+
+static unsigned long
+hash_node (struct enode *e)
+{
+  unsigned long h = e->op;
+
+  h = h * 31 + (unsigned long) e->number;
+  h = h * 31 + (unsigned long) e->symbol / sizeof (void *);
+  h = h * 31 + e->kid[0];
+  h = h * 31 + e->kid[1];
+  return h ^ (h >> 15);
+}
+
+static int
+same_node (struct enode *a, struct enode *b)
+{
+  return a->op == b->op && a->number == b->number
+    && a->symbol == b->symbol
+    && a->kid[0] == b->kid[0] && a->kid[1] == b->kid[1];
+}
+
+static void
+canon (struct enode *e)
+{
+  int i;
+
+  for (i = 0; i < arity (e->op); i++)
+    e->kid[i] = find (e->kid[i]);
+}
+
+/* The node of the table equal to E, or the slot for it */
+static unsigned
+lookup (struct enode *e)
+{
+  unsigned i = hash_node (e) & (table_size - 1);
+
+  while (table[i] >= 0 && !same_node (&nodes[table[i]], e))
+    i = (i + 1) & (table_size - 1);
+  return i;
+}
+
+static void
+rehash (void)
+{
+  int i;
+
+  while (table_size < 2 * (unsigned) nnodes + 2)
+    table_size = table_size ? table_size * 2 : 1024;
+  table = xrealloc (table, table_size * sizeof (*table));
+  memset (table, -1, table_size * sizeof (*table));
+  for (i = 0; i < nnodes; i++)
+    if (!nodes[i].dead)
+      {
+	canon (&nodes[i]);
+	table[lookup (&nodes[i])] = i;
+      }
+}
+
+static int
+union_classes (int a, int b)
+{
+  int t;
+
+  a = find (a);
+  b = find (b);
+  if (a == b)
+    return 0;
+  if (b < a)
+    {
+      t = a;
+      a = b;
+      b = t;
+    }
+  classes[b].parent = a;
+  if (!classes[a].constant && classes[b].constant)
+    {
+      classes[a].constant = 1;
+      classes[a].value = classes[b].value;
+    }
+  changed++;
+  return 1;
+}
+
+static int add_node (struct enode *);
+
+static int
+add_const (long value)
+{
+  struct enode e;
+
+  memset (&e, 0, sizeof (e));
+  e.op = RW_TYPE (NODE_CONST);
+  e.number = value;
+  return add_node (&e);
+}
+
+/* The constant a node computes from constant operands, computed like
+   the machine would.  Returns zero if it is not known. */
+static int
+fold (struct enode *e, long *value)
+{
+  unsigned long l = 0, r = 0;
+  int i, n = arity (e->op);
+
+  if (n == 0)
+    return 0;
+  for (i = 0; i < n; i++)
+    if (!classes[find (e->kid[i])].constant)
+      return 0;
+  l = classes[find (e->kid[0])].value;
+  if (n == 2)
+    r = classes[find (e->kid[1])].value;
+
+  switch (e->op) {
+  case RW_OP (NODE_UNOP, OPCODE_NEG):
+    *value = -l;
+    break;
+  case RW_OP (NODE_UNOP, OPCODE_NOT):
+    *value = !l;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_ADD):
+    *value = l + r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_SUB):
+    *value = l - r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_MUL):
+    *value = l * r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_DIV):
+    if (r == 0)
+      return 0;
+    *value = (long) r == -1 ? -l : (unsigned long) ((long) l / (long) r);
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_MOD):
+    if (r == 0)
+      return 0;
+    *value = (long) r == -1 ? 0 : (long) l % (long) r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_AND):
+    *value = l && r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_OR):
+    *value = l || r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_EQ):
+    *value = l == r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_NE):
+    *value = l != r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_LT):
+    *value = (long) l < (long) r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_GT):
+    *value = (long) l > (long) r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_LE):
+    *value = (long) l <= (long) r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_GE):
+    *value = (long) l >= (long) r;
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_SHL):
+    *value = l << (r & 63);
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_SHR):
+    *value = (long) l >> (r & 63);
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_BAND):
+    *value = l & r;
+    break;
+  default:
+    return 0;
+  }
+  return 1;
+}
+
+/* Add the node E, unless the graph has it; returns its class */
+static int
+add_node (struct enode *e)
+{
+  unsigned slot;
+  long value;
+  int c;
+
+  canon (e);
+  slot = lookup (e);
+  if (table[slot] >= 0)
+    return find (nodes[table[slot]].cls);
+
+  if (nclasses == classes_size)
+    {
+      classes_size = classes_size ? classes_size * 2 : 256;
+      classes = xrealloc (classes, classes_size * sizeof (*classes));
+    }
+  c = nclasses++;
+  memset (&classes[c], 0, sizeof (classes[c]));
+  classes[c].parent = c;
+  classes[c].head = -1;
+
+  if (nnodes == nodes_size)
+    {
+      nodes_size = nodes_size ? nodes_size * 2 : 256;
+      nodes = xrealloc (nodes, nodes_size * sizeof (*nodes));
+    }
+  e->cls = c;
+  e->dead = 0;
+  e->next = -1;
+  nodes[nnodes] = *e;
+  table[slot] = nnodes++;
+  changed++;
+  if (2 * (unsigned) nnodes + 2 > table_size)
+    rehash ();
+
+  if (e->op == RW_TYPE (NODE_CONST))
+    {
+      classes[c].constant = 1;
+      classes[c].value = e->number;
+    }
+  else if (fold (e, &value))
+    union_classes (c, add_const (value));
+  return find (c);
+}
+
+/* Restore the invariants after unions: the nodes made equal by them
+   are merged, which may make more classes equal, and the classes get
+   the constants their nodes compute */
+static void
+rebuild (void)
+{
+  int i, again;
+  long value;
+
+  do {
+    again = 0;
+    memset (table, -1, table_size * sizeof (*table));
+    for (i = 0; i < nnodes; i++)
+      {
+	unsigned slot;
+
+	if (nodes[i].dead)
+	  continue;
+	canon (&nodes[i]);
+	slot = lookup (&nodes[i]);
+	if (table[slot] < 0)
+	  table[slot] = i;
+	else
+	  {
+	    again |= union_classes (nodes[table[slot]].cls, nodes[i].cls);
+	    nodes[i].dead = 1;
+	  }
+      }
+    for (i = 0; i < nnodes; i++)
+      if (!nodes[i].dead && !classes[find (nodes[i].cls)].constant
+	  && fold (&nodes[i], &value))
+	{
+	  union_classes (nodes[i].cls, add_const (value));
+	  again = 1;
+	}
+  } while (again);
+
+  for (i = 0; i < nclasses; i++)
+    classes[i].head = -1;
+  for (i = 0; i < nnodes; i++)
+    if (!nodes[i].dead)
+      {
+	int c = find (nodes[i].cls);
+	nodes[i].next = classes[c].head;
+	classes[c].head = i;
+      }
+}
+
+/* The time limit is off by default: the output would depend on the
+   load of the machine */
+static int
+out_of_time (void)
+{
+  if (egraph_msec <= 0
+      || (clock () - started) * 1000 / CLOCKS_PER_SEC <= egraph_msec)
+    return 0;
+  ntimeouts++;
+  return 1;
+}
+
+/* Find the matches of the patterns TODO in the classes they go with;
+   ENV holds the classes of the variables bound so far */
+static void
+ematch (int rule, int root, struct todo *todo, int ntodo, int *env)
+{
+  struct todo sub[EGRAPH_TODO];
+  const struct egraph_pat *pat;
+  int c, e, i, n;
+
+  if (nmatches >= EGRAPH_MATCHES)
+    return;
+  if (ntodo == 0)
+    {
+      if (nmatches == matches_size)
+	{
+	  matches_size = matches_size ? matches_size * 2 : 256;
+	  matches = xrealloc (matches, matches_size * sizeof (*matches));
+	}
+      matches[nmatches].rule = rule;
+      matches[nmatches].cls = root;
+      memcpy (matches[nmatches].env, env, sizeof (matches[0].env));
+      nmatches++;
+      return;
+    }
+
+  pat = todo[ntodo - 1].pat;
+  c = find (todo[ntodo - 1].cls);
+  if (pat->op < 0)
+    {
+      if (env[pat->var] >= 0)
+	{
+	  if (find (env[pat->var]) == c)
+	    ematch (rule, root, todo, ntodo - 1, env);
+	}
+      else
+	{
+	  env[pat->var] = c;
+	  ematch (rule, root, todo, ntodo - 1, env);
+	  env[pat->var] = -1;
+	}
+      return;
+    }
+  if (pat->op == RW_TYPE (NODE_CONST))
+    {
+      if (classes[c].constant && classes[c].value == pat->number)
+	ematch (rule, root, todo, ntodo - 1, env);
+      return;
+    }
+  for (e = classes[c].head; e >= 0; e = nodes[e].next)
+    {
+      if (nodes[e].op != pat->op)
+	continue;
+      n = ntodo - 1;
+      memcpy (sub, todo, n * sizeof (*sub));
+      for (i = 0; i < arity (pat->op); i++)
+	{
+	  sub[n].pat = pat->kid[i];
+	  sub[n++].cls = nodes[e].kid[i];
+	}
+      ematch (rule, root, sub, n, env);
+    }
+}
+
+static int
+instantiate (const struct egraph_pat *pat, int *env)
+{
+  struct enode e;
+  int i;
+
+  if (pat->op < 0)
+    return env[pat->var];
+  if (pat->op == RW_TYPE (NODE_CONST))
+    return add_const (pat->number);
+  memset (&e, 0, sizeof (e));
+  e.op = pat->op;
+  for (i = 0; i < arity (pat->op); i++)
+    e.kid[i] = instantiate (pat->kid[i], env);
+  return add_node (&e);
+}
+
+/* Apply the rules until nothing changes or a limit is reached.
+   Returns the number of rounds. */
+static int
+saturate (void)
+{
+  struct todo todo;
+  int env[EGRAPH_VARS];
+  int round, r, c, i;
+
+  for (round = 1; round <= EGRAPH_ROUNDS; round++)
+    {
+      nmatches = 0;
+      for (r = 0; r < egraph_nrules; r++)
+	for (c = 0; c < nclasses; c++)
+	  if (find (c) == c)
+	    {
+	      todo.pat = egraph_rules[r].lhs;
+	      todo.cls = c;
+	      for (i = 0; i < EGRAPH_VARS; i++)
+		env[i] = -1;
+	      ematch (r, c, &todo, 1, env);
+	    }
+
+      changed = 0;
+      for (i = 0; i < nmatches && nnodes < max_nodes; i++)
+	union_classes (matches[i].cls,
+		       instantiate (egraph_rules[matches[i].rule].rhs,
+				    matches[i].env));
+      rebuild ();
+      if (!changed || nnodes >= max_nodes || out_of_time ())
+	break;
+    }
+  return round;
+}
+
+/* The cheapest node of every class.  The costs are positive, so the
+   operands of the cheapest node are cheaper than it, and following
+   them never loops. */
+static void
+costs (void)
+{
+  int i, again;
+  long k, l, r;
+
+  for (i = 0; i < nclasses; i++)
+    {
+      classes[i].cost = LONG_MAX;
+      classes[i].best = -1;
+    }
+  do {
+    again = 0;
+    for (i = 0; i < nnodes; i++)
+      {
+	struct enode *e = &nodes[i];
+	int c = find (e->cls);
+
+	if (e->dead)
+	  continue;
+	l = r = 0;
+	if (arity (e->op) > 0
+	    && (l = classes[find (e->kid[0])].cost) == LONG_MAX)
+	  continue;
+	if (arity (e->op) > 1
+	    && (r = classes[find (e->kid[1])].cost) == LONG_MAX)
+	  continue;
+	k = egraph_cost (e->op, l, r);
+	if (k < classes[c].cost)
+	  {
+	    classes[c].cost = k;
+	    classes[c].best = i;
+	    again = 1;
+	  }
+      }
+  } while (again);
+}
+
+static NODE *
+extract (int c, unsigned long order)
+{
+  struct enode *e = &nodes[classes[find (c)].best];
+  NODE *node = addnode ((enum node_type) (e->op >> 5));
+
+  node->order = order;
+  switch (node->type) {
+  case NODE_CONST:
+    node->v.number = e->number;
+    break;
+  case NODE_VAR:
+    node->v.symbol = e->symbol;
+    du_link (node, e->symbol);
+    break;
+  case NODE_UNOP:
+  case NODE_BINOP:
+    node->v.opcode = (enum opcode_type) (e->op & 31);
+    node->left = extract (e->kid[0], order);
+    if (node->type == NODE_BINOP)
+      node->right = extract (e->kid[1], order);
+    break;
+  default:
+    abort ();
+  }
+  return node;
+}
+
+static int
+add_tree (NODE *node)
+{
+  struct enode e;
+
+  memset (&e, 0, sizeof (e));
+  e.op = RW_KEY (node);
+  switch (node->type) {
+  case NODE_CONST:
+    e.number = node->v.number;
+    break;
+  case NODE_VAR:
+    e.symbol = node->v.symbol;
+    break;
+  case NODE_UNOP:
+    e.kid[0] = add_tree (node->left);
+    break;
+  case NODE_BINOP:
+    e.kid[0] = add_tree (node->left);
+    e.kid[1] = add_tree (node->right);
+    break;
+  default:
+    abort ();
+  }
+  return add_node (&e);
+}
+
+/* Replace the pure expression NODE by the cheapest one equal to it */
+static void
+optimize (NODE *node)
+{
+  NODE *by;
+  long before;
+  int c, i, rounds, live;
+
+  if (egraph_msec > 0)
+    started = clock ();
+  nnodes = nclasses = 0;
+  rehash ();
+  c = add_tree (node);
+  max_nodes = nnodes * EGRAPH_GROWTH;
+  if (max_nodes > EGRAPH_NODES)
+    max_nodes = EGRAPH_NODES;
+  if (max_nodes > budget)
+    max_nodes = budget;
+  rebuild ();
+  rounds = saturate ();
+  budget -= nnodes;
+  costs ();
+
+  before = tree_cost (node);
+  c = find (c);
+  if (verbose > 1)
+    {
+      for (i = live = 0; i < nclasses; i++)
+	live += find (i) == i;
+      printf ("E-graph of node %4.4lu: %d nodes, %d classes, %d rounds, "
+	      "cost %ld to %ld\n", node->node_id, nnodes, live, rounds,
+	      before, classes[c].cost);
+    }
+  if (classes[c].cost >= before)
+    return;
+
+  by = extract (c, node->order);
+  rewrite_drop (node);
+  node->type = by->type;
+  node->left = by->left;
+  node->right = by->right;
+  node->v = by->v;
+  node->safe_div = by->safe_div;
+  if (by->du_symbol)
+    du_link (node, by->du_symbol);
+  du_unlink (by);
+  freenode (by);
+  nimproved++;
+}
+
+/* The largest pure expressions in NODE */
+static void
+optimize_expr (NODE *node)
+{
+  if ((node->type != NODE_UNOP && node->type != NODE_BINOP) || budget <= 0)
+    return;
+  if (rewrite_pure (node))
+    optimize (node);
+  else
+    {
+      optimize_expr (node->left);
+      if (node->type == NODE_BINOP)
+	optimize_expr (node->right);
+    }
+}
+
+static void
+egraph_expr (NODE *node)
+{
+  optimize_expr (node->v.expr);
+}
+
+traverse_fp egraph_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  NULL,        /* NODE_VAR */
+  NULL,        /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  egraph_expr, /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+size_t
+egraph_run (NODE **rootp)
+{
+  nimproved = ntimeouts = 0;
+  budget = EGRAPH_BUDGET;
+  traverse (*rootp, egraph_fptab);
+
+  free (nodes);
+  free (classes);
+  free (table);
+  free (matches);
+  nodes = NULL;
+  classes = NULL;
+  table = NULL;
+  matches = NULL;
+  nodes_size = classes_size = matches_size = 0;
+  table_size = 0;
+
+  if (verbose && ntimeouts)
+    printf ("E-graph: time limit of %ld ms hit in %lu expressions\n",
+	    egraph_msec, (unsigned long) ntimeouts);
+  if (verbose > 1)
+    {
+      if (budget <= 0)
+	printf ("E-graph: node budget of %d exhausted\n", EGRAPH_BUDGET);
+      printf ("E-graph: %lu expressions improved\n",
+	      (unsigned long) nimproved);
+    }
+  return nimproved;
+}
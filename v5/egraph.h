@@ -0,0 +1,57 @@
+/*
+   V5: egraph.h
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _EGRAPH_H
+#define _EGRAPH_H
+
+#include "tree.h"
+
+#define EGRAPH_VARS 4              /* variables of a rule */
+
+/* A pattern of a rule of egraph.rules: an operator, a constant or a
+   variable */
+struct egraph_pat
+{
+  int op;                          /* RW_KEY, or -1 for a variable */
+  long number;                     /* op == RW_TYPE (NODE_CONST) */
+  int var;                         /* op == -1 */
+  const struct egraph_pat *kid[2];
+};
+
+struct egraph_rule
+{
+  const struct egraph_pat *lhs, *rhs;
+};
+
+/* The rules, compiled by rulegen into egraph.tab.c */
+extern const struct egraph_rule egraph_rules[];
+extern const int egraph_nrules;
+
+/* The cost of a node, given its RW_KEY and the costs of its operands */
+typedef long (*egraph_cost_fp) (int, long, long);
+
+extern egraph_cost_fp egraph_cost;
+extern long egraph_msec;           /* time for an expression, 0: none */
+
+long egraph_cost_size (int, long, long);
+long egraph_cost_speed (int, long, long);
+
+size_t egraph_run (NODE **);
+
+#endif /* not _EGRAPH_H */
@@ -0,0 +1,760 @@
+/* Generated by rulegen from egraph.rules, do not edit */
+
+#include <stdlib.h>
+
+#include "tree.h"
+#include "rewrite.h"
+#include "egraph.h"
+
+#if EGRAPH_VARS < 3
+#error "egraph.rules: more variables in a rule than EGRAPH_VARS"
+#endif
+
+/* egraph.rules:31: (ADD ?a ?b) => (ADD ?b ?a); */
+static const struct egraph_pat p0 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p1 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p2 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p0, &p1 } };
+static const struct egraph_pat p3 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p4 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p5 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p3, &p4 } };
+
+/* egraph.rules:32: (MUL ?a ?b) => (MUL ?b ?a); */
+static const struct egraph_pat p6 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p7 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p8 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p6, &p7 } };
+static const struct egraph_pat p9 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p10 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p11 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p9, &p10 } };
+
+/* egraph.rules:33: (BAND ?a ?b) => (BAND ?b ?a); */
+static const struct egraph_pat p12 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p13 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p14 =
+  { RW_OP (NODE_BINOP, OPCODE_BAND), 0, 0, { &p12, &p13 } };
+static const struct egraph_pat p15 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p16 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p17 =
+  { RW_OP (NODE_BINOP, OPCODE_BAND), 0, 0, { &p15, &p16 } };
+
+/* egraph.rules:34: (AND ?a ?b) => (AND ?b ?a); */
+static const struct egraph_pat p18 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p19 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p20 =
+  { RW_OP (NODE_BINOP, OPCODE_AND), 0, 0, { &p18, &p19 } };
+static const struct egraph_pat p21 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p22 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p23 =
+  { RW_OP (NODE_BINOP, OPCODE_AND), 0, 0, { &p21, &p22 } };
+
+/* egraph.rules:35: (OR ?a ?b) => (OR ?b ?a); */
+static const struct egraph_pat p24 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p25 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p26 =
+  { RW_OP (NODE_BINOP, OPCODE_OR), 0, 0, { &p24, &p25 } };
+static const struct egraph_pat p27 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p28 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p29 =
+  { RW_OP (NODE_BINOP, OPCODE_OR), 0, 0, { &p27, &p28 } };
+
+/* egraph.rules:36: (EQ ?a ?b) => (EQ ?b ?a); */
+static const struct egraph_pat p30 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p31 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p32 =
+  { RW_OP (NODE_BINOP, OPCODE_EQ), 0, 0, { &p30, &p31 } };
+static const struct egraph_pat p33 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p34 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p35 =
+  { RW_OP (NODE_BINOP, OPCODE_EQ), 0, 0, { &p33, &p34 } };
+
+/* egraph.rules:37: (NE ?a ?b) => (NE ?b ?a); */
+static const struct egraph_pat p36 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p37 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p38 =
+  { RW_OP (NODE_BINOP, OPCODE_NE), 0, 0, { &p36, &p37 } };
+static const struct egraph_pat p39 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p40 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p41 =
+  { RW_OP (NODE_BINOP, OPCODE_NE), 0, 0, { &p39, &p40 } };
+
+/* egraph.rules:38: (LT ?a ?b) => (GT ?b ?a); */
+static const struct egraph_pat p42 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p43 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p44 =
+  { RW_OP (NODE_BINOP, OPCODE_LT), 0, 0, { &p42, &p43 } };
+static const struct egraph_pat p45 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p46 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p47 =
+  { RW_OP (NODE_BINOP, OPCODE_GT), 0, 0, { &p45, &p46 } };
+
+/* egraph.rules:39: (GT ?a ?b) => (LT ?b ?a); */
+static const struct egraph_pat p48 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p49 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p50 =
+  { RW_OP (NODE_BINOP, OPCODE_GT), 0, 0, { &p48, &p49 } };
+static const struct egraph_pat p51 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p52 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p53 =
+  { RW_OP (NODE_BINOP, OPCODE_LT), 0, 0, { &p51, &p52 } };
+
+/* egraph.rules:40: (LE ?a ?b) => (GE ?b ?a); */
+static const struct egraph_pat p54 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p55 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p56 =
+  { RW_OP (NODE_BINOP, OPCODE_LE), 0, 0, { &p54, &p55 } };
+static const struct egraph_pat p57 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p58 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p59 =
+  { RW_OP (NODE_BINOP, OPCODE_GE), 0, 0, { &p57, &p58 } };
+
+/* egraph.rules:41: (GE ?a ?b) => (LE ?b ?a); */
+static const struct egraph_pat p60 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p61 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p62 =
+  { RW_OP (NODE_BINOP, OPCODE_GE), 0, 0, { &p60, &p61 } };
+static const struct egraph_pat p63 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p64 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p65 =
+  { RW_OP (NODE_BINOP, OPCODE_LE), 0, 0, { &p63, &p64 } };
+
+/* egraph.rules:42: (ADD (ADD ?a ?b) ?c) => (ADD ?a (ADD ?b ?c)); */
+static const struct egraph_pat p66 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p67 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p68 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p66, &p67 } };
+static const struct egraph_pat p69 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p70 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p68, &p69 } };
+static const struct egraph_pat p71 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p72 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p73 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p74 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p72, &p73 } };
+static const struct egraph_pat p75 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p71, &p74 } };
+
+/* egraph.rules:43: (ADD ?a (ADD ?b ?c)) => (ADD (ADD ?a ?b) ?c); */
+static const struct egraph_pat p76 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p77 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p78 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p79 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p77, &p78 } };
+static const struct egraph_pat p80 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p76, &p79 } };
+static const struct egraph_pat p81 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p82 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p83 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p81, &p82 } };
+static const struct egraph_pat p84 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p85 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p83, &p84 } };
+
+/* egraph.rules:44: (MUL (MUL ?a ?b) ?c) => (MUL ?a (MUL ?b ?c)); */
+static const struct egraph_pat p86 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p87 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p88 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p86, &p87 } };
+static const struct egraph_pat p89 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p90 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p88, &p89 } };
+static const struct egraph_pat p91 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p92 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p93 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p94 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p92, &p93 } };
+static const struct egraph_pat p95 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p91, &p94 } };
+
+/* egraph.rules:45: (MUL ?a (MUL ?b ?c)) => (MUL (MUL ?a ?b) ?c); */
+static const struct egraph_pat p96 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p97 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p98 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p99 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p97, &p98 } };
+static const struct egraph_pat p100 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p96, &p99 } };
+static const struct egraph_pat p101 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p102 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p103 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p101, &p102 } };
+static const struct egraph_pat p104 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p105 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p103, &p104 } };
+
+/* egraph.rules:50: (SUB ?a ?b) => (ADD ?a (NEG ?b)); */
+static const struct egraph_pat p106 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p107 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p108 =
+  { RW_OP (NODE_BINOP, OPCODE_SUB), 0, 0, { &p106, &p107 } };
+static const struct egraph_pat p109 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p110 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p111 =
+  { RW_OP (NODE_UNOP, OPCODE_NEG), 0, 0, { &p110, NULL } };
+static const struct egraph_pat p112 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p109, &p111 } };
+
+/* egraph.rules:51: (ADD ?a (NEG ?b)) => (SUB ?a ?b); */
+static const struct egraph_pat p113 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p114 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p115 =
+  { RW_OP (NODE_UNOP, OPCODE_NEG), 0, 0, { &p114, NULL } };
+static const struct egraph_pat p116 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p113, &p115 } };
+static const struct egraph_pat p117 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p118 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p119 =
+  { RW_OP (NODE_BINOP, OPCODE_SUB), 0, 0, { &p117, &p118 } };
+
+/* egraph.rules:52: (NEG ?a) => (MUL -1 ?a); */
+static const struct egraph_pat p120 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p121 =
+  { RW_OP (NODE_UNOP, OPCODE_NEG), 0, 0, { &p120, NULL } };
+static const struct egraph_pat p122 =
+  { RW_TYPE (NODE_CONST), -1L, 0, { NULL, NULL } };
+static const struct egraph_pat p123 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p124 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p122, &p123 } };
+
+/* egraph.rules:53: (MUL -1 ?a) => (NEG ?a); */
+static const struct egraph_pat p125 =
+  { RW_TYPE (NODE_CONST), -1L, 0, { NULL, NULL } };
+static const struct egraph_pat p126 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p127 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p125, &p126 } };
+static const struct egraph_pat p128 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p129 =
+  { RW_OP (NODE_UNOP, OPCODE_NEG), 0, 0, { &p128, NULL } };
+
+/* egraph.rules:54: (NEG (NEG ?a)) => ?a; */
+static const struct egraph_pat p130 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p131 =
+  { RW_OP (NODE_UNOP, OPCODE_NEG), 0, 0, { &p130, NULL } };
+static const struct egraph_pat p132 =
+  { RW_OP (NODE_UNOP, OPCODE_NEG), 0, 0, { &p131, NULL } };
+static const struct egraph_pat p133 =
+  { -1, 0, 0, { NULL, NULL } };
+
+/* egraph.rules:55: (NEG (ADD ?a ?b)) => (ADD (NEG ?a) (NEG ?b)); */
+static const struct egraph_pat p134 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p135 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p136 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p134, &p135 } };
+static const struct egraph_pat p137 =
+  { RW_OP (NODE_UNOP, OPCODE_NEG), 0, 0, { &p136, NULL } };
+static const struct egraph_pat p138 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p139 =
+  { RW_OP (NODE_UNOP, OPCODE_NEG), 0, 0, { &p138, NULL } };
+static const struct egraph_pat p140 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p141 =
+  { RW_OP (NODE_UNOP, OPCODE_NEG), 0, 0, { &p140, NULL } };
+static const struct egraph_pat p142 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p139, &p141 } };
+
+/* egraph.rules:60: (MUL ?a (ADD ?b ?c)) => (ADD (MUL ?a ?b) (MUL ?a ?c)); */
+static const struct egraph_pat p143 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p144 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p145 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p146 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p144, &p145 } };
+static const struct egraph_pat p147 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p143, &p146 } };
+static const struct egraph_pat p148 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p149 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p150 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p148, &p149 } };
+static const struct egraph_pat p151 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p152 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p153 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p151, &p152 } };
+static const struct egraph_pat p154 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p150, &p153 } };
+
+/* egraph.rules:61: (ADD (MUL ?a ?b) (MUL ?a ?c)) => (MUL ?a (ADD ?b ?c)); */
+static const struct egraph_pat p155 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p156 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p157 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p155, &p156 } };
+static const struct egraph_pat p158 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p159 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p160 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p158, &p159 } };
+static const struct egraph_pat p161 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p157, &p160 } };
+static const struct egraph_pat p162 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p163 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p164 =
+  { -1, 0, 2, { NULL, NULL } };
+static const struct egraph_pat p165 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p163, &p164 } };
+static const struct egraph_pat p166 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p162, &p165 } };
+
+/* egraph.rules:62: (ADD ?a (MUL ?a ?b)) => (MUL ?a (ADD 1 ?b)); */
+static const struct egraph_pat p167 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p168 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p169 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p170 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p168, &p169 } };
+static const struct egraph_pat p171 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p167, &p170 } };
+static const struct egraph_pat p172 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p173 =
+  { RW_TYPE (NODE_CONST), 1L, 0, { NULL, NULL } };
+static const struct egraph_pat p174 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p175 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p173, &p174 } };
+static const struct egraph_pat p176 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p172, &p175 } };
+
+/* egraph.rules:63: (ADD ?a ?a) => (MUL 2 ?a); */
+static const struct egraph_pat p177 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p178 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p179 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p177, &p178 } };
+static const struct egraph_pat p180 =
+  { RW_TYPE (NODE_CONST), 2L, 0, { NULL, NULL } };
+static const struct egraph_pat p181 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p182 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p180, &p181 } };
+
+/* egraph.rules:64: (MUL 2 ?a) => (ADD ?a ?a); */
+static const struct egraph_pat p183 =
+  { RW_TYPE (NODE_CONST), 2L, 0, { NULL, NULL } };
+static const struct egraph_pat p184 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p185 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p183, &p184 } };
+static const struct egraph_pat p186 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p187 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p188 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p186, &p187 } };
+
+/* egraph.rules:69: (ADD ?a 0) => ?a; */
+static const struct egraph_pat p189 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p190 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+static const struct egraph_pat p191 =
+  { RW_OP (NODE_BINOP, OPCODE_ADD), 0, 0, { &p189, &p190 } };
+static const struct egraph_pat p192 =
+  { -1, 0, 0, { NULL, NULL } };
+
+/* egraph.rules:70: (MUL ?a 1) => ?a; */
+static const struct egraph_pat p193 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p194 =
+  { RW_TYPE (NODE_CONST), 1L, 0, { NULL, NULL } };
+static const struct egraph_pat p195 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p193, &p194 } };
+static const struct egraph_pat p196 =
+  { -1, 0, 0, { NULL, NULL } };
+
+/* egraph.rules:71: (MUL ?a 0) => 0; */
+static const struct egraph_pat p197 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p198 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+static const struct egraph_pat p199 =
+  { RW_OP (NODE_BINOP, OPCODE_MUL), 0, 0, { &p197, &p198 } };
+static const struct egraph_pat p200 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+
+/* egraph.rules:72: (SUB ?a ?a) => 0; */
+static const struct egraph_pat p201 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p202 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p203 =
+  { RW_OP (NODE_BINOP, OPCODE_SUB), 0, 0, { &p201, &p202 } };
+static const struct egraph_pat p204 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+
+/* egraph.rules:73: (DIV ?a 1) => ?a; */
+static const struct egraph_pat p205 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p206 =
+  { RW_TYPE (NODE_CONST), 1L, 0, { NULL, NULL } };
+static const struct egraph_pat p207 =
+  { RW_OP (NODE_BINOP, OPCODE_DIV), 0, 0, { &p205, &p206 } };
+static const struct egraph_pat p208 =
+  { -1, 0, 0, { NULL, NULL } };
+
+/* egraph.rules:74: (MOD ?a 1) => 0; */
+static const struct egraph_pat p209 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p210 =
+  { RW_TYPE (NODE_CONST), 1L, 0, { NULL, NULL } };
+static const struct egraph_pat p211 =
+  { RW_OP (NODE_BINOP, OPCODE_MOD), 0, 0, { &p209, &p210 } };
+static const struct egraph_pat p212 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+
+/* egraph.rules:75: (BAND ?a ?a) => ?a; */
+static const struct egraph_pat p213 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p214 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p215 =
+  { RW_OP (NODE_BINOP, OPCODE_BAND), 0, 0, { &p213, &p214 } };
+static const struct egraph_pat p216 =
+  { -1, 0, 0, { NULL, NULL } };
+
+/* egraph.rules:76: (BAND ?a -1) => ?a; */
+static const struct egraph_pat p217 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p218 =
+  { RW_TYPE (NODE_CONST), -1L, 0, { NULL, NULL } };
+static const struct egraph_pat p219 =
+  { RW_OP (NODE_BINOP, OPCODE_BAND), 0, 0, { &p217, &p218 } };
+static const struct egraph_pat p220 =
+  { -1, 0, 0, { NULL, NULL } };
+
+/* egraph.rules:77: (BAND ?a 0) => 0; */
+static const struct egraph_pat p221 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p222 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+static const struct egraph_pat p223 =
+  { RW_OP (NODE_BINOP, OPCODE_BAND), 0, 0, { &p221, &p222 } };
+static const struct egraph_pat p224 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+
+/* egraph.rules:78: (EQ ?a ?a) => 1; */
+static const struct egraph_pat p225 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p226 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p227 =
+  { RW_OP (NODE_BINOP, OPCODE_EQ), 0, 0, { &p225, &p226 } };
+static const struct egraph_pat p228 =
+  { RW_TYPE (NODE_CONST), 1L, 0, { NULL, NULL } };
+
+/* egraph.rules:79: (NE ?a ?a) => 0; */
+static const struct egraph_pat p229 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p230 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p231 =
+  { RW_OP (NODE_BINOP, OPCODE_NE), 0, 0, { &p229, &p230 } };
+static const struct egraph_pat p232 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+
+/* egraph.rules:80: (LT ?a ?a) => 0; */
+static const struct egraph_pat p233 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p234 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p235 =
+  { RW_OP (NODE_BINOP, OPCODE_LT), 0, 0, { &p233, &p234 } };
+static const struct egraph_pat p236 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+
+/* egraph.rules:81: (LE ?a ?a) => 1; */
+static const struct egraph_pat p237 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p238 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p239 =
+  { RW_OP (NODE_BINOP, OPCODE_LE), 0, 0, { &p237, &p238 } };
+static const struct egraph_pat p240 =
+  { RW_TYPE (NODE_CONST), 1L, 0, { NULL, NULL } };
+
+/* egraph.rules:86: (NOT (EQ ?a ?b)) => (NE ?a ?b); */
+static const struct egraph_pat p241 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p242 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p243 =
+  { RW_OP (NODE_BINOP, OPCODE_EQ), 0, 0, { &p241, &p242 } };
+static const struct egraph_pat p244 =
+  { RW_OP (NODE_UNOP, OPCODE_NOT), 0, 0, { &p243, NULL } };
+static const struct egraph_pat p245 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p246 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p247 =
+  { RW_OP (NODE_BINOP, OPCODE_NE), 0, 0, { &p245, &p246 } };
+
+/* egraph.rules:87: (NOT (NE ?a ?b)) => (EQ ?a ?b); */
+static const struct egraph_pat p248 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p249 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p250 =
+  { RW_OP (NODE_BINOP, OPCODE_NE), 0, 0, { &p248, &p249 } };
+static const struct egraph_pat p251 =
+  { RW_OP (NODE_UNOP, OPCODE_NOT), 0, 0, { &p250, NULL } };
+static const struct egraph_pat p252 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p253 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p254 =
+  { RW_OP (NODE_BINOP, OPCODE_EQ), 0, 0, { &p252, &p253 } };
+
+/* egraph.rules:88: (NOT (LT ?a ?b)) => (GE ?a ?b); */
+static const struct egraph_pat p255 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p256 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p257 =
+  { RW_OP (NODE_BINOP, OPCODE_LT), 0, 0, { &p255, &p256 } };
+static const struct egraph_pat p258 =
+  { RW_OP (NODE_UNOP, OPCODE_NOT), 0, 0, { &p257, NULL } };
+static const struct egraph_pat p259 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p260 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p261 =
+  { RW_OP (NODE_BINOP, OPCODE_GE), 0, 0, { &p259, &p260 } };
+
+/* egraph.rules:89: (NOT (GE ?a ?b)) => (LT ?a ?b); */
+static const struct egraph_pat p262 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p263 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p264 =
+  { RW_OP (NODE_BINOP, OPCODE_GE), 0, 0, { &p262, &p263 } };
+static const struct egraph_pat p265 =
+  { RW_OP (NODE_UNOP, OPCODE_NOT), 0, 0, { &p264, NULL } };
+static const struct egraph_pat p266 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p267 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p268 =
+  { RW_OP (NODE_BINOP, OPCODE_LT), 0, 0, { &p266, &p267 } };
+
+/* egraph.rules:90: (NOT (GT ?a ?b)) => (LE ?a ?b); */
+static const struct egraph_pat p269 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p270 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p271 =
+  { RW_OP (NODE_BINOP, OPCODE_GT), 0, 0, { &p269, &p270 } };
+static const struct egraph_pat p272 =
+  { RW_OP (NODE_UNOP, OPCODE_NOT), 0, 0, { &p271, NULL } };
+static const struct egraph_pat p273 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p274 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p275 =
+  { RW_OP (NODE_BINOP, OPCODE_LE), 0, 0, { &p273, &p274 } };
+
+/* egraph.rules:91: (NOT (LE ?a ?b)) => (GT ?a ?b); */
+static const struct egraph_pat p276 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p277 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p278 =
+  { RW_OP (NODE_BINOP, OPCODE_LE), 0, 0, { &p276, &p277 } };
+static const struct egraph_pat p279 =
+  { RW_OP (NODE_UNOP, OPCODE_NOT), 0, 0, { &p278, NULL } };
+static const struct egraph_pat p280 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p281 =
+  { -1, 0, 1, { NULL, NULL } };
+static const struct egraph_pat p282 =
+  { RW_OP (NODE_BINOP, OPCODE_GT), 0, 0, { &p280, &p281 } };
+
+/* egraph.rules:92: (EQ 0 ?a) => (NOT ?a); */
+static const struct egraph_pat p283 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+static const struct egraph_pat p284 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p285 =
+  { RW_OP (NODE_BINOP, OPCODE_EQ), 0, 0, { &p283, &p284 } };
+static const struct egraph_pat p286 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p287 =
+  { RW_OP (NODE_UNOP, OPCODE_NOT), 0, 0, { &p286, NULL } };
+
+/* egraph.rules:93: (AND ?a ?a) => (NE 0 ?a); */
+static const struct egraph_pat p288 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p289 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p290 =
+  { RW_OP (NODE_BINOP, OPCODE_AND), 0, 0, { &p288, &p289 } };
+static const struct egraph_pat p291 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+static const struct egraph_pat p292 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p293 =
+  { RW_OP (NODE_BINOP, OPCODE_NE), 0, 0, { &p291, &p292 } };
+
+/* egraph.rules:94: (OR ?a ?a) => (NE 0 ?a); */
+static const struct egraph_pat p294 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p295 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p296 =
+  { RW_OP (NODE_BINOP, OPCODE_OR), 0, 0, { &p294, &p295 } };
+static const struct egraph_pat p297 =
+  { RW_TYPE (NODE_CONST), 0L, 0, { NULL, NULL } };
+static const struct egraph_pat p298 =
+  { -1, 0, 0, { NULL, NULL } };
+static const struct egraph_pat p299 =
+  { RW_OP (NODE_BINOP, OPCODE_NE), 0, 0, { &p297, &p298 } };
+
+const struct egraph_rule egraph_rules[] = {
+  { &p2, &p5 },
+  { &p8, &p11 },
+  { &p14, &p17 },
+  { &p20, &p23 },
+  { &p26, &p29 },
+  { &p32, &p35 },
+  { &p38, &p41 },
+  { &p44, &p47 },
+  { &p50, &p53 },
+  { &p56, &p59 },
+  { &p62, &p65 },
+  { &p70, &p75 },
+  { &p80, &p85 },
+  { &p90, &p95 },
+  { &p100, &p105 },
+  { &p108, &p112 },
+  { &p116, &p119 },
+  { &p121, &p124 },
+  { &p127, &p129 },
+  { &p132, &p133 },
+  { &p137, &p142 },
+  { &p147, &p154 },
+  { &p161, &p166 },
+  { &p171, &p176 },
+  { &p179, &p182 },
+  { &p185, &p188 },
+  { &p191, &p192 },
+  { &p195, &p196 },
+  { &p199, &p200 },
+  { &p203, &p204 },
+  { &p207, &p208 },
+  { &p211, &p212 },
+  { &p215, &p216 },
+  { &p219, &p220 },
+  { &p223, &p224 },
+  { &p227, &p228 },
+  { &p231, &p232 },
+  { &p235, &p236 },
+  { &p239, &p240 },
+  { &p244, &p247 },
+  { &p251, &p254 },
+  { &p258, &p261 },
+  { &p265, &p268 },
+  { &p272, &p275 },
+  { &p279, &p282 },
+  { &p285, &p287 },
+  { &p290, &p293 },
+  { &p296, &p299 },
+};
+
+const int egraph_nrules = 48;
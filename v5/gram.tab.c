@@ -0,0 +1,1993 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "gram.y"
+
+/*
+   V5: gram.y
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   bison -d -v -t gram.y --> gram.tab.c
+                             gram.tab.h
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "symbol.h"
+#include "tree.h"
+#include "mm.h"
+
+extern int yylex (void);
+int yyerror (const char *);
+void parse_error (const char *, ...);
+
+extern char *yytext;
+extern size_t input_line_num;
+extern int errcnt;
+
+#line 110 "gram.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "gram.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_ID = 3,                         /* ID  */
+  YYSYMBOL_NUMBER = 4,                     /* NUMBER  */
+  YYSYMBOL_AUTO = 5,                       /* AUTO  */
+  YYSYMBOL_BREAK = 6,                      /* BREAK  */
+  YYSYMBOL_CONTINUE = 7,                   /* CONTINUE  */
+  YYSYMBOL_ELSE = 8,                       /* ELSE  */
+  YYSYMBOL_FUNCTION = 9,                   /* FUNCTION  */
+  YYSYMBOL_GLOBAL = 10,                    /* GLOBAL  */
+  YYSYMBOL_IF = 11,                        /* IF  */
+  YYSYMBOL_PRINT = 12,                     /* PRINT  */
+  YYSYMBOL_RETURN = 13,                    /* RETURN  */
+  YYSYMBOL_WHILE = 14,                     /* WHILE  */
+  YYSYMBOL_15_ = 15,                       /* '='  */
+  YYSYMBOL_AND_OP = 16,                    /* AND_OP  */
+  YYSYMBOL_OR_OP = 17,                     /* OR_OP  */
+  YYSYMBOL_EQ_OP = 18,                     /* EQ_OP  */
+  YYSYMBOL_NE_OP = 19,                     /* NE_OP  */
+  YYSYMBOL_LT_OP = 20,                     /* LT_OP  */
+  YYSYMBOL_GT_OP = 21,                     /* GT_OP  */
+  YYSYMBOL_LE_OP = 22,                     /* LE_OP  */
+  YYSYMBOL_GE_OP = 23,                     /* GE_OP  */
+  YYSYMBOL_24_ = 24,                       /* '+'  */
+  YYSYMBOL_25_ = 25,                       /* '-'  */
+  YYSYMBOL_26_ = 26,                       /* '*'  */
+  YYSYMBOL_27_ = 27,                       /* '/'  */
+  YYSYMBOL_28_ = 28,                       /* '%'  */
+  YYSYMBOL_UMINUS = 29,                    /* UMINUS  */
+  YYSYMBOL_30_ = 30,                       /* '!'  */
+  YYSYMBOL_31_ = 31,                       /* ';'  */
+  YYSYMBOL_32_ = 32,                       /* '('  */
+  YYSYMBOL_33_ = 33,                       /* ')'  */
+  YYSYMBOL_34_ = 34,                       /* '{'  */
+  YYSYMBOL_35_ = 35,                       /* '}'  */
+  YYSYMBOL_36_ = 36,                       /* ','  */
+  YYSYMBOL_YYACCEPT = 37,                  /* $accept  */
+  YYSYMBOL_input = 38,                     /* input  */
+  YYSYMBOL_statement_list = 39,            /* statement_list  */
+  YYSYMBOL_statement = 40,                 /* statement  */
+  YYSYMBOL_variable_declaration = 41,      /* variable_declaration  */
+  YYSYMBOL_qualifier = 42,                 /* qualifier  */
+  YYSYMBOL_initializer = 43,               /* initializer  */
+  YYSYMBOL_assignment_statement = 44,      /* assignment_statement  */
+  YYSYMBOL_conditional_statement = 45,     /* conditional_statement  */
+  YYSYMBOL_iteration_statement = 46,       /* iteration_statement  */
+  YYSYMBOL_jump_statement = 47,            /* jump_statement  */
+  YYSYMBOL_level = 48,                     /* level  */
+  YYSYMBOL_print_statement = 49,           /* print_statement  */
+  YYSYMBOL_compound_statement = 50,        /* compound_statement  */
+  YYSYMBOL_lbrace = 51,                    /* lbrace  */
+  YYSYMBOL_rbrace = 52,                    /* rbrace  */
+  YYSYMBOL_function_declaration = 53,      /* function_declaration  */
+  YYSYMBOL_fundecl_header = 54,            /* fundecl_header  */
+  YYSYMBOL_identifier_list = 55,           /* identifier_list  */
+  YYSYMBOL_identifier = 56,                /* identifier  */
+  YYSYMBOL_expression_list = 57,           /* expression_list  */
+  YYSYMBOL_expression = 58,                /* expression  */
+  YYSYMBOL_basic_expr = 59,                /* basic_expr  */
+  YYSYMBOL_arithmetic_expr = 60,           /* arithmetic_expr  */
+  YYSYMBOL_relational_expr = 61,           /* relational_expr  */
+  YYSYMBOL_logical_expr = 62,              /* logical_expr  */
+  YYSYMBOL_function_call = 63              /* function_call  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  50
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   206
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  37
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  27
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  64
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  117
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   278
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    30,     2,     2,     2,    28,     2,     2,
+      32,    33,    26,    24,    36,    25,     2,    27,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    31,
+       2,    15,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    34,     2,    35,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      16,    17,    18,    19,    20,    21,    22,    23,    29
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,    94,    94,    95,   102,   107,   114,   122,   123,   124,
+     125,   126,   127,   128,   129,   130,   134,   149,   153,   161,
+     164,   171,   182,   188,   198,   207,   212,   218,   228,   231,
+     235,   243,   252,   259,   268,   278,   295,   305,   318,   330,
+     334,   341,   349,   354,   355,   359,   360,   367,   374,   381,
+     388,   395,   401,   408,   409,   416,   423,   430,   437,   444,
+     454,   455,   462,   469,   478
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "ID", "NUMBER", "AUTO",
+  "BREAK", "CONTINUE", "ELSE", "FUNCTION", "GLOBAL", "IF", "PRINT",
+  "RETURN", "WHILE", "'='", "AND_OP", "OR_OP", "EQ_OP", "NE_OP", "LT_OP",
+  "GT_OP", "LE_OP", "GE_OP", "'+'", "'-'", "'*'", "'/'", "'%'", "UMINUS",
+  "'!'", "';'", "'('", "')'", "'{'", "'}'", "','", "$accept", "input",
+  "statement_list", "statement", "variable_declaration", "qualifier",
+  "initializer", "assignment_statement", "conditional_statement",
+  "iteration_statement", "jump_statement", "level", "print_statement",
+  "compound_statement", "lbrace", "rbrace", "function_declaration",
+  "fundecl_header", "identifier_list", "identifier", "expression_list",
+  "expression", "basic_expr", "arithmetic_expr", "relational_expr",
+  "logical_expr", "function_call", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-23)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-4)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+     172,   -22,   -23,   -23,     8,     8,    13,   -23,    -4,    11,
+      11,    12,    15,    11,    15,   -23,    32,   107,   -23,   -23,
+      30,   -23,   -23,   -23,   -23,   -23,   -23,   172,   -23,   172,
+      31,    17,   -23,    52,    44,     4,   -23,    11,   -23,    22,
+      43,    49,    11,   -23,    51,    53,    11,   -23,   -23,    -2,
+     -23,    54,   -23,    68,   139,   -23,    11,   -23,    15,    15,
+      15,    15,    15,    15,    15,    15,    15,    15,    15,    11,
+      11,     1,   -23,   -23,   -23,    83,    57,   -23,   -23,    58,
+     -23,   -23,    11,    56,   -23,   -23,    61,    24,    24,   -23,
+     -23,   -23,   -15,   -15,   -23,   -23,   -23,   -23,    76,   -23,
+     -23,    11,   -23,     9,   172,   172,   -23,   -23,   -23,   -23,
+     -23,    92,    88,   -23,   -23,   172,   -23
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       2,    38,    42,    18,    28,    28,     0,    17,     0,     0,
+       0,     0,     0,     0,     0,    32,     0,     0,     4,     8,
+       0,     9,    10,    11,    12,    13,    14,     0,    15,     0,
+      43,     0,    45,    53,    60,    41,    44,     0,    29,     0,
+       0,     0,     0,    43,     0,     0,     0,    51,    63,     0,
+       1,     0,     5,    19,     0,    34,     0,     7,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    39,    26,    27,     0,     0,    30,    25,     0,
+      52,     6,     0,     0,    33,    31,     0,    46,    47,    48,
+      49,    50,    58,    59,    54,    55,    56,    57,    61,    62,
+      64,     0,    36,     0,     0,     0,    20,    16,    21,    40,
+      35,     0,    22,    24,    37,     0,    23
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
+{
+     -23,   -23,    70,   -16,   -23,   -23,   -23,   -23,   -23,   -23,
+     -23,    93,   -23,   -23,   -23,   -23,   -23,   -23,   -23,     0,
+     -23,    -7,   -23,    -3,     5,    -9,   -23
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,    16,    17,    18,    19,    20,    83,    21,    22,    23,
+      24,    39,    25,    26,    27,    85,    28,    29,   103,    43,
+      71,    31,    32,    33,    34,    35,    36
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int8 yytable[] =
+{
+      30,    52,    44,    45,    48,    65,    66,    67,    68,    47,
+      37,    49,    38,    55,     1,     2,    41,    30,     1,     2,
+      69,    70,    58,    59,    60,    61,    62,    30,    42,    30,
+      72,    80,    50,    53,   100,    76,    12,   101,    52,    79,
+      12,    13,   110,    14,    46,   111,    56,    14,    57,    86,
+      60,    61,    62,    73,    30,    87,    88,    89,    90,    91,
+      98,    99,    63,    64,    65,    66,    67,    68,    92,    93,
+      94,    95,    96,    97,    74,   106,    58,    59,    60,    61,
+      62,    75,    77,    82,    78,    81,   102,   107,   112,   113,
+     104,   105,   108,    70,   109,   114,   115,    54,    40,   116,
+       0,     0,     0,     0,    30,    30,     0,    -3,    51,     0,
+       1,     2,     3,     4,     5,    30,     6,     7,     8,     9,
+      10,    11,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    12,     0,     0,     0,     0,    13,     0,    14,
+      51,    15,     1,     2,     3,     4,     5,     0,     6,     7,
+       8,     9,    10,    11,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,    12,     0,     0,     0,     0,    13,
+       0,    14,     0,    15,    84,     1,     2,     3,     4,     5,
+       0,     6,     7,     8,     9,    10,    11,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,    12,     0,     0,
+       0,     0,    13,     0,    14,     0,    15
+};
+
+static const yytype_int8 yycheck[] =
+{
+       0,    17,     9,    10,    13,    20,    21,    22,    23,    12,
+      32,    14,     4,    29,     3,     4,     3,    17,     3,     4,
+      16,    17,    24,    25,    26,    27,    28,    27,    32,    29,
+      37,    33,     0,     3,    33,    42,    25,    36,    54,    46,
+      25,    30,    33,    32,    32,    36,    15,    32,    31,    56,
+      26,    27,    28,    31,    54,    58,    59,    60,    61,    62,
+      69,    70,    18,    19,    20,    21,    22,    23,    63,    64,
+      65,    66,    67,    68,    31,    82,    24,    25,    26,    27,
+      28,    32,    31,    15,    31,    31,     3,    31,   104,   105,
+      33,    33,    31,    17,   101,     3,     8,    27,     5,   115,
+      -1,    -1,    -1,    -1,   104,   105,    -1,     0,     1,    -1,
+       3,     4,     5,     6,     7,   115,     9,    10,    11,    12,
+      13,    14,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    25,    -1,    -1,    -1,    -1,    30,    -1,    32,
+       1,    34,     3,     4,     5,     6,     7,    -1,     9,    10,
+      11,    12,    13,    14,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    25,    -1,    -1,    -1,    -1,    30,
+      -1,    32,    -1,    34,    35,     3,     4,     5,     6,     7,
+      -1,     9,    10,    11,    12,    13,    14,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    25,    -1,    -1,
+      -1,    -1,    30,    -1,    32,    -1,    34
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     3,     4,     5,     6,     7,     9,    10,    11,    12,
+      13,    14,    25,    30,    32,    34,    38,    39,    40,    41,
+      42,    44,    45,    46,    47,    49,    50,    51,    53,    54,
+      56,    58,    59,    60,    61,    62,    63,    32,     4,    48,
+      48,     3,    32,    56,    58,    58,    32,    60,    62,    60,
+       0,     1,    40,     3,    39,    40,    15,    31,    24,    25,
+      26,    27,    28,    18,    19,    20,    21,    22,    23,    16,
+      17,    57,    58,    31,    31,    32,    58,    31,    31,    58,
+      33,    31,    15,    43,    35,    52,    58,    60,    60,    60,
+      60,    60,    61,    61,    61,    61,    61,    61,    62,    62,
+      33,    36,     3,    55,    33,    33,    58,    31,    31,    58,
+      33,    36,    40,    40,     3,     8,    40
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    37,    38,    38,    39,    39,    39,    40,    40,    40,
+      40,    40,    40,    40,    40,    40,    41,    42,    42,    43,
+      43,    44,    45,    45,    46,    47,    47,    47,    48,    48,
+      49,    50,    51,    52,    53,    54,    55,    55,    56,    57,
+      57,    58,    59,    59,    59,    60,    60,    60,    60,    60,
+      60,    60,    60,    61,    61,    61,    61,    61,    61,    61,
+      62,    62,    62,    62,    63
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     0,     1,     1,     2,     3,     2,     1,     1,
+       1,     1,     1,     1,     1,     1,     4,     1,     1,     0,
+       2,     4,     5,     7,     5,     3,     3,     3,     0,     1,
+       3,     3,     1,     1,     2,     5,     1,     3,     1,     1,
+       3,     1,     1,     1,     1,     1,     3,     3,     3,     3,
+       3,     2,     3,     1,     3,     3,     3,     3,     3,     3,
+       1,     3,     3,     2,     4
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+{
+  YY_USE (yyvaluep);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 3: /* input: statement_list  */
+#line 96 "gram.y"
+               {
+                  root = (yyvsp[0].nodelist).head;
+               }
+#line 1255 "gram.tab.c"
+    break;
+
+  case 4: /* statement_list: statement  */
+#line 103 "gram.y"
+               {
+                  (yyvsp[0].node)->right = (yyvsp[0].node)->left = NULL;
+                  (yyval.nodelist).head = (yyval.nodelist).tail = (yyvsp[0].node);
+               }
+#line 1264 "gram.tab.c"
+    break;
+
+  case 5: /* statement_list: statement_list statement  */
+#line 108 "gram.y"
+               {
+                  (yyvsp[0].node)->left = (yyvsp[0].node)->right = NULL;
+                  (yyvsp[-1].nodelist).tail->right = (yyvsp[0].node);
+                  (yyvsp[-1].nodelist).tail = (yyvsp[0].node);
+                  (yyval.nodelist) = (yyvsp[-1].nodelist);
+               }
+#line 1275 "gram.tab.c"
+    break;
+
+  case 6: /* statement_list: statement_list error ';'  */
+#line 115 "gram.y"
+               {
+                  yyerrok;
+                  yyclearin;
+               }
+#line 1284 "gram.tab.c"
+    break;
+
+  case 16: /* variable_declaration: qualifier ID initializer ';'  */
+#line 135 "gram.y"
+               {
+                  SYMBOL *s = putsym (&symbol_variables, (yyvsp[-2].string), SYMBOL_VAR);
+                  if (s)
+                    s->v.var->qualifier = (yyvsp[-3].qualifier);
+                  mm_free_string ((yyvsp[-2].string));
+
+                  (yyval.node) = addnode (NODE_VAR_DECL);
+                  (yyval.node)->v.vardecl.symbol = s;
+                  (yyval.node)->v.vardecl.expr = (yyvsp[-1].node);
+                  du_link ((yyval.node), s);
+               }
+#line 1300 "gram.tab.c"
+    break;
+
+  case 17: /* qualifier: GLOBAL  */
+#line 150 "gram.y"
+               {
+                  (yyval.qualifier) = QUA_GLOBAL;
+               }
+#line 1308 "gram.tab.c"
+    break;
+
+  case 18: /* qualifier: AUTO  */
+#line 154 "gram.y"
+               {
+                  (yyval.qualifier) = QUA_AUTO;
+               }
+#line 1316 "gram.tab.c"
+    break;
+
+  case 19: /* initializer: %empty  */
+#line 161 "gram.y"
+               {
+                  (yyval.node) = NULL;
+               }
+#line 1324 "gram.tab.c"
+    break;
+
+  case 20: /* initializer: '=' expression  */
+#line 165 "gram.y"
+               {
+                  (yyval.node) = (yyvsp[0].node);
+               }
+#line 1332 "gram.tab.c"
+    break;
+
+  case 21: /* assignment_statement: identifier '=' expression ';'  */
+#line 172 "gram.y"
+               {
+                 (yyval.node) = addnode (NODE_ASGN);
+                 (yyval.node)->v.asgn.symbol = (yyvsp[-3].node)->v.symbol;
+                 (yyval.node)->v.asgn.expr = (yyvsp[-1].node);
+                 du_link ((yyval.node), (yyvsp[-3].node)->v.symbol);
+                 freenode ((yyvsp[-3].node));
+               }
+#line 1344 "gram.tab.c"
+    break;
+
+  case 22: /* conditional_statement: IF '(' expression ')' statement  */
+#line 183 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_CONDITION);
+                  (yyval.node)->v.condition.cond = (yyvsp[-2].node);
+                  (yyval.node)->v.condition.iftrue_stmt = (yyvsp[0].node);
+               }
+#line 1354 "gram.tab.c"
+    break;
+
+  case 23: /* conditional_statement: IF '(' expression ')' statement ELSE statement  */
+#line 189 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_CONDITION);
+                  (yyval.node)->v.condition.cond = (yyvsp[-4].node);
+                  (yyval.node)->v.condition.iftrue_stmt  = (yyvsp[-2].node);
+                  (yyval.node)->v.condition.iffalse_stmt = (yyvsp[0].node);
+               }
+#line 1365 "gram.tab.c"
+    break;
+
+  case 24: /* iteration_statement: WHILE '(' expression ')' statement  */
+#line 199 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_ITERATION);
+                  (yyval.node)->v.iteration.cond = (yyvsp[-2].node);
+                  (yyval.node)->v.iteration.stmt = (yyvsp[0].node);
+               }
+#line 1375 "gram.tab.c"
+    break;
+
+  case 25: /* jump_statement: RETURN expression ';'  */
+#line 208 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_RETURN);
+                  (yyval.node)->v.expr = (yyvsp[-1].node);
+               }
+#line 1384 "gram.tab.c"
+    break;
+
+  case 26: /* jump_statement: BREAK level ';'  */
+#line 213 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_JUMP);
+                  (yyval.node)->v.jump.type  = JUMP_BREAK;
+                  (yyval.node)->v.jump.level = (yyvsp[-1].number);
+               }
+#line 1394 "gram.tab.c"
+    break;
+
+  case 27: /* jump_statement: CONTINUE level ';'  */
+#line 219 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_JUMP);
+                  (yyval.node)->v.jump.type  = JUMP_CONTINUE;
+                  (yyval.node)->v.jump.level = (yyvsp[-1].number);
+               }
+#line 1404 "gram.tab.c"
+    break;
+
+  case 28: /* level: %empty  */
+#line 228 "gram.y"
+               {
+                  (yyval.number) = 0;
+               }
+#line 1412 "gram.tab.c"
+    break;
+
+  case 30: /* print_statement: PRINT expression ';'  */
+#line 236 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_PRINT);
+                  (yyval.node)->v.expr = (yyvsp[-1].node);
+               }
+#line 1421 "gram.tab.c"
+    break;
+
+  case 31: /* compound_statement: lbrace statement_list rbrace  */
+#line 244 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_COMPOUND);
+                  (yyval.node)->v.expr = (yyvsp[-1].nodelist).head;
+                  delsym_level (&symbol_variables, nesting_level+1);
+               }
+#line 1431 "gram.tab.c"
+    break;
+
+  case 32: /* lbrace: '{'  */
+#line 253 "gram.y"
+               {
+                  nesting_level++;
+               }
+#line 1439 "gram.tab.c"
+    break;
+
+  case 33: /* rbrace: '}'  */
+#line 260 "gram.y"
+               {
+                  nesting_level--;
+                  if (nesting_level < 0)
+                    parse_error ("nesting error!");
+               }
+#line 1449 "gram.tab.c"
+    break;
+
+  case 34: /* function_declaration: fundecl_header statement  */
+#line 269 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_FNC_DECL);
+                  (yyvsp[-1].symbol)->v.fnc->entry_point = (yyvsp[0].node);
+                  (yyval.node)->v.fncdecl.symbol = (yyvsp[-1].symbol);
+                  (yyval.node)->v.fncdecl.stmt = (yyvsp[0].node);
+               }
+#line 1460 "gram.tab.c"
+    break;
+
+  case 35: /* fundecl_header: FUNCTION ID '(' identifier_list ')'  */
+#line 279 "gram.y"
+               {
+                  SYMLIST *np;
+		  size_t nparam;
+
+                  /* Count the number of parameters */
+                  for (np = (yyvsp[-1].symlist), nparam = 0; np; np = np->next)
+                     nparam++;
+
+                  (yyval.symbol) = putsym (&symbol_functions, (yyvsp[-3].string), SYMBOL_FNC);
+                  mm_free_string ((yyvsp[-3].string));
+		  (yyval.symbol)->v.fnc->nparam = nparam;
+                  (yyval.symbol)->v.fnc->param = (yyvsp[-1].symlist);
+               }
+#line 1478 "gram.tab.c"
+    break;
+
+  case 36: /* identifier_list: ID  */
+#line 296 "gram.y"
+               {
+                  SYMBOL *s = putsym (&symbol_variables, (yyvsp[0].string), SYMBOL_VAR);
+                  if (s) {
+                    s->v.var->level++;
+                    s->v.var->qualifier = QUA_PARAMETER;
+                  }
+                  mm_free_string ((yyvsp[0].string));
+                  (yyval.symlist) = make_symlist (s, NULL);
+               }
+#line 1492 "gram.tab.c"
+    break;
+
+  case 37: /* identifier_list: identifier_list ',' ID  */
+#line 306 "gram.y"
+               {
+                  SYMBOL *s = putsym (&symbol_variables, (yyvsp[0].string), SYMBOL_VAR);
+                  if (s) {
+                    s->v.var->level++;
+                    s->v.var->qualifier = QUA_PARAMETER;
+                  }
+                  mm_free_string ((yyvsp[0].string));
+                  (yyval.symlist) = make_symlist (s, (yyvsp[-2].symlist));
+               }
+#line 1506 "gram.tab.c"
+    break;
+
+  case 38: /* identifier: ID  */
+#line 319 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_VAR);
+                  (yyval.node)->v.symbol = getsym (SYMBOL_VAR, (yyvsp[0].string));
+                  if (!(yyval.node)->v.symbol)
+                    parse_error ("Undefined variable `%s'", (yyvsp[0].string));
+                  du_link ((yyval.node), (yyval.node)->v.symbol);
+                  mm_free_string ((yyvsp[0].string));
+               }
+#line 1519 "gram.tab.c"
+    break;
+
+  case 39: /* expression_list: expression  */
+#line 331 "gram.y"
+               {
+                  (yyval.arglist) = make_arglist ((yyvsp[0].node), NULL);
+               }
+#line 1527 "gram.tab.c"
+    break;
+
+  case 40: /* expression_list: expression_list ',' expression  */
+#line 335 "gram.y"
+               {
+                  (yyval.arglist) = make_arglist ((yyvsp[0].node), (yyvsp[-2].arglist));
+               }
+#line 1535 "gram.tab.c"
+    break;
+
+  case 41: /* expression: logical_expr  */
+#line 342 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_EXPR);
+                  (yyval.node)->v.expr = (yyvsp[0].node);
+               }
+#line 1544 "gram.tab.c"
+    break;
+
+  case 42: /* basic_expr: NUMBER  */
+#line 350 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_CONST);
+                  (yyval.node)->v.number = (yyvsp[0].number);
+               }
+#line 1553 "gram.tab.c"
+    break;
+
+  case 46: /* arithmetic_expr: arithmetic_expr '+' arithmetic_expr  */
+#line 361 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_ADD;
+               }
+#line 1564 "gram.tab.c"
+    break;
+
+  case 47: /* arithmetic_expr: arithmetic_expr '-' arithmetic_expr  */
+#line 368 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_SUB;
+               }
+#line 1575 "gram.tab.c"
+    break;
+
+  case 48: /* arithmetic_expr: arithmetic_expr '*' arithmetic_expr  */
+#line 375 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_MUL;
+               }
+#line 1586 "gram.tab.c"
+    break;
+
+  case 49: /* arithmetic_expr: arithmetic_expr '/' arithmetic_expr  */
+#line 382 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_DIV;
+               }
+#line 1597 "gram.tab.c"
+    break;
+
+  case 50: /* arithmetic_expr: arithmetic_expr '%' arithmetic_expr  */
+#line 389 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_MOD;
+               }
+#line 1608 "gram.tab.c"
+    break;
+
+  case 51: /* arithmetic_expr: '-' arithmetic_expr  */
+#line 396 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_UNOP);
+                  (yyval.node)->left = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_NEG;
+               }
+#line 1618 "gram.tab.c"
+    break;
+
+  case 52: /* arithmetic_expr: '(' arithmetic_expr ')'  */
+#line 402 "gram.y"
+               {
+                  (yyval.node) = (yyvsp[-1].node);
+               }
+#line 1626 "gram.tab.c"
+    break;
+
+  case 54: /* relational_expr: relational_expr LT_OP relational_expr  */
+#line 410 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_LT;
+               }
+#line 1637 "gram.tab.c"
+    break;
+
+  case 55: /* relational_expr: relational_expr GT_OP relational_expr  */
+#line 417 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_GT;
+               }
+#line 1648 "gram.tab.c"
+    break;
+
+  case 56: /* relational_expr: relational_expr LE_OP relational_expr  */
+#line 424 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_LE;
+               }
+#line 1659 "gram.tab.c"
+    break;
+
+  case 57: /* relational_expr: relational_expr GE_OP relational_expr  */
+#line 431 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_GE;
+               }
+#line 1670 "gram.tab.c"
+    break;
+
+  case 58: /* relational_expr: relational_expr EQ_OP relational_expr  */
+#line 438 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_EQ;
+               }
+#line 1681 "gram.tab.c"
+    break;
+
+  case 59: /* relational_expr: relational_expr NE_OP relational_expr  */
+#line 445 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_NE;
+               }
+#line 1692 "gram.tab.c"
+    break;
+
+  case 61: /* logical_expr: logical_expr AND_OP logical_expr  */
+#line 456 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_AND;
+               }
+#line 1703 "gram.tab.c"
+    break;
+
+  case 62: /* logical_expr: logical_expr OR_OP logical_expr  */
+#line 463 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_BINOP);
+                  (yyval.node)->left = (yyvsp[-2].node);
+                  (yyval.node)->right = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_OR;
+               }
+#line 1714 "gram.tab.c"
+    break;
+
+  case 63: /* logical_expr: '!' logical_expr  */
+#line 470 "gram.y"
+               {
+                  (yyval.node) = addnode (NODE_UNOP);
+                  (yyval.node)->left = (yyvsp[0].node);
+                  (yyval.node)->v.opcode = OPCODE_NOT;
+               }
+#line 1724 "gram.tab.c"
+    break;
+
+  case 64: /* function_call: ID '(' expression_list ')'  */
+#line 479 "gram.y"
+               {
+                  SYMBOL *s;
+                  ARGLIST *np;
+                  size_t nparam;
+
+                  s = getsym (SYMBOL_FNC, (yyvsp[-3].string));
+                  if (!s)
+                    {
+                      parse_error ("Function `%s' is not defined", (yyvsp[-3].string));
+                      (yyval.node) = NULL;
+                    }
+                  else
+                    {
+                      /* Count the number of arguments */
+                      for (np = (yyvsp[-1].arglist), nparam = 0; np; np = np->next)
+                         nparam++;
+
+                      /* Check if the number of args is OK */
+                      if (s->v.fnc->nparam < nparam)
+                        parse_error ("Too many arguments in call to `%s'", (yyvsp[-3].string));
+                      else if (s->v.fnc->nparam > nparam)
+                        parse_error ("Too few arguments in call to `%s'", (yyvsp[-3].string));
+
+                      /* Create a new node */
+                      (yyval.node) = addnode (NODE_CALL);
+                      (yyval.node)->v.funcall.symbol = s;
+                      (yyval.node)->v.funcall.args = (yyvsp[-1].arglist);
+                      du_link ((yyval.node), s);
+                    }
+                  mm_free_string ((yyvsp[-3].string));
+               }
+#line 1760 "gram.tab.c"
+    break;
+
+
+#line 1764 "gram.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 511 "gram.y"
+
+
+int
+yyerror (const char *str)
+{
+  fprintf (stderr, "%s, line %u, near token '%s'.\n",
+	   str, (unsigned) input_line_num, yytext);
+  errcnt++;
+  return 0;
+}
+
+void
+parse_error (const char *fmt, ...)
+{
+  va_list arglist;
+  char buf[256];
+
+  va_start (arglist, fmt);
+  vsnprintf (buf, 255, fmt, arglist);
+  va_end (arglist);
+
+  fprintf (stderr, "%s, line %u.",
+	   buf, (unsigned) input_line_num);
+  fputc ('\n', stderr);
+  errcnt++;
+}
+
+int
+parse (void)
+{
+  char *p = getenv ("YYDEBUG");
+  if (p)
+    yydebug =  *p - '0';
+  input_line_num = 1;
+  return yyparse ();
+}
+
@@ -26,6 +26,7 @@
 #include <stdarg.h>
 #include "symbol.h"
 #include "tree.h"
+#include "mm.h"
 
 extern int yylex (void);
 int yyerror (const char *);
@@ -135,10 +136,12 @@ variable_declaration
                   SYMBOL *s = putsym (&symbol_variables, $2, SYMBOL_VAR);
                   if (s)
                     s->v.var->qualifier = $1;
+                  mm_free_string ($2);
 
                   $$ = addnode (NODE_VAR_DECL);
                   $$->v.vardecl.symbol = s;
                   $$->v.vardecl.expr = $3;
+                  du_link ($$, s);
                }
              ;
 
@@ -170,6 +173,8 @@ assignment_statement
                  $$ = addnode (NODE_ASGN);
                  $$->v.asgn.symbol = $1->v.symbol;
                  $$->v.asgn.expr = $3;
+                 du_link ($$, $1->v.symbol);
+                 freenode ($1);
                }
              ;
 
@@ -280,6 +285,7 @@ fundecl_header
                      nparam++;
 
                   $$ = putsym (&symbol_functions, $2, SYMBOL_FNC);
+                  mm_free_string ($2);
 		  $$->v.fnc->nparam = nparam;
                   $$->v.fnc->param = $4;
                }
@@ -293,6 +299,7 @@ identifier_list
                     s->v.var->level++;
                     s->v.var->qualifier = QUA_PARAMETER;
                   }
+                  mm_free_string ($1);
                   $$ = make_symlist (s, NULL);
                }
              | identifier_list ',' ID
@@ -302,6 +309,7 @@ identifier_list
                     s->v.var->level++;
                     s->v.var->qualifier = QUA_PARAMETER;
                   }
+                  mm_free_string ($3);
                   $$ = make_symlist (s, $1);
                }
              ;
@@ -310,9 +318,11 @@ identifier
              : ID
                {
                   $$ = addnode (NODE_VAR);
-                  $$->v.symbol = getsym (symbol_variables, $1);
+                  $$->v.symbol = getsym (SYMBOL_VAR, $1);
                   if (!$$->v.symbol)
                     parse_error ("Undefined variable `%s'", $1);
+                  du_link ($$, $$->v.symbol);
+                  mm_free_string ($1);
                }
              ;
 
@@ -380,6 +390,7 @@ arithmetic_expr
                   $$ = addnode (NODE_BINOP);
                   $$->left = $1;
                   $$->right = $3;
+                  $$->v.opcode = OPCODE_MOD;
                }
              | '-' arithmetic_expr %prec UMINUS
                {
@@ -470,7 +481,7 @@ function_call
                   ARGLIST *np;
                   size_t nparam;
 
-                  s = getsym (symbol_functions, $1);
+                  s = getsym (SYMBOL_FNC, $1);
                   if (!s)
                     {
                       parse_error ("Function `%s' is not defined", $1);
@@ -492,7 +503,9 @@ function_call
                       $$ = addnode (NODE_CALL);
                       $$->v.funcall.symbol = s;
                       $$->v.funcall.args = $3;
+                      du_link ($$, s);
                     }
+                  mm_free_string ($1);
                }
              ;
 %%
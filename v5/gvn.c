@@ -0,0 +1,494 @@
+/*
+   V5: gvn.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "cfg.h"
+#include "ssa.h"
+#include "ipa.h"
+#include "ptrmap.h"
+#include "motion.h"
+#include "gvn.h"
+
+extern int verbose;
+
+/*
+  Global value numbering.
+
+  Every expression gets a value number, so that two expressions with
+  the same number compute the same value: a constant is numbered by
+  its value, a variable by its SSA value, and an operator or a call
+  to a pure function by what it does and the numbers of its operands.
+  The numbers are interned in a hash table, which makes comparing two
+  expressions a lookup.
+
+  The blocks are visited in preorder of the dominator tree.  An
+  expression computed in a block is available in the blocks it
+  dominates, and later in its own block; another expression with the
+  same number there is redundant.  It then reads a temporary, which
+  the first one is stored to right before its statement.
+
+  The first one has to be computed whenever its statement runs: not
+  in a loop condition, nor on the right of && and ||.  Its statement
+  may not call a function with side effects either, since the SSA
+  form only has the values of the variables after such a call.
+*/
+
+enum gvn_kind
+{
+  GVN_CONST,     /* constant */
+  GVN_SSA,       /* variable, by its SSA value */
+  GVN_UNOP,      /* unary operation */
+  GVN_BINOP,     /* binary operation */
+  GVN_CALL,      /* call to a pure function */
+  GVN_OPAQUE     /* anything else, equal to nothing */
+};
+
+struct gvn_leader;
+
+struct gvn_value
+{
+  enum gvn_kind kind;
+  long number;                 /* constant or opcode */
+  const void *ref;             /* SSA value or function */
+  struct gvn_value **ops;      /* operands */
+  size_t nops;
+  size_t id;
+  unsigned long hash;
+  struct gvn_value *hash_next;
+  struct gvn_value *all_next;
+  struct gvn_leader *leader;   /* available computation, or NULL */
+};
+
+/* The first expression computing a value, and the temporary it is
+   stored to once it turns out to be reused */
+struct gvn_leader
+{
+  NODE *expr;
+  SYMBOL *temp;
+  struct gvn_leader *next;
+};
+
+struct gvn_undo
+{
+  struct gvn_value *value;
+  struct gvn_leader *saved;
+};
+
+static struct gvn_value **table;
+static size_t table_size, nvalues;
+static struct gvn_value *all_values;
+static struct gvn_leader *all_leaders;
+static struct gvn_undo *undo;
+static size_t nundo, undo_size;
+
+static struct ssa *ssa;
+static struct cfg *graph;
+static struct ptrmap numbers;     /* expression -> value */
+static struct ptrmap container;   /* leader expression -> statement */
+static int has_side_effects;      /* the site calls an impure function */
+static size_t nreused, ntemps;
+
+static unsigned long
+hash_value (struct gvn_value *v)
+{
+  unsigned long h = (unsigned long) v->kind * 31 + (unsigned long) v->number;
+  size_t i;
+
+  h = h * 31 + (unsigned long) v->ref;
+  for (i = 0; i < v->nops; i++)
+    h = h * 31 + v->ops[i]->id;
+  return h ^ (h >> 15);
+}
+
+static int
+same_value (struct gvn_value *a, struct gvn_value *b)
+{
+  size_t i;
+
+  if (a->hash != b->hash || a->kind != b->kind || a->number != b->number
+      || a->ref != b->ref || a->nops != b->nops)
+    return 0;
+  for (i = 0; i < a->nops; i++)
+    if (a->ops[i] != b->ops[i])
+      return 0;
+  return 1;
+}
+
+static void
+grow_table (void)
+{
+  size_t i, size = table_size ? table_size * 2 : 256;
+  struct gvn_value **t = calloc (size, sizeof (*t));
+  struct gvn_value *v, *next;
+
+  if (!t)
+    exit (EXIT_FAILURE);
+  for (i = 0; i < table_size; i++)
+    for (v = table[i]; v; v = next)
+      {
+	next = v->hash_next;
+	v->hash_next = t[v->hash & (size - 1)];
+	t[v->hash & (size - 1)] = v;
+      }
+  free (table);
+  table = t;
+  table_size = size;
+}
+
+static struct gvn_value *
+new_value (enum gvn_kind kind, long number, const void *ref, size_t nops)
+{
+  struct gvn_value *v = calloc (1, sizeof (*v));
+
+  if (!v)
+    exit (EXIT_FAILURE);
+  v->kind = kind;
+  v->number = number;
+  v->ref = ref;
+  v->nops = nops;
+  if (nops)
+    {
+      v->ops = calloc (nops, sizeof (*v->ops));
+      if (!v->ops)
+	exit (EXIT_FAILURE);
+    }
+  v->id = ++nvalues;
+  v->all_next = all_values;
+  all_values = v;
+  return v;
+}
+
+/* Return the value equal to V, which is entered if it is new */
+static struct gvn_value *
+intern (struct gvn_value *v)
+{
+  struct gvn_value *p;
+  size_t slot;
+
+  v->hash = hash_value (v);
+  if (table_size)
+    for (p = table[v->hash & (table_size - 1)]; p; p = p->hash_next)
+      if (same_value (p, v))
+	return p;
+  if (nvalues >= table_size)
+    grow_table ();
+  slot = v->hash & (table_size - 1);
+  v->hash_next = table[slot];
+  table[slot] = v;
+  return v;
+}
+
+static int
+commutative (enum opcode_type op)
+{
+  return op == OPCODE_ADD || op == OPCODE_MUL
+    || op == OPCODE_EQ || op == OPCODE_NE || op == OPCODE_BAND;
+}
+
+/* Number the expression NODE and its operands */
+static struct gvn_value *
+number_expr (NODE *node)
+{
+  struct gvn_value *v, *t;
+  struct ssa_value *sv;
+  ARGLIST *arg;
+  size_t n;
+
+  switch (node->type) {
+  case NODE_EXPR:
+    return number_expr (node->v.expr);
+
+  case NODE_CONST:
+    v = new_value (GVN_CONST, node->v.number, NULL, 0);
+    break;
+
+  case NODE_VAR:
+    sv = ssa_use_value (ssa, node);
+    v = new_value (sv ? GVN_SSA : GVN_OPAQUE, 0, sv, 0);
+    break;
+
+  case NODE_UNOP:
+    v = new_value (GVN_UNOP, node->v.opcode, NULL, 1);
+    v->ops[0] = number_expr (node->left);
+    break;
+
+  case NODE_BINOP:
+    v = new_value (GVN_BINOP, node->v.opcode, NULL, 2);
+    v->ops[0] = number_expr (node->left);
+    v->ops[1] = number_expr (node->right);
+    if (commutative (node->v.opcode) && v->ops[0]->id > v->ops[1]->id)
+      {
+	t = v->ops[0];
+	v->ops[0] = v->ops[1];
+	v->ops[1] = t;
+      }
+    break;
+
+  case NODE_CALL:
+    for (n = 0, arg = node->v.funcall.args; arg; arg = arg->next)
+      n++;
+    v = new_value (GVN_CALL, 0, node->v.funcall.symbol, n);
+    for (n = 0, arg = node->v.funcall.args; arg; arg = arg->next)
+      v->ops[n++] = number_expr (arg->node);
+    if (!node->v.funcall.symbol->v.fnc->pure)
+      {
+	has_side_effects = 1;
+	v->kind = GVN_OPAQUE;
+      }
+    break;
+
+  default:
+    v = new_value (GVN_OPAQUE, 0, NULL, 0);
+    break;
+  }
+
+  /* An opaque value stands for itself */
+  if (v->kind != GVN_OPAQUE)
+    v = intern (v);
+  ptrmap_put (&numbers, node, 0, v);
+  return v;
+}
+
+static NODE *moved_to;
+
+static void
+move_container (NODE *node)
+{
+  if (ptrmap_get (&container, node, 0))
+    ptrmap_put (&container, node, 0, moved_to);
+}
+
+traverse_fp gvn_move_fptab[] = {
+  NULL,            /* NODE_NOOP */
+  move_container,  /* NODE_UNOP */
+  move_container,  /* NODE_BINOP */
+  NULL,            /* NODE_CONST */
+  NULL,            /* NODE_VAR */
+  move_container,  /* NODE_CALL */
+  NULL,            /* NODE_ASGN */
+  NULL,            /* NODE_EXPR */
+  NULL,            /* NODE_RETURN */
+  NULL,            /* NODE_PRINT */
+  NULL,            /* NODE_JUMP */
+  NULL,            /* NODE_COMPOUND  */
+  NULL,            /* NODE_ITERATION */
+  NULL,            /* NODE_CONDITION */
+  NULL,            /* NODE_VAR_DECL */
+  NULL,            /* NODE_FNC_DECL */
+};
+
+/* Store the leader L to a new temporary, declared right before the
+   statement it is in */
+static SYMBOL *
+make_leader_temp (struct gvn_leader *l)
+{
+  NODE *stmt = ptrmap_get (&container, l->expr, 0);
+  NODE *decl = motion_save (l->expr, stmt, graph->function ? 1 : 0);
+
+  l->temp = decl->v.vardecl.symbol;
+  ntemps++;
+
+  /* The leaders inside it have moved to the declaration */
+  ptrmap_put (&container, l->expr, 0, NULL);
+  moved_to = decl;
+  traverse_expr (decl->v.vardecl.expr, gvn_move_fptab);
+
+  if (verbose > 1)
+    printf ("Saving node %4.4lu to %s\n", l->expr->node_id, l->temp->name);
+  return l->temp;
+}
+
+static void
+set_leader (struct gvn_value *v, NODE *node, NODE *stmt)
+{
+  struct gvn_leader *l = calloc (1, sizeof (*l));
+
+  if (!l)
+    exit (EXIT_FAILURE);
+  l->expr = node;
+  l->next = all_leaders;
+  all_leaders = l;
+  ptrmap_put (&container, node, 0, stmt);
+
+  if (nundo == undo_size)
+    {
+      undo_size = undo_size ? undo_size * 2 : 64;
+      undo = xrealloc (undo, undo_size * sizeof (*undo));
+    }
+  undo[nundo].value = v;
+  undo[nundo].saved = v->leader;
+  nundo++;
+  v->leader = l;
+}
+
+/* Reuse the available values in the expression NODE of STMT, or make
+   its parts available if LEADER_OK */
+static void
+reuse_expr (NODE *node, NODE *stmt, int leader_ok)
+{
+  struct gvn_value *v;
+  SYMBOL *s;
+  ARGLIST *arg;
+
+  if (node->type == NODE_EXPR)
+    {
+      reuse_expr (node->v.expr, stmt, leader_ok);
+      return;
+    }
+  if (node->type != NODE_UNOP && node->type != NODE_BINOP
+      && node->type != NODE_CALL)
+    return;
+
+  v = ptrmap_get (&numbers, node, 0);
+  if (v->kind != GVN_OPAQUE && v->leader)
+    {
+      s = v->leader->temp ? v->leader->temp : make_leader_temp (v->leader);
+      if (verbose > 1)
+	printf ("Reusing %s for node %4.4lu\n", s->name, node->node_id);
+      motion_replace (node, s);
+      nreused++;
+      return;
+    }
+  if (v->kind != GVN_OPAQUE && leader_ok)
+    set_leader (v, node, stmt);
+
+  switch (node->type) {
+  case NODE_UNOP:
+    reuse_expr (node->left, stmt, leader_ok);
+    break;
+  case NODE_BINOP:
+    reuse_expr (node->left, stmt, leader_ok);
+    /* The right operand of && and || may not be evaluated */
+    reuse_expr (node->right, stmt, leader_ok
+		&& node->v.opcode != OPCODE_AND
+		&& node->v.opcode != OPCODE_OR);
+    break;
+  default:
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      reuse_expr (arg->node, stmt, leader_ok);
+    break;
+  }
+}
+
+static void
+reuse_site (struct ssa_site *site)
+{
+  NODE *stmt = site->stmt;
+  ARGLIST *arg;
+  int leader_ok;
+
+  has_side_effects = 0;
+  if (site->expr)
+    number_expr (site->expr->v.expr);
+  else if (stmt->type == NODE_CALL)
+    for (arg = stmt->v.funcall.args; arg; arg = arg->next)
+      number_expr (arg->node);
+  else
+    return;
+
+  leader_ok = !has_side_effects && stmt->type != NODE_CALL
+    && stmt->type != NODE_ITERATION;
+  if (site->expr)
+    reuse_expr (site->expr->v.expr, stmt, leader_ok);
+  else
+    for (arg = stmt->v.funcall.args; arg; arg = arg->next)
+      reuse_expr (arg->node, stmt, 0);
+}
+
+static void
+walk_dominators (struct cfg_block *b)
+{
+  struct ssa_block *sb = &ssa->blocks[b->index];
+  size_t i, mark = nundo;
+
+  for (i = 0; i < sb->nsites; i++)
+    reuse_site (sb->sites[i]);
+  for (i = 0; i < b->ndom_children; i++)
+    walk_dominators (b->dom_children[i]);
+
+  while (nundo > mark)
+    {
+      nundo--;
+      undo[nundo].value->leader = undo[nundo].saved;
+    }
+}
+
+static void
+free_values (void)
+{
+  struct gvn_value *v, *vnext;
+  struct gvn_leader *l, *lnext;
+
+  for (v = all_values; v; v = vnext)
+    {
+      vnext = v->all_next;
+      free (v->ops);
+      free (v);
+    }
+  for (l = all_leaders; l; l = lnext)
+    {
+      lnext = l->next;
+      free (l);
+    }
+  free (table);
+  table = NULL;
+  all_values = NULL;
+  all_leaders = NULL;
+  table_size = nvalues = 0;
+  ptrmap_free (&numbers);
+  ptrmap_free (&container);
+}
+
+/* Replace the redundant expressions in the program rooted at *ROOTP
+   with temporaries.  Returns the number of expressions replaced. */
+size_t
+gvn_run (NODE **rootp)
+{
+  struct cfg *graphs, *g;
+
+  nreused = ntemps = 0;
+  ipa_analyze (*rootp);
+  motion_begin (rootp);
+  graphs = cfg_build (*rootp);
+  for (g = graphs; g; g = g->next)
+    {
+      graph = g;
+      ssa = ssa_build (g);
+      walk_dominators (g->entry);
+      ssa_free (ssa);
+      ssa = NULL;
+      free_values ();
+    }
+  cfg_free (graphs);
+  ipa_free ();
+  motion_end ();
+
+  free (undo);
+  undo = NULL;
+  nundo = undo_size = 0;
+
+  if (verbose > 1)
+    printf ("Value numbering: %lu expressions reused, %lu temporaries\n",
+	    (unsigned long) nreused, (unsigned long) ntemps);
+  return nreused;
+}
@@ -0,0 +1,674 @@
+/*
+   V5: inline.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "ptrmap.h"
+#include "ipa.h"
+#include "motion.h"
+#include "inline.h"
+
+extern int verbose;
+
+/*
+  Function inlining.
+
+  A call is replaced by a copy of the body of the function, put in
+  front of the statement making the call.  The parameters and the
+  automatic variables of the copy become new temporaries of the
+  caller, the parameters set from the arguments in their order, and
+  the value of the last `return' is stored to another temporary the
+  statement reads instead of the call.  A function returning from
+  anywhere else is copied into a `while (1)' loop, each `return'
+  storing the value and leaving it by a `break'.
+
+  A function can only call the functions declared before it, so the
+  program is walked in order: the functions a body calls have been
+  inlined into first.  The copy must mean the same in the caller, so
+  the function may only use its own variables and global ones, must
+  end with a `return', may not declare functions or globals, jump
+  out of its body or call itself, even through other functions.
+
+  Moving the call in front of its statement changes the order of
+  evaluation: the parts of the statement computed before the call
+  are now computed after it.  These must not read anything the call
+  or its arguments may write, and must not fail.  The right operand
+  of && and || and the condition of a `while' are not computed
+  every time, so their calls stay.
+
+  The cost model weighs the size of the body against the gain: the
+  function may be larger when arguments are constants, which fold
+  in the copy, when the call is in a loop, and when it is the only
+  call of the function.  The program may at most double.
+*/
+
+#define INLINE_BASE 32          /* nodes of a body always inlined */
+#define INLINE_CONST_BONUS 8    /* nodes more for a constant argument */
+#define INLINE_LOOP_DEPTH 3     /* nested loops doubling the limit */
+#define INLINE_ONCE 256         /* nodes of a function called once */
+#define INLINE_GROWTH_MIN 256   /* nodes the program may always grow */
+
+struct inline_fn
+{
+  int ok;                       /* the function may be inlined */
+  size_t size;                  /* nodes of the body */
+  int wrap;                     /* returns before the end */
+  struct inline_fn *next;
+};
+
+static struct ptrmap fns;        /* function -> struct inline_fn */
+static struct inline_fn *all_fns;
+static struct ptrmap locals;     /* variable -> temporary of the copy */
+static struct ptrmap visited;    /* functions seen by recursive () */
+static NODE **earlier;           /* parts computed before the site */
+static size_t nearlier, earlier_size;
+static int level;                /* level of new temporaries */
+static unsigned loop_depth;      /* loops around the site */
+static size_t budget;            /* nodes the program may grow */
+static size_t ninlined, nadded;
+
+/* The top-level statements of a body */
+static NODE *
+body_list (SYMBOL *fnc)
+{
+  NODE *body = fnc->v.fnc->entry_point;
+
+  if (body && body->type == NODE_COMPOUND && !body->right)
+    return body->v.expr;
+  return body;
+}
+
+
+/* Eligibility */
+
+static int scan_bad;
+
+/* A variable the copy may use: a global one, or one of the function */
+static void
+check_symbol (SYMBOL *s)
+{
+  if (s && s->v.var->qualifier != QUA_GLOBAL
+      && !ptrmap_get (&locals, s, 0))
+    scan_bad = 1;
+}
+
+static void
+check_var (NODE *node)
+{
+  check_symbol (node->v.symbol);
+}
+
+traverse_fp inline_check_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  check_var,   /* NODE_VAR */
+  NULL,        /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+/* Check the statements from NODE on, DEPTH loops deep in the body;
+   LAST is the statement ending the body.  Sets WRAP if a `return'
+   other than LAST leaves the body. */
+static void
+check_list (NODE *node, unsigned depth, NODE *last, int *wrap)
+{
+  ARGLIST *arg;
+
+  for (; node && !scan_bad; node = node->right)
+    switch (node->type) {
+    case NODE_CALL:
+      for (arg = node->v.funcall.args; arg; arg = arg->next)
+	traverse_expr (arg->node, inline_check_fptab);
+      break;
+    case NODE_ASGN:
+      check_symbol (node->v.asgn.symbol);
+      traverse_expr (node->v.asgn.expr, inline_check_fptab);
+      break;
+    case NODE_VAR_DECL:
+      if (!node->v.vardecl.symbol
+	  || node->v.vardecl.symbol->v.var->qualifier != QUA_AUTO)
+	{
+	  scan_bad = 1;
+	  break;
+	}
+      traverse_expr (node->v.vardecl.expr, inline_check_fptab);
+      ptrmap_put (&locals, node->v.vardecl.symbol, 0, node);
+      break;
+    case NODE_RETURN:
+      if (!node->v.expr)
+	scan_bad = 1;
+      else
+	traverse_expr (node->v.expr, inline_check_fptab);
+      if (node != last)
+	*wrap = 1;
+      break;
+    case NODE_EXPR:
+    case NODE_PRINT:
+      traverse_expr (node->v.expr, inline_check_fptab);
+      break;
+    case NODE_JUMP:
+      if ((node->v.jump.level ? node->v.jump.level : 1) > depth)
+	scan_bad = 1;
+      break;
+    case NODE_COMPOUND:
+      check_list (node->v.expr, depth, last, wrap);
+      break;
+    case NODE_ITERATION:
+      traverse_expr (node->v.iteration.cond, inline_check_fptab);
+      check_list (node->v.iteration.stmt, depth + 1, last, wrap);
+      break;
+    case NODE_CONDITION:
+      traverse_expr (node->v.condition.cond, inline_check_fptab);
+      check_list (node->v.condition.iftrue_stmt, depth, last, wrap);
+      check_list (node->v.condition.iffalse_stmt, depth, last, wrap);
+      break;
+    case NODE_FNC_DECL:
+      scan_bad = 1;
+      break;
+    default:
+      break;
+    }
+}
+
+static SYMBOL *reach_target;
+static int reach_found;
+
+static void reach_calls (SYMBOL *);
+
+static void
+reach_call (NODE *node)
+{
+  SYMBOL *s = node->v.funcall.symbol;
+
+  if (s == reach_target)
+    reach_found = 1;
+  else if (!reach_found && !ptrmap_get (&visited, s, 0))
+    reach_calls (s);
+}
+
+traverse_fp inline_reach_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  NULL,        /* NODE_VAR */
+  reach_call,  /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+static void
+reach_calls (SYMBOL *fnc)
+{
+  ptrmap_put (&visited, fnc, 0, fnc);
+  traverse (fnc->v.fnc->entry_point, inline_reach_fptab);
+}
+
+/* Does FNC call itself, directly or through other functions? */
+static int
+recursive (SYMBOL *fnc)
+{
+  reach_target = fnc;
+  reach_found = 0;
+  reach_calls (fnc);
+  ptrmap_free (&visited);
+  return reach_found;
+}
+
+static struct inline_fn *
+fn_info (SYMBOL *fnc)
+{
+  struct inline_fn *info = ptrmap_get (&fns, fnc, 0);
+  NODE *last;
+  SYMLIST *p;
+  int nparam = 0;
+
+  if (info)
+    return info;
+  info = calloc (1, sizeof (*info));
+  if (!info)
+    exit (EXIT_FAILURE);
+  ptrmap_put (&fns, fnc, 0, info);
+  info->next = all_fns;
+  all_fns = info;
+
+  for (last = body_list (fnc); last && last->right; last = last->right)
+    ;
+  if (!last || last->type != NODE_RETURN)
+    return info;
+
+  for (p = fnc->v.fnc->param; p; p = p->next)
+    {
+      ptrmap_put (&locals, p->symbol, 0, p);
+      nparam++;
+    }
+  scan_bad = nparam != fnc->v.fnc->nparam;
+  check_list (body_list (fnc), 0, last, &info->wrap);
+  ptrmap_free (&locals);
+  if (scan_bad || recursive (fnc))
+    return info;
+
+  info->size = count_nodes (fnc->v.fnc->entry_point);
+  info->ok = 1;
+  return info;
+}
+
+
+/* Order of evaluation */
+
+/* Can a call to FNC or its arguments ARGS change S? */
+static int
+may_write (SYMBOL *fnc, ARGLIST *args, SYMBOL *s);
+
+static int
+expr_may_write (NODE *node, SYMBOL *s)
+{
+  node = strip (node);
+  switch (node->type) {
+  case NODE_UNOP:
+    return expr_may_write (node->left, s);
+  case NODE_BINOP:
+    return expr_may_write (node->left, s) || expr_may_write (node->right, s);
+  case NODE_CALL:
+    return may_write (node->v.funcall.symbol, node->v.funcall.args, s);
+  default:
+    return 0;
+  }
+}
+
+static int
+may_write (SYMBOL *fnc, ARGLIST *args, SYMBOL *s)
+{
+  if (ipa_may_write (fnc, s))
+    return 1;
+  for (; args; args = args->next)
+    if (expr_may_write (args->node, s))
+      return 1;
+  return 0;
+}
+
+/* May NODE, computed after the call CALL instead of before it, give
+   another value or fail? */
+static int
+quiet (NODE *node, NODE *call)
+{
+  NODE *r;
+  ARGLIST *arg;
+
+  node = strip (node);
+  switch (node->type) {
+  case NODE_CONST:
+    return 1;
+  case NODE_VAR:
+    return !may_write (call->v.funcall.symbol, call->v.funcall.args,
+		       node->v.symbol);
+  case NODE_UNOP:
+    return quiet (node->left, call);
+  case NODE_BINOP:
+    r = strip (node->right);
+    if (node->v.opcode == OPCODE_DIV
+	&& (r->type != NODE_CONST || r->v.number == 0 || r->v.number == -1))
+      return 0;
+    if (node->v.opcode == OPCODE_MOD
+	&& (r->type != NODE_CONST || r->v.number == 0))
+      return 0;
+    return quiet (node->left, call) && quiet (node->right, call);
+  case NODE_CALL:
+    if (!node->v.funcall.symbol->v.fnc->total)
+      return 0;
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      if (!quiet (arg->node, call))
+	return 0;
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+static void
+push_earlier (NODE *node)
+{
+  if (nearlier == earlier_size)
+    {
+      earlier_size = earlier_size ? earlier_size * 2 : 16;
+      earlier = xrealloc (earlier, earlier_size * sizeof (*earlier));
+    }
+  earlier[nearlier++] = node;
+}
+
+
+/* Copying the body */
+
+static SYMBOL *result;           /* temporary of the returned value */
+static int wrapped;              /* the copy is in a `while (1)' loop */
+
+static SYMBOL *
+map_symbol (SYMBOL *s)
+{
+  SYMBOL *t;
+
+  if (!s || s->v.var->qualifier == QUA_GLOBAL)
+    return s;
+  t = ptrmap_get (&locals, s, 0);
+  if (!t)
+    {
+      t = make_temp (level);
+      ptrmap_put (&locals, s, 0, t);
+    }
+  return t;
+}
+
+static struct copy_hooks inline_hooks;
+
+/* Copy the statement NODE, DEPTH loops deep in the body, to the end
+   of the list at *TAIL if it needs more than a plain copy; returns
+   the new end */
+static NODE **
+copy_return (NODE *node, unsigned depth, NODE **tail)
+{
+  NODE *copy;
+
+  switch (node->type) {
+  case NODE_NOOP:
+    return tail;
+  case NODE_RETURN:
+    if (!wrapped)
+      {
+	*tail = make_decl (result, copy_expr (node->v.expr, &inline_hooks));
+	return &(*tail)->right;
+      }
+    *tail = make_asgn (result, copy_expr (node->v.expr, &inline_hooks));
+    tail = &(*tail)->right;
+    /* Leave the loops of the body and the one around it */
+    copy = addnode (NODE_JUMP);
+    copy->v.jump.type = JUMP_BREAK;
+    copy->v.jump.level = depth ? depth + 1 : 0;
+    *tail = copy;
+    return &copy->right;
+  default:
+    return NULL;
+  }
+}
+
+static struct copy_hooks inline_hooks = { map_symbol, NULL, copy_return };
+
+
+/* Inlining */
+
+/* Replace the call CALL made by the statement STMT with a copy of
+   the body of the function */
+static void
+inline_call (NODE *call, NODE *stmt, struct inline_fn *info)
+{
+  SYMBOL *fnc = call->v.funcall.symbol;
+  NODE **decls, *body, *node, *loop, *next;
+  ARGLIST *arg;
+  SYMLIST *p;
+  int i, n = fnc->v.fnc->nparam;
+
+  if (verbose > 1)
+    printf ("Inlining function %s into node %4.4lu\n",
+	    fnc->name, stmt->node_id);
+
+  /* Both lists are kept backwards, the arguments are computed from
+     the end */
+  decls = xrealloc (NULL, n * sizeof (*decls));
+  for (p = fnc->v.fnc->param, arg = call->v.funcall.args, i = 0;
+       p; p = p->next, arg = arg->next, i++)
+    {
+      node = arg->node;
+      if (node->type != NODE_EXPR)
+	node = make_expr (node);
+      decls[i] = make_decl (map_symbol (p->symbol), node);
+    }
+  while (i-- > 0)
+    motion_insert_before (stmt, decls[i]);
+  free (decls);
+
+  while ((arg = call->v.funcall.args))
+    {
+      call->v.funcall.args = arg->next;
+      mm_free (MEM_ARGLIST, arg, sizeof (ARGLIST));
+    }
+
+  result = make_temp (level);
+  wrapped = info->wrap;
+  body = copy_list (body_list (fnc), NULL, 0, &inline_hooks);
+  if (wrapped)
+    {
+      motion_insert_before (stmt, make_decl (result, NULL));
+      loop = addnode (NODE_ITERATION);
+      loop->v.iteration.cond = make_expr (make_const (1));
+      loop->v.iteration.stmt = addnode (NODE_COMPOUND);
+      loop->v.iteration.stmt->v.expr = body;
+      motion_insert_before (stmt, loop);
+    }
+  else
+    for (node = body; node; node = next)
+      {
+	next = node->right;
+	motion_insert_before (stmt, node);
+      }
+  ptrmap_free (&locals);
+
+  if (stmt == call)
+    {
+      du_unlink (call);
+      call->type = NODE_NOOP;
+    }
+  else
+    motion_replace (call, result);
+
+  ninlined++;
+  nadded += info->size;
+}
+
+/* Is the call CALL of the statement STMT worth inlining, and can it
+   be done? */
+static void
+try_call (NODE *call, NODE *stmt)
+{
+  SYMBOL *fnc = call->v.funcall.symbol;
+  struct inline_fn *info = fn_info (fnc);
+  ARGLIST *arg;
+  size_t limit, i;
+  int nargs = 0, nconst = 0;
+
+  if (!info->ok)
+    return;
+  for (arg = call->v.funcall.args; arg; arg = arg->next)
+    {
+      nargs++;
+      if (strip (arg->node)->type == NODE_CONST)
+	nconst++;
+    }
+  if (nargs != fnc->v.fnc->nparam)
+    return;
+
+  limit = INLINE_BASE + INLINE_CONST_BONUS * nconst;
+  limit <<= loop_depth < INLINE_LOOP_DEPTH ? loop_depth : INLINE_LOOP_DEPTH;
+  if (fnc->nuses == 1 && limit < INLINE_ONCE)
+    limit = INLINE_ONCE;
+  if (info->size > limit || nadded + info->size > budget)
+    return;
+
+  for (i = 0; i < nearlier; i++)
+    if (!quiet (earlier[i], call))
+      return;
+  inline_call (call, stmt, info);
+}
+
+/* Inline the calls of NODE, in the order they are made */
+static void
+inline_expr (NODE *node, NODE *stmt)
+{
+  ARGLIST *arg, **args;
+  size_t base = nearlier;
+  int i, n = 0;
+
+  if (!node)
+    return;
+  node = strip (node);
+  switch (node->type) {
+  case NODE_UNOP:
+    inline_expr (node->left, stmt);
+    break;
+  case NODE_BINOP:
+    inline_expr (node->left, stmt);
+    /* The right operand of && and || may not be computed */
+    if (node->v.opcode == OPCODE_AND || node->v.opcode == OPCODE_OR)
+      break;
+    push_earlier (node->left);
+    inline_expr (node->right, stmt);
+    break;
+  case NODE_CALL:
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      n++;
+    args = xrealloc (NULL, (n + 1) * sizeof (*args));
+    for (arg = node->v.funcall.args, i = 0; arg; arg = arg->next)
+      args[i++] = arg;
+    while (i-- > 0)
+      {
+	inline_expr (args[i]->node, stmt);
+	push_earlier (args[i]->node);
+      }
+    free (args);
+    nearlier = base;
+    try_call (node, stmt);
+    break;
+  default:
+    break;
+  }
+  nearlier = base;
+}
+
+static void inline_list (NODE *);
+
+static void
+inline_stmt (NODE *node)
+{
+  int saved_level;
+  unsigned saved_depth;
+
+  switch (node->type) {
+  case NODE_CALL:
+    inline_expr (node, node);
+    break;
+  case NODE_ASGN:
+    inline_expr (node->v.asgn.expr, node);
+    break;
+  case NODE_VAR_DECL:
+    inline_expr (node->v.vardecl.expr, node);
+    break;
+  case NODE_EXPR:
+  case NODE_RETURN:
+  case NODE_PRINT:
+    inline_expr (node->v.expr, node);
+    break;
+  case NODE_COMPOUND:
+    inline_list (node->v.expr);
+    break;
+  case NODE_ITERATION:
+    /* The condition is computed on every trip */
+    loop_depth++;
+    inline_list (node->v.iteration.stmt);
+    loop_depth--;
+    break;
+  case NODE_CONDITION:
+    inline_expr (node->v.condition.cond, node);
+    inline_list (node->v.condition.iftrue_stmt);
+    inline_list (node->v.condition.iffalse_stmt);
+    break;
+  case NODE_FNC_DECL:
+    saved_level = level;
+    saved_depth = loop_depth;
+    level = 1;
+    loop_depth = 0;
+    inline_list (node->v.fncdecl.stmt);
+    level = saved_level;
+    loop_depth = saved_depth;
+    break;
+  default:
+    break;
+  }
+}
+
+/* The statements in front of NODE are never visited again */
+static void
+inline_list (NODE *node)
+{
+  for (; node; node = node->right)
+    inline_stmt (node);
+}
+
+/* Inline the calls of the program rooted at *ROOTP chosen by the
+   cost model.  Returns the number of calls inlined. */
+size_t
+inline_run (NODE **rootp)
+{
+  ninlined = nadded = 0;
+  budget = nodes_counter > INLINE_GROWTH_MIN ? nodes_counter
+    : INLINE_GROWTH_MIN;
+  level = 0;
+  loop_depth = 0;
+
+  ipa_analyze (*rootp);
+  motion_begin (rootp);
+  inline_list (*rootp);
+  motion_end ();
+  ipa_free ();
+
+  while (all_fns)
+    {
+      struct inline_fn *next = all_fns->next;
+      free (all_fns);
+      all_fns = next;
+    }
+  ptrmap_free (&fns);
+  free (earlier);
+  earlier = NULL;
+  nearlier = earlier_size = 0;
+
+  if (verbose > 1)
+    printf ("Inlining: %lu calls inlined, %lu nodes added\n",
+	    (unsigned long) ninlined, (unsigned long) nadded);
+  return ninlined;
+}
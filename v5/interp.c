@@ -0,0 +1,338 @@
+/*
+   V5: interp.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <setjmp.h>
+
+#include "tree.h"
+#include "ptrmap.h"
+#include "interp.h"
+
+/*
+  Tree interpreter.
+
+  Runs the final tree directly, to check what the optimizer did and to
+  count the work it saved.  Arithmetic wraps around like the machine
+  would, && and || do not compute their right operand when the left
+  one decides, and a variable is read from the frame of the call it
+  belongs to.  The cell of a variable is looked up by its symbol and
+  the depth of the call, so each call gets fresh cells and the cells
+  of a depth are used again by the next call at that depth.
+*/
+
+#define MAX_DEPTH 10000            /* deepest call allowed */
+
+enum exec_status
+{
+  EXEC_NORMAL,
+  EXEC_BREAK,
+  EXEC_CONTINUE,
+  EXEC_RETURN
+};
+
+struct cell
+{
+  long value;
+  struct cell *next;               /* next cell allocated */
+};
+
+static struct ptrmap cells;        /* (symbol, depth) -> cell */
+static struct cell *all_cells;
+static long *stack;                /* arguments being computed */
+static size_t sp, stack_size;
+static size_t depth;               /* depth of the call being run */
+static long retval;                /* value of the last return */
+static unsigned jump_level;        /* loops left to leave by a jump */
+static jmp_buf runtime_error;
+
+static unsigned long nstmts;       /* statements run */
+static unsigned long nexprs;       /* expression nodes computed */
+static unsigned long nmuls;        /* multiplications and divisions */
+static unsigned long ncalls;       /* functions called */
+static unsigned long nglobals;     /* reads and writes of globals */
+
+static long eval (NODE *);
+static enum exec_status exec_list (NODE *);
+
+static void
+error (const char *msg)
+{
+  fflush (stdout);
+  fprintf (stderr, "Runtime error: %s\n", msg);
+  longjmp (runtime_error, 1);
+}
+
+static long *
+cell (SYMBOL *s)
+{
+  size_t sub = s->v.var->qualifier == QUA_GLOBAL ? 0 : depth;
+  struct cell *c;
+
+  if (s->v.var->qualifier == QUA_GLOBAL)
+    nglobals++;
+  c = ptrmap_get (&cells, s, sub);
+
+  if (!c)
+    {
+      c = calloc (1, sizeof (*c));
+      if (!c)
+	exit (EXIT_FAILURE);
+      c->next = all_cells;
+      all_cells = c;
+      ptrmap_put (&cells, s, sub, c);
+    }
+  return &c->value;
+}
+
+/* Compute the arguments from ARG on into the stack at BASE.  The
+   argument list is kept backwards, so the rest of the list is
+   computed first. */
+static void
+eval_args (ARGLIST *arg, size_t base, size_t i)
+{
+  long value;
+
+  if (!arg)
+    return;
+  eval_args (arg->next, base, i + 1);
+  value = eval (arg->node);
+  stack[base + i] = value;
+}
+
+static long
+call (NODE *node)
+{
+  SYMBOL *fnc = node->v.funcall.symbol;
+  ARGLIST *arg;
+  SYMLIST *param;
+  size_t base = sp, n = 0, i;
+
+  for (arg = node->v.funcall.args; arg; arg = arg->next)
+    n++;
+  if (sp + n > stack_size)
+    {
+      stack_size = stack_size ? stack_size * 2 + n : 256 + n;
+      stack = realloc (stack, stack_size * sizeof (*stack));
+      if (!stack)
+	exit (EXIT_FAILURE);
+    }
+  sp += n;
+  eval_args (node->v.funcall.args, base, 0);
+
+  if (++depth > MAX_DEPTH)
+    error ("calls nested too deep");
+  ncalls++;
+  /* The parameters are kept backwards too */
+  for (param = fnc->v.fnc->param, i = 0; param && i < n;
+       param = param->next, i++)
+    *cell (param->symbol) = stack[base + i];
+  sp = base;
+
+  /* Running off the end returns 0, not the value of a call made
+     on the way */
+  if (exec_list (fnc->v.fnc->entry_point) != EXEC_RETURN)
+    retval = 0;
+  depth--;
+  return retval;
+}
+
+static long
+eval (NODE *node)
+{
+  unsigned long l, r;
+
+  nexprs++;
+  switch (node->type) {
+  case NODE_CONST:
+    return node->v.number;
+  case NODE_VAR:
+    return *cell (node->v.symbol);
+  case NODE_EXPR:
+    nexprs--;
+    return eval (node->v.expr);
+  case NODE_CALL:
+    return call (node);
+  case NODE_UNOP:
+    l = eval (node->left);
+    if (node->v.opcode == OPCODE_NEG)
+      return -l;
+    return !l;
+  case NODE_BINOP:
+    if (node->v.opcode == OPCODE_AND)
+      return eval (node->left) ? eval (node->right) != 0 : 0;
+    if (node->v.opcode == OPCODE_OR)
+      return eval (node->left) ? 1 : eval (node->right) != 0;
+    l = eval (node->left);
+    r = eval (node->right);
+    switch (node->v.opcode) {
+    case OPCODE_ADD:
+      return l + r;
+    case OPCODE_SUB:
+      return l - r;
+    case OPCODE_MUL:
+      nmuls++;
+      return l * r;
+    case OPCODE_DIV:
+      nmuls++;
+      if (r == 0)
+	error ("division by zero");
+      if ((long) r == -1)
+	return -l;
+      return (long) l / (long) r;
+    case OPCODE_EQ:
+      return l == r;
+    case OPCODE_NE:
+      return l != r;
+    case OPCODE_LT:
+      return (long) l < (long) r;
+    case OPCODE_GT:
+      return (long) l > (long) r;
+    case OPCODE_LE:
+      return (long) l <= (long) r;
+    case OPCODE_GE:
+      return (long) l >= (long) r;
+    case OPCODE_MOD:
+      nmuls++;
+      if (r == 0)
+	error ("division by zero");
+      if ((long) r == -1)
+	return 0;
+      return (long) l % (long) r;
+    case OPCODE_SHL:
+      return l << (r & 63);
+    case OPCODE_SHR:
+      return (long) l >> (r & 63);
+    case OPCODE_BAND:
+      return l & r;
+    default:
+      break;
+    }
+    break;
+  default:
+    break;
+  }
+  error ("unknown expression");
+  return 0;
+}
+
+static enum exec_status
+exec (NODE *node)
+{
+  enum exec_status status;
+
+  nstmts++;
+  switch (node->type) {
+  case NODE_NOOP:
+  case NODE_FNC_DECL:
+    nstmts--;
+    return EXEC_NORMAL;
+  case NODE_CALL:
+    call (node);
+    return EXEC_NORMAL;
+  case NODE_EXPR:
+    eval (node->v.expr);
+    return EXEC_NORMAL;
+  case NODE_ASGN:
+    *cell (node->v.asgn.symbol) = eval (node->v.asgn.expr);
+    return EXEC_NORMAL;
+  case NODE_VAR_DECL:
+    *cell (node->v.vardecl.symbol) =
+      node->v.vardecl.expr ? eval (node->v.vardecl.expr) : 0;
+    return EXEC_NORMAL;
+  case NODE_PRINT:
+    printf ("%ld\n", eval (node->v.expr));
+    return EXEC_NORMAL;
+  case NODE_RETURN:
+    retval = node->v.expr ? eval (node->v.expr) : 0;
+    return EXEC_RETURN;
+  case NODE_JUMP:
+    jump_level = node->v.jump.level ? node->v.jump.level : 1;
+    if (node->v.jump.type == JUMP_BREAK)
+      return EXEC_BREAK;
+    return EXEC_CONTINUE;
+  case NODE_COMPOUND:
+    nstmts--;
+    return exec_list (node->v.expr);
+  case NODE_CONDITION:
+    if (eval (node->v.condition.cond))
+      return exec_list (node->v.condition.iftrue_stmt);
+    return exec_list (node->v.condition.iffalse_stmt);
+  case NODE_ITERATION:
+    while (eval (node->v.iteration.cond))
+      {
+	status = exec_list (node->v.iteration.stmt);
+	if (status == EXEC_RETURN)
+	  return status;
+	if (status != EXEC_NORMAL && --jump_level > 0)
+	  return status;
+	if (status == EXEC_BREAK)
+	  break;
+      }
+    return EXEC_NORMAL;
+  default:
+    error ("unknown statement");
+    return EXEC_NORMAL;
+  }
+}
+
+static enum exec_status
+exec_list (NODE *node)
+{
+  enum exec_status status;
+
+  for (; node; node = node->right)
+    if ((status = exec (node)) != EXEC_NORMAL)
+      return status;
+  return EXEC_NORMAL;
+}
+
+/* Run the program rooted at ROOT, printing what it prints and then
+   the work it took.  Returns 0, or 1 after a runtime error. */
+int
+interpret (NODE *root)
+{
+  int status = 0;
+
+  ptrmap_init (&cells);
+  depth = sp = 0;
+  nstmts = nexprs = nmuls = ncalls = nglobals = 0;
+
+  printf ("\n=== Program output ===\n\n");
+  if (setjmp (runtime_error) == 0)
+    exec_list (root);
+  else
+    status = 1;
+  printf ("\nRun: %lu statements, %lu expression nodes, "
+	  "%lu multiplications and divisions, %lu calls, "
+	  "%lu global accesses\n",
+	  nstmts, nexprs, nmuls, ncalls, nglobals);
+
+  while (all_cells)
+    {
+      struct cell *c = all_cells;
+      all_cells = c->next;
+      free (c);
+    }
+  ptrmap_free (&cells);
+  free (stack);
+  stack = NULL;
+  stack_size = 0;
+  return status;
+}
@@ -0,0 +1,466 @@
+/*
+   V5: ipa.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "ptrmap.h"
+#include "ipa.h"
+
+extern int verbose;
+
+/*
+  Interprocedural summaries.
+
+  The mod set of a function holds the variables that a call to it
+  may write: everything it assigns or declares other than its own
+  parameters and automatic variables, and the mod sets of the
+  functions it calls.  The ref set likewise holds the variables
+  other than its own that a call may read.  The sets are kept
+  sorted, and are grown over the call graph until nothing changes.
+
+  A function is pure when it writes nothing but its own variables,
+  reads nothing else, prints nothing and calls only pure functions:
+  two calls with the same arguments give the same result.  It is
+  also total when it always returns a value: it has no loops, no
+  division that may fail, and calls total functions only, none of
+  them recursively.  A call to it may then be made even where the
+  program would not make it.
+*/
+
+struct ipa_fn
+{
+  SYMBOL *symbol;
+  SYMBOL **callees;
+  size_t ncallees, callees_size;
+  size_t nmod_size, nref_size;
+  int impure;                      /* reads a non-local or prints */
+  int partial;                     /* loops or may divide by zero */
+};
+
+static struct ipa_fn *fns;
+static size_t nfns, fns_size;
+static struct ptrmap locals;       /* variable -> owning function */
+static struct ipa_fn *cur_fn;
+
+static int
+ptr_cmp (const void *a, const void *b)
+{
+  const void *x = *(const void * const *) a;
+  const void *y = *(const void * const *) b;
+
+  return x < y ? -1 : x > y;
+}
+
+/* Sort and drop the duplicates */
+static size_t
+sort_unique (SYMBOL **v, size_t n)
+{
+  size_t i, k = 0;
+
+  if (n == 0)
+    return 0;
+  qsort (v, n, sizeof (*v), ptr_cmp);
+  for (i = 0; i < n; i++)
+    if (k == 0 || v[k - 1] != v[i])
+      v[k++] = v[i];
+  return k;
+}
+
+/* Add S to the set SET of N variables, with room for SIZE */
+static void
+add_var (SYMBOL ***set, size_t *n, size_t *size, SYMBOL *s)
+{
+  if (*n == *size)
+    {
+      *size = *size ? *size * 2 : 8;
+      *set = xrealloc (*set, *size * sizeof (**set));
+    }
+  (*set)[(*n)++] = s;
+}
+
+static void
+add_mod (function_t *f, struct ipa_fn *info, SYMBOL *s)
+{
+  add_var (&f->mod, &f->nmod, &info->nmod_size, s);
+}
+
+static void
+add_ref (function_t *f, struct ipa_fn *info, SYMBOL *s)
+{
+  add_var (&f->ref, &f->nref, &info->nref_size, s);
+}
+
+static void
+note_write (SYMBOL *s)
+{
+  if (!cur_fn || !s)
+    return;
+  if (ptrmap_get (&locals, s, 0) != cur_fn->symbol)
+    add_mod (cur_fn->symbol->v.fnc, cur_fn, s);
+}
+
+static void
+note_read (NODE *node)
+{
+  if (cur_fn && ptrmap_get (&locals, node->v.symbol, 0) != cur_fn->symbol)
+    {
+      cur_fn->impure = 1;
+      add_ref (cur_fn->symbol->v.fnc, cur_fn, node->v.symbol);
+    }
+}
+
+static void
+note_binop (NODE *node)
+{
+  NODE *r = node->right->type == NODE_EXPR ? node->right->v.expr : node->right;
+
+  if (!cur_fn)
+    return;
+  if (node->v.opcode == OPCODE_DIV
+      && (r->type != NODE_CONST || r->v.number == 0 || r->v.number == -1))
+    cur_fn->partial = 1;
+  else if (node->v.opcode == OPCODE_MOD
+	   && (r->type != NODE_CONST || r->v.number == 0))
+    cur_fn->partial = 1;
+}
+
+static void
+note_call (NODE *node)
+{
+  struct ipa_fn *f = cur_fn;
+
+  if (!f)
+    return;
+  if (f->ncallees == f->callees_size)
+    {
+      f->callees_size = f->callees_size ? f->callees_size * 2 : 4;
+      f->callees = xrealloc (f->callees,
+			     f->callees_size * sizeof (*f->callees));
+    }
+  f->callees[f->ncallees++] = node->v.funcall.symbol;
+}
+
+traverse_fp ipa_call_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  note_binop,  /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  note_read,   /* NODE_VAR */
+  note_call,   /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+static void scan_list (NODE *);
+
+static void
+scan_function (NODE *node)
+{
+  size_t saved = cur_fn ? (size_t) (cur_fn - fns) + 1 : 0;
+  SYMBOL *s = node->v.fncdecl.symbol;
+  SYMLIST *p;
+
+  if (nfns == fns_size)
+    {
+      fns_size = fns_size ? fns_size * 2 : 16;
+      fns = xrealloc (fns, fns_size * sizeof (*fns));
+    }
+  cur_fn = &fns[nfns++];
+  cur_fn->symbol = s;
+  cur_fn->callees = NULL;
+  cur_fn->ncallees = cur_fn->callees_size = 0;
+  cur_fn->nmod_size = cur_fn->nref_size = 0;
+  cur_fn->impure = 0;
+  cur_fn->partial = 0;
+
+  for (p = s->v.fnc->param; p; p = p->next)
+    ptrmap_put (&locals, p->symbol, 0, s);
+  scan_list (node->v.fncdecl.stmt);
+
+  /* fns may have moved while scanning nested functions */
+  cur_fn = saved ? &fns[saved - 1] : NULL;
+}
+
+static void
+scan_stmt (NODE *node)
+{
+  ARGLIST *arg;
+
+  switch (node->type) {
+  case NODE_CALL:
+    note_call (node);
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      traverse_expr (arg->node, ipa_call_fptab);
+    break;
+  case NODE_ASGN:
+    traverse_expr (node->v.asgn.expr, ipa_call_fptab);
+    note_write (node->v.asgn.symbol);
+    break;
+  case NODE_VAR_DECL:
+    traverse_expr (node->v.vardecl.expr, ipa_call_fptab);
+    if (cur_fn && node->v.vardecl.symbol
+	&& node->v.vardecl.symbol->v.var->qualifier == QUA_AUTO)
+      ptrmap_put (&locals, node->v.vardecl.symbol, 0, cur_fn->symbol);
+    else
+      note_write (node->v.vardecl.symbol);
+    break;
+  case NODE_PRINT:
+    if (cur_fn)
+      cur_fn->impure = 1;
+    /* fall through */
+  case NODE_EXPR:
+  case NODE_RETURN:
+    traverse_expr (node->v.expr, ipa_call_fptab);
+    break;
+  case NODE_COMPOUND:
+    scan_list (node->v.expr);
+    break;
+  case NODE_ITERATION:
+    if (cur_fn)
+      cur_fn->partial = 1;
+    traverse_expr (node->v.iteration.cond, ipa_call_fptab);
+    scan_list (node->v.iteration.stmt);
+    break;
+  case NODE_CONDITION:
+    traverse_expr (node->v.condition.cond, ipa_call_fptab);
+    scan_list (node->v.condition.iftrue_stmt);
+    scan_list (node->v.condition.iffalse_stmt);
+    break;
+  case NODE_FNC_DECL:
+    scan_function (node);
+    break;
+  default:
+    break;
+  }
+}
+
+static void
+scan_list (NODE *node)
+{
+  for (; node; node = node->right)
+    scan_stmt (node);
+}
+
+/* Merge the sorted set SRC of N variables into the set SET of
+   *NSET; returns nonzero if it grew. */
+static int
+merge_vars (SYMBOL ***set, size_t *nset, size_t *size, SYMBOL **src,
+	    size_t n)
+{
+  size_t i, before = *nset;
+
+  for (i = 0; i < n; i++)
+    add_var (set, nset, size, src[i]);
+  if (*nset == before)
+    return 0;
+  *nset = sort_unique (*set, *nset);
+  return *nset != before;
+}
+
+void
+ipa_analyze (NODE *root)
+{
+  size_t i, j;
+  int changed;
+
+  ipa_free ();
+  scan_list (root);
+
+  for (i = 0; i < nfns; i++)
+    {
+      function_t *f = fns[i].symbol->v.fnc;
+      f->nmod = sort_unique (f->mod, f->nmod);
+      f->nref = sort_unique (f->ref, f->nref);
+      fns[i].ncallees = sort_unique (fns[i].callees, fns[i].ncallees);
+    }
+
+  do {
+    changed = 0;
+    for (i = 0; i < nfns; i++)
+      for (j = 0; j < fns[i].ncallees; j++)
+	{
+	  function_t *f = fns[i].symbol->v.fnc;
+	  function_t *g = fns[i].callees[j]->v.fnc;
+	  if (fns[i].callees[j] == fns[i].symbol)
+	    continue;
+	  if (merge_vars (&f->mod, &f->nmod, &fns[i].nmod_size,
+			  g->mod, g->nmod))
+	    changed = 1;
+	  if (merge_vars (&f->ref, &f->nref, &fns[i].nref_size,
+			  g->ref, g->nref))
+	    changed = 1;
+	}
+  } while (changed);
+
+  for (i = 0; i < nfns; i++)
+    fns[i].symbol->v.fnc->pure = !fns[i].impure
+      && fns[i].symbol->v.fnc->nmod == 0;
+  do {
+    changed = 0;
+    for (i = 0; i < nfns; i++)
+      for (j = 0; j < fns[i].ncallees; j++)
+	if (fns[i].symbol->v.fnc->pure && !fns[i].callees[j]->v.fnc->pure)
+	  {
+	    fns[i].symbol->v.fnc->pure = 0;
+	    changed = 1;
+	  }
+  } while (changed);
+
+  /* Totality grows from the leaves of the call graph, so that
+     recursion never makes it */
+  do {
+    changed = 0;
+    for (i = 0; i < nfns; i++)
+      {
+	function_t *f = fns[i].symbol->v.fnc;
+	if (f->total || !f->pure || fns[i].partial)
+	  continue;
+	for (j = 0; j < fns[i].ncallees; j++)
+	  if (fns[i].callees[j] == fns[i].symbol
+	      || !fns[i].callees[j]->v.fnc->total)
+	    break;
+	if (j == fns[i].ncallees)
+	  {
+	    f->total = 1;
+	    changed = 1;
+	  }
+      }
+  } while (changed);
+
+  if (verbose > 1)
+    for (i = 0; i < nfns; i++)
+      {
+	function_t *f = fns[i].symbol->v.fnc;
+	printf ("Function %s may write:", fns[i].symbol->name);
+	for (j = 0; j < f->nmod; j++)
+	  printf (" %s", f->mod[j]->name);
+	printf ("%s\n", f->total ? " (pure, total)"
+		: f->pure ? " (pure)" : "");
+	printf ("Function %s may read:", fns[i].symbol->name);
+	for (j = 0; j < f->nref; j++)
+	  printf (" %s", f->ref[j]->name);
+	printf ("\n");
+      }
+}
+
+void
+ipa_free (void)
+{
+  size_t i;
+
+  for (i = 0; i < nfns; i++)
+    {
+      function_t *f = fns[i].symbol->v.fnc;
+      free (fns[i].callees);
+      free (f->mod);
+      f->mod = NULL;
+      f->nmod = 0;
+      free (f->ref);
+      f->ref = NULL;
+      f->nref = 0;
+      f->pure = 0;
+      f->total = 0;
+    }
+  free (fns);
+  fns = NULL;
+  nfns = fns_size = 0;
+  ptrmap_free (&locals);
+}
+
+/* Does the sorted set SET of N variables hold S? */
+static int
+has_var (SYMBOL **set, size_t n, SYMBOL *s)
+{
+  size_t lo = 0, hi = n;
+
+  while (lo < hi)
+    {
+      size_t mid = (lo + hi) / 2;
+      if (set[mid] == s)
+	return 1;
+      if ((void *) set[mid] < (void *) s)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  return 0;
+}
+
+/* Can a call to FNC change the value of the variable S? */
+int
+ipa_may_write (SYMBOL *fnc, SYMBOL *s)
+{
+  return has_var (fnc->v.fnc->mod, fnc->v.fnc->nmod, s);
+}
+
+/* Can a call to FNC read the variable S? */
+int
+ipa_may_read (SYMBOL *fnc, SYMBOL *s)
+{
+  return has_var (fnc->v.fnc->ref, fnc->v.fnc->nref, s);
+}
+
+/* Can computing the expression NODE fail, or do more than give its
+   value?  It can when it divides by anything but a nonzero constant,
+   or calls a function that is not total. */
+int
+ipa_may_fail (NODE *node)
+{
+  NODE *r;
+  ARGLIST *arg;
+
+  if (!node)
+    return 0;
+  switch (node->type) {
+  case NODE_EXPR:
+    return ipa_may_fail (node->v.expr);
+  case NODE_UNOP:
+    return ipa_may_fail (node->left);
+  case NODE_CONST:
+  case NODE_VAR:
+    return 0;
+  case NODE_BINOP:
+    r = strip (node->right);
+    if ((node->v.opcode == OPCODE_DIV || node->v.opcode == OPCODE_MOD)
+	&& !node->safe_div
+	&& (r->type != NODE_CONST || r->v.number == 0))
+      return 1;
+    return ipa_may_fail (node->left) || ipa_may_fail (node->right);
+  case NODE_CALL:
+    if (!node->v.funcall.symbol->v.fnc->total)
+      return 1;
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      if (ipa_may_fail (arg->node))
+	return 1;
+    return 0;
+  default:
+    return 1;
+  }
+}
@@ -0,0 +1,31 @@
+/*
+   V5: ipa.h
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _IPA_H
+#define _IPA_H
+
+#include "tree.h"
+
+void ipa_analyze (NODE *);
+void ipa_free (void);
+int ipa_may_write (SYMBOL *, SYMBOL *);
+int ipa_may_read (SYMBOL *, SYMBOL *);
+int ipa_may_fail (NODE *);
+
+#endif /* not _IPA_H */
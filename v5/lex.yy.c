@@ -0,0 +1,69 @@
+/* Local stand-in for the flex-generated scanner (flex unavailable). */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "tree.h"
+#include "mm.h"
+#include "gram.tab.h"
+size_t input_line_num;
+FILE *yyin;
+static char yytext_buf[1024];
+char *yytext = yytext_buf;
+extern int yyerror (const char *s);
+static int getch (void) { return getc (yyin ? yyin : stdin); }
+static void ungetch (int c) { ungetc (c, yyin ? yyin : stdin); }
+static struct { const char *k; int t; } kw[] = {
+ {"auto",AUTO},{"break",BREAK},{"continue",CONTINUE},{"else",ELSE},
+ {"function",FUNCTION},{"global",GLOBAL},{"if",IF},{"print",PRINT},
+ {"return",RETURN},{"while",WHILE},{0,0}};
+int yylex (void)
+{
+  int c, i;
+ again:
+  c = getch ();
+  if (c == EOF) return 0;
+  if (c == '\n') { input_line_num++; goto again; }
+  if (c == ' ' || c == '\t' || c == '\r') goto again;
+  if (isalpha (c) || c == '_') {
+    i = 0;
+    while (isalnum (c) || c == '_') { yytext[i++] = c; c = getch (); }
+    ungetch (c); yytext[i] = 0;
+    for (i = 0; kw[i].k; i++) if (!strcmp (kw[i].k, yytext)) return kw[i].t;
+    yylval.string = mm_strdup (yytext); return ID;
+  }
+  if (isdigit (c)) {
+    i = 0;
+    while (isdigit (c)) { yytext[i++] = c; c = getch (); }
+    ungetch (c); yytext[i] = 0;
+    yylval.number = atoi (yytext); return NUMBER;
+  }
+  yytext[0] = c; yytext[1] = 0;
+  if (c == '/') {
+    int d = getch ();
+    if (d == '*') { int p = 0; while ((c = getch ()) != EOF) { if (c == '\n') input_line_num++; if (p == '*' && c == '/') break; p = c; } goto again; }
+    if (d == '/') { while ((c = getch ()) != EOF && c != '\n'); input_line_num++; goto again; }
+    ungetch (d); return '/';
+  }
+  {
+    int d = getch ();
+    yytext[1] = d; yytext[2] = 0;
+    if (c == '<' && d == '=') return LE_OP;
+    if (c == '>' && d == '=') return GE_OP;
+    if (c == '=' && d == '=') return EQ_OP;
+    if (c == '!' && d == '=') return NE_OP;
+    if (c == '&' && d == '&') return AND_OP;
+    if (c == '|' && d == '|') return OR_OP;
+    ungetch (d); yytext[1] = 0;
+    if (c == '<') return LT_OP;
+    if (c == '>') return GT_OP;
+  }
+  if (strchr ("(){},;+-*/%=!", c)) return c;
+  yyerror ("stray character");
+  goto again;
+}
+void open_file (char *filename)
+{
+  yyin = fopen (filename, "r");
+  if (!yyin) { fprintf (stderr, "Cannot open file "); perror (filename); exit (EXIT_FAILURE); }
+}
@@ -0,0 +1,281 @@
+/*
+   V5: licm.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "cfg.h"
+#include "ssa.h"
+#include "ipa.h"
+#include "motion.h"
+#include "licm.h"
+
+extern int verbose;
+
+/*
+  Loop-invariant code motion.
+
+  An expression inside a loop is invariant when all the values it
+  reads are defined outside the loop: the SSA value of each of its
+  variables comes from before the loop, and it only calls pure
+  functions.  A call with side effects in the loop defines a new
+  value of each variable it may write, and a break or continue of
+  any level is an edge of the control flow graph, so both are seen
+  by the SSA form already.
+
+  The invariant expression is stored to a temporary declared before
+  the `while' statement, its pre-header, and read from there.  It is
+  then computed even when the loop would not compute it, so it must
+  not fail: it may only divide by a nonzero constant and only call
+  total functions.  Any other invariant expression is only moved out
+  of the loop condition, which is computed whenever the loop starts.
+
+  The expression goes to the outermost loop it is invariant in.
+*/
+
+static struct ssa *ssa;
+static struct cfg *graph;
+static struct cfg_loop **chain;    /* loops around a site, outer first */
+static size_t chain_size;
+static int has_side_effects;       /* the site calls an impure function */
+static size_t nhoisted;
+
+/* Are all the values NODE reads defined outside the loop L? */
+static int
+invariant (NODE *node, struct cfg_loop *l)
+{
+  struct ssa_value *v;
+  ARGLIST *arg;
+
+  node = strip (node);
+  switch (node->type) {
+  case NODE_CONST:
+    return 1;
+  case NODE_VAR:
+    v = ssa_use_value (ssa, node);
+    return v && (!v->block || !cfg_in_loop (l, v->block));
+  case NODE_UNOP:
+    return invariant (node->left, l);
+  case NODE_BINOP:
+    return invariant (node->left, l) && invariant (node->right, l);
+  case NODE_CALL:
+    if (!node->v.funcall.symbol->v.fnc->pure)
+      return 0;
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      if (!invariant (arg->node, l))
+	return 0;
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/* Can NODE be computed anywhere, without failing? */
+static int
+safe (NODE *node)
+{
+  NODE *r;
+  ARGLIST *arg;
+
+  node = strip (node);
+  switch (node->type) {
+  case NODE_CONST:
+  case NODE_VAR:
+    return 1;
+  case NODE_UNOP:
+    return safe (node->left);
+  case NODE_BINOP:
+    r = strip (node->right);
+    if (node->v.opcode == OPCODE_DIV
+	&& (r->type != NODE_CONST || r->v.number == 0 || r->v.number == -1))
+      return 0;
+    if (node->v.opcode == OPCODE_MOD
+	&& (r->type != NODE_CONST || r->v.number == 0))
+      return 0;
+    return safe (node->left) && safe (node->right);
+  case NODE_CALL:
+    if (!node->v.funcall.symbol->v.fnc->total)
+      return 0;
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      if (!safe (arg->node))
+	return 0;
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/* Move the invariant parts of NODE out of the N loops of the chain.
+   COND_LOOP is the loop whose condition is NODE, if it is computed
+   there whenever the condition is. */
+static void
+hoist_expr (NODE *node, size_t n, struct cfg_loop *cond_loop)
+{
+  struct cfg_loop *l;
+  NODE *decl;
+  ARGLIST *arg;
+  size_t k;
+
+  node = strip (node);
+  if (node->type != NODE_UNOP && node->type != NODE_BINOP
+      && node->type != NODE_CALL)
+    return;
+
+  for (k = 0; k < n; k++)
+    {
+      l = chain[k];
+      if (!invariant (node, l) || (l != cond_loop && !safe (node)))
+	continue;
+      if (verbose > 1)
+	printf ("Hoisting node %4.4lu out of the loop at node %4.4lu\n",
+		node->node_id, l->header->branch->node_id);
+      decl = motion_save (node, l->header->branch, graph->function ? 1 : 0);
+      nhoisted++;
+      /* It may still be invariant in the loops around */
+      hoist_expr (decl->v.vardecl.expr, k, NULL);
+      return;
+    }
+
+  switch (node->type) {
+  case NODE_UNOP:
+    hoist_expr (node->left, n, cond_loop);
+    break;
+  case NODE_BINOP:
+    hoist_expr (node->left, n, cond_loop);
+    /* The right operand of && and || may not be computed */
+    hoist_expr (node->right, n,
+		node->v.opcode == OPCODE_AND || node->v.opcode == OPCODE_OR
+		? NULL : cond_loop);
+    break;
+  default:
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      hoist_expr (arg->node, n, cond_loop);
+    break;
+  }
+}
+
+static void
+note_call (NODE *node)
+{
+  if (!node->v.funcall.symbol->v.fnc->pure)
+    has_side_effects = 1;
+}
+
+traverse_fp licm_call_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  NULL,        /* NODE_VAR */
+  note_call,   /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+static void
+hoist_site (struct ssa_site *site)
+{
+  struct cfg_loop *l, *cond_loop = NULL;
+  NODE *stmt = site->stmt;
+  ARGLIST *arg;
+  size_t n = 0, i;
+
+  for (l = site->block->loop; l; l = l->parent)
+    {
+      if (n == chain_size)
+	{
+	  chain_size = chain_size ? chain_size * 2 : 8;
+	  chain = xrealloc (chain, chain_size * sizeof (*chain));
+	}
+      chain[n++] = l;
+    }
+  if (n == 0)
+    return;
+  for (i = 0; i < n / 2; i++)
+    {
+      l = chain[i];
+      chain[i] = chain[n - 1 - i];
+      chain[n - 1 - i] = l;
+    }
+
+  if (site->expr)
+    {
+      has_side_effects = 0;
+      traverse_expr (site->expr->v.expr, licm_call_fptab);
+      if (site->is_branch && stmt->type == NODE_ITERATION
+	  && site->block->loop && site->block->loop->header == site->block
+	  && !has_side_effects)
+	cond_loop = site->block->loop;
+      hoist_expr (site->expr->v.expr, n, cond_loop);
+    }
+  else if (stmt->type == NODE_CALL)
+    for (arg = stmt->v.funcall.args; arg; arg = arg->next)
+      hoist_expr (arg->node, n, NULL);
+}
+
+/* Move the loop invariants of the program rooted at *ROOTP to the
+   pre-headers.  Returns the number of expressions moved. */
+size_t
+licm_run (NODE **rootp)
+{
+  struct cfg *graphs, *g;
+  size_t i, j;
+
+  nhoisted = 0;
+  ipa_analyze (*rootp);
+  motion_begin (rootp);
+  graphs = cfg_build (*rootp);
+  for (g = graphs; g; g = g->next)
+    {
+      if (g->nloops == 0)
+	continue;
+      graph = g;
+      ssa = ssa_build (g);
+      for (i = 0; i < g->nrpo; i++)
+	{
+	  struct ssa_block *sb = &ssa->blocks[g->rpo[i]->index];
+	  for (j = 0; j < sb->nsites; j++)
+	    hoist_site (sb->sites[j]);
+	}
+      ssa_free (ssa);
+      ssa = NULL;
+    }
+  cfg_free (graphs);
+  motion_end ();
+  ipa_free ();
+
+  free (chain);
+  chain = NULL;
+  chain_size = 0;
+
+  if (verbose > 1)
+    printf ("Loop invariants: %lu expressions hoisted\n",
+	    (unsigned long) nhoisted);
+  return nhoisted;
+}
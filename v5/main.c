@@ -21,10 +21,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <getopt.h>
 
 #include "symbol.h"
 #include "tree.h"
+#include "mm.h"
 #include "optimize.h"
+#include "egraph.h"
+#include "interp.h"
 
 extern int parse (void);
 extern void open_file (char *);
@@ -33,12 +37,155 @@ int verbose;
 int errcnt;             /* general error counter */
 int optimize_level = 2; /* optimization level */
 
+static int mem_stats;          /* print memory statistics */
+static char *mem_stats_file;   /* dump memory statistics to this file */
+static int show_offsets;       /* print data offsets in the final tree */
+static int run_program;        /* run the final tree */
+static int pass_stats;         /* print optimizer pass statistics */
+static int explicit_passes;    /* -fpasses= given, run at any level */
+
+enum {
+  OPT_MEM_STATS = 256,
+  OPT_MEM_STATS_DUMP,
+  OPT_RUN
+};
+
+static struct option long_options[] = {
+  { "mem-stats",      no_argument,       NULL, OPT_MEM_STATS },
+  { "mem-stats-dump", required_argument, NULL, OPT_MEM_STATS_DUMP },
+  { "run",            no_argument,       NULL, OPT_RUN },
+  { NULL, 0, NULL, 0 }
+};
+
+/* Handle -fFLAG.  Returns 0 on success. */
+static int
+set_flag (const char *flag)
+{
+  if (strcmp (flag, "share-slots") == 0)
+    frame_layout = FRAME_SHARE_SLOTS;
+  else if (strcmp (flag, "data-layout=decl") == 0)
+    data_layout = DATA_DECL;
+  else if (strcmp (flag, "data-layout=refs") == 0)
+    data_layout = DATA_REFS;
+  else if (strcmp (flag, "data-layout=loops") == 0)
+    data_layout = DATA_LOOPS;
+  else if (strncmp (flag, "data-profile=", 13) == 0 && flag[13])
+    {
+      data_layout = DATA_PROFILE;
+      data_profile = flag + 13;
+    }
+  else if (strcmp (flag, "worklist") == 0)
+    optimize_worklist = 1;
+  else if (strcmp (flag, "no-worklist") == 0)
+    optimize_worklist = 0;
+  else if (strcmp (flag, "sccp") == 0)
+    optimize_sccp = 1;
+  else if (strcmp (flag, "no-sccp") == 0)
+    optimize_sccp = 0;
+  else if (strcmp (flag, "dce") == 0)
+    optimize_dce = 1;
+  else if (strcmp (flag, "no-dce") == 0)
+    optimize_dce = 0;
+  else if (strcmp (flag, "gvn") == 0)
+    optimize_gvn = 1;
+  else if (strcmp (flag, "no-gvn") == 0)
+    optimize_gvn = 0;
+  else if (strcmp (flag, "licm") == 0)
+    optimize_licm = 1;
+  else if (strcmp (flag, "no-licm") == 0)
+    optimize_licm = 0;
+  else if (strcmp (flag, "strength-reduce") == 0)
+    optimize_strength = 1;
+  else if (strcmp (flag, "no-strength-reduce") == 0)
+    optimize_strength = 0;
+  else if (strcmp (flag, "inline") == 0)
+    optimize_inline = 1;
+  else if (strcmp (flag, "no-inline") == 0)
+    optimize_inline = 0;
+  else if (strcmp (flag, "tailrec") == 0)
+    optimize_tailrec = 1;
+  else if (strcmp (flag, "no-tailrec") == 0)
+    optimize_tailrec = 0;
+  else if (strcmp (flag, "ceval") == 0)
+    optimize_ceval = 1;
+  else if (strcmp (flag, "no-ceval") == 0)
+    optimize_ceval = 0;
+  else if (strcmp (flag, "egraph") == 0)
+    optimize_egraph = 1;
+  else if (strcmp (flag, "no-egraph") == 0)
+    optimize_egraph = 0;
+  else if (strcmp (flag, "reassoc") == 0)
+    optimize_reassoc = 1;
+  else if (strcmp (flag, "no-reassoc") == 0)
+    optimize_reassoc = 0;
+  else if (strcmp (flag, "vra") == 0)
+    optimize_vra = 1;
+  else if (strcmp (flag, "no-vra") == 0)
+    optimize_vra = 0;
+  else if (strcmp (flag, "unroll") == 0)
+    optimize_unroll = 1;
+  else if (strcmp (flag, "no-unroll") == 0)
+    optimize_unroll = 0;
+  else if (strcmp (flag, "dse") == 0)
+    optimize_dse = 1;
+  else if (strcmp (flag, "no-dse") == 0)
+    optimize_dse = 0;
+  else if (strcmp (flag, "promote") == 0)
+    optimize_promote = 1;
+  else if (strcmp (flag, "no-promote") == 0)
+    optimize_promote = 0;
+  else if (strcmp (flag, "egraph-cost=size") == 0)
+    egraph_cost = egraph_cost_size;
+  else if (strcmp (flag, "egraph-cost=speed") == 0)
+    egraph_cost = egraph_cost_speed;
+  else if (strncmp (flag, "egraph-time=", 12) == 0)
+    {
+      char *end;
+      egraph_msec = strtol (flag + 12, &end, 10);
+      if (end == flag + 12 || *end || egraph_msec < 0)
+	return 1;
+    }
+  else if (strncmp (flag, "passes=", 7) == 0)
+    {
+      explicit_passes = 1;
+      return optimize_set_pipeline (flag + 7);
+    }
+  else if (strcmp (flag, "pass-stats") == 0)
+    pass_stats = 1;
+  else if (strcmp (flag, "print-offsets") == 0)
+    show_offsets = 1;
+  else
+    return 1;
+  return 0;
+}
+
+static void
+report_mem_stats (void)
+{
+  if (mem_stats)
+    mm_print_stats (stdout);
+
+  if (mem_stats_file)
+    {
+      FILE *fp = fopen (mem_stats_file, "w");
+      if (!fp)
+	{
+	  perror (mem_stats_file);
+	  return;
+	}
+      mm_dump_stats (fp);
+      fclose (fp);
+    }
+}
+
 int
 main (int argc, char *argv[])
 {
   int status;
+  int run_status = 0;
 
-  while ((status = getopt (argc, argv, "vO:")) != EOF)
+  while ((status = getopt_long (argc, argv, "vO:f:", long_options, NULL))
+	 != EOF)
   {
     switch (status) {
     case 'v':
@@ -48,6 +195,26 @@ main (int argc, char *argv[])
     case 'O':
       optimize_level = atoi (optarg);
       break;
+
+    case 'f':
+      if (set_flag (optarg))
+	{
+	  fprintf (stderr, "%s: unknown option -f%s\n", argv[0], optarg);
+	  return 1;
+	}
+      break;
+
+    case OPT_MEM_STATS:
+      mem_stats = 1;
+      break;
+
+    case OPT_MEM_STATS_DUMP:
+      mem_stats_file = optarg;
+      break;
+
+    case OPT_RUN:
+      run_program = 1;
+      break;
     }
   }
 
@@ -64,23 +231,35 @@ main (int argc, char *argv[])
 
   if (status == 0 && errcnt == 0)
     {
+      /* Without optimization the parse tree is the final one. */
+      if (optimize_level <= 0 && !explicit_passes)
+	{
+	  compute_stack_and_data ();
+	  print_offsets = show_offsets;
+	}
       if (verbose)
 	{
 	  printf ("=== The input parse tree (%d nodes) ===\n\n",
 		  nodes_counter);
 	  print_node (root);
 	}
-      if (optimize_level > 0)
+      if (optimize_level > 0 || explicit_passes)
 	{
 	  optimize_tree (root);
+	  compute_stack_and_data ();
+	  print_offsets = show_offsets;
 	  printf ("\n=== After optimization (%d nodes) ===\n\n",
 		  nodes_counter);
 	  print_node (root);
 	}
+      if (pass_stats)
+	optimize_print_stats (stdout);
     }
+  else
+    compute_stack_and_data ();
 
-  compute_stack_and_data ();
-  print_offsets = 1;
+  if (run_program && status == 0 && errcnt == 0)
+    run_status = interpret (root);
 
   free_all_nodes ();
 
@@ -93,25 +272,26 @@ main (int argc, char *argv[])
 	{
 	  printf ("* Functions:\n");
 	  print_all_symbols (symbol_functions);
-	  free_all_symbols (&symbol_functions);
 	}
       if (symbol_variables)
 	{
 	  printf ("* Variables (present):\n");
 	  print_all_symbols (symbol_variables);
-	  free_all_symbols (&symbol_variables);
 	}
       if (symbol_history)
 	{
 	  printf ("* Variables (past):\n");
 	  print_all_symbols (symbol_history);
-	  free_all_symbols (&symbol_history);
 	}
     }
 
+  free_all_symbols ();
+
   if (errcnt)
     status = 1;
   printf ("\nCompilation: %s\n", status ? "Failed" : "Passed");
-  return status;
+
+  report_mem_stats ();
+  return status ? status : run_status;
 }
 
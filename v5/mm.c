@@ -19,19 +19,25 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "tree.h"
+#include "mm.h"
 
 NODE *memory_pool;
 NODE *free_memory_pool;
 NODE *tmp_memory_pool;
+unsigned long nodes_freed;
 
 extern int verbose;
 
 void
 mpool_append (NODE **head, NODE *p)
 {
+  p->memory_prev = NULL;
   p->memory_link = *head;
+  if (*head)
+    (*head)->memory_prev = p;
   *head = p;
 }
 
@@ -39,26 +45,15 @@ mpool_append (NODE **head, NODE *p)
 void
 mpool_remove (NODE **head, NODE *r)
 {
-  NODE *p, *prev = NULL;
-
-  if (!*head)
+  if (r->memory_prev)
+    r->memory_prev->memory_link = r->memory_link;
+  else if (*head == r)
+    *head = r->memory_link;
+  else
     return;
-
-  p = *head;
-  while (p)
-    {
-      NODE *next = p->memory_link;
-      if (p == r)
-	{
-	  if (!prev)
-	    *head = next;
-	  else
-	    prev->memory_link = next;
-	}
-      else
-	prev = p;
-      p = next;
-    }
+  if (r->memory_link)
+    r->memory_link->memory_prev = r->memory_prev;
+  r->memory_prev = r->memory_link = NULL;
 }
 
 
@@ -106,7 +101,9 @@ sweep (NODE *new_pool)
   for (p = memory_pool; p; p = next)
     {
       next = p->memory_link;
+      du_unlink (p);
       mpool_append (&free_memory_pool, p);
+      mm_count_free (p);
 
       nodes_counter--;
       if (verbose > 1)
@@ -116,3 +113,266 @@ sweep (NODE *new_pool)
   memory_pool = new_pool;
 }
 
+
+
+/* Memory statistics */
+
+#define NODE_KINDS (NODE_FNC_DECL + 1)
+#define MAX_PASSES 32
+
+struct node_stats
+{
+  unsigned long alloc;     /* obtained from malloc */
+  unsigned long recycled;  /* taken from free_memory_pool */
+  unsigned long freed;     /* returned to free_memory_pool */
+};
+
+struct mem_stats
+{
+  unsigned long live;      /* blocks currently allocated */
+  unsigned long total;     /* blocks allocated so far */
+  size_t bytes;            /* bytes currently allocated */
+  size_t peak;             /* the highest value of bytes */
+};
+
+static const char *node_kind_names[NODE_KINDS] = {
+  "NODE_NOOP",
+  "NODE_UNOP",
+  "NODE_BINOP",
+  "NODE_CONST",
+  "NODE_VAR",
+  "NODE_CALL",
+  "NODE_ASGN",
+  "NODE_EXPR",
+  "NODE_RETURN",
+  "NODE_PRINT",
+  "NODE_JUMP",
+  "NODE_COMPOUND",
+  "NODE_ITERATION",
+  "NODE_CONDITION",
+  "NODE_VAR_DECL",
+  "NODE_FNC_DECL"
+};
+
+static const char *mem_kind_names[MEM_KINDS] = {
+  "NODE",
+  "SYMBOL",
+  "ARGLIST",
+  "SYMLIST",
+  "STRING"
+};
+
+static struct node_stats kind_stats[NODE_KINDS];
+static struct {
+  const char *name;
+  struct node_stats st;
+} pass_stats[MAX_PASSES];
+static int npasses;
+static int current_pass = -1;
+
+static struct mem_stats mem_stats[MEM_KINDS];
+static struct mem_stats mem_total;
+
+static void
+account_alloc (struct mem_stats *m, size_t size)
+{
+  m->live++;
+  m->total++;
+  m->bytes += size;
+  if (m->bytes > m->peak)
+    m->peak = m->bytes;
+}
+
+static void
+account_free (struct mem_stats *m, size_t size)
+{
+  m->live--;
+  m->bytes -= size;
+}
+
+void *
+mm_alloc (enum mem_kind kind, size_t size)
+{
+  void *p = malloc (size);
+  if (!p)
+    exit (EXIT_FAILURE);
+
+  account_alloc (&mem_stats[kind], size);
+  account_alloc (&mem_total, size);
+  return p;
+}
+
+void
+mm_free (enum mem_kind kind, void *p, size_t size)
+{
+  if (!p)
+    return;
+
+  account_free (&mem_stats[kind], size);
+  account_free (&mem_total, size);
+  free (p);
+}
+
+char *
+mm_strdup (const char *str)
+{
+  size_t size = strlen (str) + 1;
+  char *p = mm_alloc (MEM_STRING, size);
+  memcpy (p, str, size);
+  return p;
+}
+
+void
+mm_free_string (char *str)
+{
+  if (str)
+    mm_free (MEM_STRING, str, strlen (str) + 1);
+}
+
+/* Grow the working arrays of the passes; not counted by the
+   statistics */
+void *
+xrealloc (void *p, size_t size)
+{
+  p = realloc (p, size);
+  if (!p)
+    exit (EXIT_FAILURE);
+  return p;
+}
+
+/* Node counters are kept per optimizer pass.  NAME must have
+   static storage; passes of the same name share one slot. */
+
+void
+mm_set_pass (const char *name)
+{
+  int i;
+
+  for (i = 0; i < npasses; i++)
+    if (strcmp (pass_stats[i].name, name) == 0)
+      {
+	current_pass = i;
+	return;
+      }
+  if (npasses == MAX_PASSES)
+    {
+      current_pass = MAX_PASSES - 1;
+      return;
+    }
+  pass_stats[npasses].name = name;
+  current_pass = npasses++;
+}
+
+static struct node_stats *
+pass_slot (void)
+{
+  if (current_pass < 0)
+    mm_set_pass ("parse");
+  return &pass_stats[current_pass].st;
+}
+
+void
+mm_count_alloc (NODE *node, int recycled)
+{
+  if (recycled)
+    {
+      kind_stats[node->type].recycled++;
+      pass_slot ()->recycled++;
+    }
+  else
+    {
+      kind_stats[node->type].alloc++;
+      pass_slot ()->alloc++;
+    }
+}
+
+/* Nodes are counted by their type at the time they are freed,
+   which may differ from the type they were created with. */
+
+void
+mm_count_free (NODE *node)
+{
+  kind_stats[node->type].freed++;
+  pass_slot ()->freed++;
+  nodes_freed++;
+}
+
+static void
+print_node_stats (FILE *fp, const char *name, struct node_stats *st)
+{
+  fprintf (fp, "%-16s %10lu %10lu %10lu\n",
+	   name, st->alloc, st->recycled, st->freed);
+}
+
+static void
+print_mem_stats (FILE *fp, const char *name, struct mem_stats *m)
+{
+  fprintf (fp, "%-16s %10lu %10lu %10lu %10lu\n", name, m->live, m->total,
+	   (unsigned long) m->bytes, (unsigned long) m->peak);
+}
+
+void
+mm_print_stats (FILE *fp)
+{
+  struct node_stats sum;
+  int i;
+
+  fprintf (fp, "\n=== Memory statistics ===\n\n");
+
+  memset (&sum, 0, sizeof (sum));
+  fprintf (fp, "%-16s %10s %10s %10s\n",
+	   "Node kind", "alloc", "recycled", "freed");
+  for (i = 0; i < NODE_KINDS; i++)
+    {
+      print_node_stats (fp, node_kind_names[i], &kind_stats[i]);
+      sum.alloc += kind_stats[i].alloc;
+      sum.recycled += kind_stats[i].recycled;
+      sum.freed += kind_stats[i].freed;
+    }
+  print_node_stats (fp, "Total", &sum);
+
+  fprintf (fp, "\n%-16s %10s %10s %10s\n",
+	   "Pass", "alloc", "recycled", "freed");
+  for (i = 0; i < npasses; i++)
+    print_node_stats (fp, pass_stats[i].name, &pass_stats[i].st);
+
+  fprintf (fp, "\n%-16s %10s %10s %10s %10s\n",
+	   "Memory", "live", "total", "bytes", "peak");
+  for (i = 0; i < MEM_KINDS; i++)
+    print_mem_stats (fp, mem_kind_names[i], &mem_stats[i]);
+  print_mem_stats (fp, "Total", &mem_total);
+}
+
+/* Machine-readable form: one `key value' pair per line */
+
+static void
+dump_node_stats (FILE *fp, const char *prefix, const char *name,
+		 struct node_stats *st)
+{
+  fprintf (fp, "%s.%s.alloc %lu\n", prefix, name, st->alloc);
+  fprintf (fp, "%s.%s.recycled %lu\n", prefix, name, st->recycled);
+  fprintf (fp, "%s.%s.freed %lu\n", prefix, name, st->freed);
+}
+
+static void
+dump_mem_stats (FILE *fp, const char *name, struct mem_stats *m)
+{
+  fprintf (fp, "mem.%s.live %lu\n", name, m->live);
+  fprintf (fp, "mem.%s.total %lu\n", name, m->total);
+  fprintf (fp, "mem.%s.bytes %lu\n", name, (unsigned long) m->bytes);
+  fprintf (fp, "mem.%s.peak %lu\n", name, (unsigned long) m->peak);
+}
+
+void
+mm_dump_stats (FILE *fp)
+{
+  int i;
+
+  for (i = 0; i < NODE_KINDS; i++)
+    dump_node_stats (fp, "node", node_kind_names[i], &kind_stats[i]);
+  for (i = 0; i < npasses; i++)
+    dump_node_stats (fp, "pass", pass_stats[i].name, &pass_stats[i].st);
+  for (i = 0; i < MEM_KINDS; i++)
+    dump_mem_stats (fp, mem_kind_names[i], &mem_stats[i]);
+  dump_mem_stats (fp, "total", &mem_total);
+}
@@ -20,9 +20,23 @@
 #ifndef _MM_H
 #define _MM_H
 
+#include <stdio.h>
+
+/* Memory categories tracked by the statistics */
+enum mem_kind
+{
+  MEM_NODE,      /* NODE */
+  MEM_SYMBOL,    /* SYMBOL and its variable_t/function_t */
+  MEM_ARGLIST,   /* ARGLIST */
+  MEM_SYMLIST,   /* SYMLIST */
+  MEM_STRING,    /* identifier strings */
+  MEM_KINDS
+};
+
 extern NODE *memory_pool;
 extern NODE *free_memory_pool;
 extern NODE *tmp_memory_pool;
+extern unsigned long nodes_freed;   /* nodes freed so far */
 
 void mpool_append (NODE **, NODE *);
 void mpool_remove (NODE **, NODE *);
@@ -31,5 +45,17 @@ NODE *mark_free (NODE *);
 void mark_node (NODE *);
 void sweep (NODE *);
 
+void *mm_alloc (enum mem_kind, size_t);
+void mm_free (enum mem_kind, void *, size_t);
+char *mm_strdup (const char *);
+void mm_free_string (char *);
+void *xrealloc (void *, size_t);
+
+void mm_set_pass (const char *);
+void mm_count_alloc (NODE *, int);
+void mm_count_free (NODE *);
+void mm_print_stats (FILE *);
+void mm_dump_stats (FILE *);
+
 #endif /* not _MM_H */
 
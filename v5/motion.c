@@ -0,0 +1,165 @@
+/*
+   V5: motion.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "ptrmap.h"
+#include "optimize.h"
+#include "motion.h"
+
+/*
+  Code motion.
+
+  The passes that move an expression out of its statement store it
+  to a compiler temporary, declared by a new statement in front of
+  another one.  To insert a statement anywhere, every statement of
+  the program is mapped to the link pointing to it, between
+  motion_begin and motion_end.
+*/
+
+static struct ptrmap links;       /* statement -> link pointing to it */
+static struct ptrmap bodies;      /* link to a body -> its function */
+
+static void link_list (NODE **);
+
+static void
+link_stmt (NODE *node)
+{
+  switch (node->type) {
+  case NODE_COMPOUND:
+    link_list (&node->v.expr);
+    break;
+  case NODE_ITERATION:
+    link_list (&node->v.iteration.stmt);
+    break;
+  case NODE_CONDITION:
+    link_list (&node->v.condition.iftrue_stmt);
+    link_list (&node->v.condition.iffalse_stmt);
+    break;
+  case NODE_FNC_DECL:
+    ptrmap_put (&bodies, &node->v.fncdecl.stmt, 0, node);
+    link_list (&node->v.fncdecl.stmt);
+    break;
+  default:
+    break;
+  }
+}
+
+static void
+link_list (NODE **link)
+{
+  for (; *link; link = &(*link)->right)
+    {
+      ptrmap_put (&links, *link, 0, link);
+      link_stmt (*link);
+    }
+}
+
+/* Map the statements of the program rooted at *ROOTP */
+void
+motion_begin (NODE **rootp)
+{
+  link_list (rootp);
+}
+
+void
+motion_end (void)
+{
+  ptrmap_free (&links);
+  ptrmap_free (&bodies);
+}
+
+/* Insert the statement NODE before STMT */
+void
+motion_insert_before (NODE *stmt, NODE *node)
+{
+  NODE **link = ptrmap_get (&links, stmt, 0);
+  NODE *decl = ptrmap_get (&bodies, link, 0);
+
+  /* A function starts at its first statement */
+  if (decl && decl->v.fncdecl.symbol)
+    decl->v.fncdecl.symbol->v.fnc->entry_point = node;
+  *link = node;
+  node->right = stmt;
+  ptrmap_put (&links, node, 0, link);
+  ptrmap_put (&links, stmt, 0, &node->right);
+}
+
+/* Insert the statement NODE after STMT */
+void
+motion_insert_after (NODE *stmt, NODE *node)
+{
+  if (stmt->right)
+    ptrmap_put (&links, stmt->right, 0, &node->right);
+  node->right = stmt->right;
+  stmt->right = node;
+  ptrmap_put (&links, node, 0, &stmt->right);
+}
+
+/* Turn the expression NODE into a read of the variable S */
+static void
+set_var (NODE *node, SYMBOL *s)
+{
+  node->type = NODE_VAR;
+  node->left = node->right = NULL;
+  node->v.symbol = s;
+  du_link (node, s);
+}
+
+/* Store the expression EXPR to a new temporary at nesting LEVEL,
+   declared right before STMT, and make EXPR read it.  Returns the
+   declaration; the nodes below EXPR move to its initializer. */
+NODE *
+motion_save (NODE *expr, NODE *stmt, int level)
+{
+  NODE *copy, *decl;
+  SYMBOL *s = make_temp (level);
+
+  copy = addnode (expr->type);
+  copy->left = expr->left;
+  copy->right = expr->right;
+  copy->v = expr->v;
+  if (copy->type == NODE_CALL)
+    du_link (copy, copy->v.funcall.symbol);
+
+  decl = make_decl (s, make_expr (copy));
+  motion_insert_before (stmt, decl);
+
+  set_var (expr, s);
+  return decl;
+}
+
+/* Make the expression NODE read the variable S instead */
+void
+motion_replace (NODE *node, SYMBOL *s)
+{
+  ARGLIST *arg;
+
+  traverse_expr (node, unlink_fptab);
+  if (node->type == NODE_CALL)
+    while ((arg = node->v.funcall.args))
+      {
+	node->v.funcall.args = arg->next;
+	mm_free (MEM_ARGLIST, arg, sizeof (ARGLIST));
+      }
+  set_var (node, s);
+}
@@ -0,0 +1,32 @@
+/*
+   V5: motion.h
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _MOTION_H
+#define _MOTION_H
+
+#include "tree.h"
+
+void motion_begin (NODE **);
+void motion_end (void);
+void motion_insert_before (NODE *, NODE *);
+void motion_insert_after (NODE *, NODE *);
+NODE *motion_save (NODE *, NODE *, int);
+void motion_replace (NODE *, SYMBOL *);
+
+#endif /* not _MOTION_H */
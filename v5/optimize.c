@@ -19,253 +19,157 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
 
 #include "tree.h"
 #include "mm.h"
 #include "optimize.h"
+#include "cfg.h"
+#include "ssa.h"
+#include "ipa.h"
+#include "gvn.h"
+#include "licm.h"
+#include "strength.h"
+#include "inline.h"
+#include "tailrec.h"
+#include "ceval.h"
+#include "rewrite.h"
+#include "egraph.h"
+#include "reassoc.h"
+#include "vra.h"
+#include "unroll.h"
+#include "dse.h"
+#include "promote.h"
 
 extern int verbose;
 extern int optimize_level;
 
-static void
-optimize_pass (int n, NODE *node, traverse_fp *fptab)
-{
-  if (verbose > 1)
-    printf ("\n=== Optimization pass %d ===\n\n", n);
+int optimize_worklist = 1;
+int optimize_sccp = -1;
+int optimize_gvn = 1;
+int optimize_licm = 1;
+int optimize_strength = 1;
+int optimize_inline = 1;
+int optimize_tailrec = 1;
+int optimize_ceval = 1;
+int optimize_egraph = 1;
+int optimize_reassoc = 1;
+int optimize_vra = 1;
+int optimize_unroll = 1;
+int optimize_dse = 1;
+int optimize_promote = 1;
+
+static size_t rewrites;   /* nodes rewritten by the passes */
+
+#define PASS_WORKLIST 19
+#define NPASSES 20
+
+static const char *pass_names[NPASSES] = {
+  "parse", "pass1", "pass2", "pass3", "pass4", "pass5", "sccp", "gvn",
+  "licm", "strength", "inline", "tailrec", "ceval", "egraph", "reassoc",
+  "vra", "unroll", "dse", "promote", "worklist"
+};
 
-  traverse (node, fptab);
-  sweep (mark_free (root));
 
-  if (verbose > 2) {
-    printf ("\n=== After optimization pass %d ===\n\n", n);
-    print_node (node);
-  }
-}
+/* Pass statistics
 
-
-/* Pass 1: Operand Sorting */
+   Every run of a pass adds to the counters of its number the wall
+   time it took, the nodes traverse () visited, the nodes rewritten
+   and the nodes freed.  Only traverse () is counted: the walks a
+   pass makes with its own recursion, like building the CFG and the
+   SSA form, the reachability of pass 5 or copying a body, are not,
+   hence the name "traversed" of the column. */
+
+struct pass_stats
+{
+  unsigned long runs;
+  double msec;
+  unsigned long traversed;
+  unsigned long changed;
+  unsigned long freed;
+};
 
-/* Sort order:
-   Variable operands to the right
-   Constant operands to the left */
+static struct pass_stats pass_stats[NPASSES];
+static struct pass_stats pass_start;
 
-static void
-simple_swap (NODE *node)
+static double
+msec_now (void)
 {
-  NODE *p = node->left;
-  if (verbose > 1)
-    printf ("Swap in node %4.4lu\n", node->node_id);
-  node->left = node->right;
-  node->right = p;
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
 }
 
 static void
-swap_nodes (NODE *node)
+pass_stats_begin (void)
 {
-  switch (node->v.opcode) {
-    /* Commutative operations */
-  case OPCODE_ADD:
-  case OPCODE_MUL:
-  case OPCODE_AND:
-  case OPCODE_OR:
-  case OPCODE_EQ:
-  case OPCODE_NE:
-    simple_swap(node);
-    break;
-
-    /* Anti-commutative operations */
-  case OPCODE_SUB:
-    simple_swap(node);
-    node->left->v.number = - node->left->v.number;
-    node->v.opcode = OPCODE_ADD;
-    break;
-
-  case OPCODE_DIV:
-    break;
-
-    /* Non-associative operators */
-  case OPCODE_LT:
-  case OPCODE_GT:
-  case OPCODE_LE:
-  case OPCODE_GE:
-    /* nothing to do */
-    break;
-
-  default:
-    abort ();
-  }
+  pass_start.msec = msec_now ();
+  pass_start.traversed = traverse_visits;
+  pass_start.changed = rewrites;
+  pass_start.freed = nodes_freed;
 }
 
-/*
-   Additive and multiplicative transposition
-   Algorithm:
-
-   C1 + (C2 +|- V) = (C1 + C2) +|- V
-   C1 - (C2 +|- V) = (C1 - C2) -|+ V
-
-   C1 * (C2 *|/ V) = (C1 * C2) *|/ V
-   C1 / (C2 *|/ V) = (C1 / C2) /|* V
-*/
-
-static enum opcode_type
-invert_opcode (enum opcode_type op)
+static void
+pass_stats_end (int n)
 {
-  switch (op) {
-  case OPCODE_ADD:
-    return OPCODE_SUB;
-  case OPCODE_SUB:
-    return OPCODE_ADD;
-  case OPCODE_MUL:
-    return OPCODE_DIV;
-  case OPCODE_DIV:
-    return OPCODE_MUL;
-  default:
-    abort ();
-  }
-  /*NOTREACHED*/
-  return 0;
+  struct pass_stats *st = &pass_stats[n];
+
+  st->runs++;
+  st->msec += msec_now () - pass_start.msec;
+  st->traversed += traverse_visits - pass_start.traversed;
+  st->changed += rewrites - pass_start.changed;
+  st->freed += nodes_freed - pass_start.freed;
 }
 
 static void
-transpose0 (NODE *node)
+optimize_pass_begin (int n)
 {
-  NODE *left = node->left;
-  NODE *right = node->right;
-  enum opcode_type op, rop;
+  mm_set_pass (pass_names[n]);
+  pass_stats_begin ();
 
   if (verbose > 1)
-    printf ("Transpose, node %4.4lu\n", node->node_id);
-
-  op = node->v.opcode;
-  rop = right->v.opcode;
-
-  node->right = right->right;
-
-  right->right = right->left;
-  right->left = left;
-
-  node->left = right;
-
-  node->left->v.opcode = op;
-  if (op == OPCODE_ADD || op == OPCODE_MUL)
-    node->v.opcode = rop;
-  else
-    node->v.opcode = invert_opcode (rop);
-	
-  node->left->left = left;
+    printf ("\n=== Optimization pass %d ===\n\n", n);
 }
 
 static void
-transpose (NODE *node)
+optimize_pass_end (int n, NODE *node)
 {
-  switch (node->v.opcode) {
-  case OPCODE_ADD:
-  case OPCODE_SUB:
-    switch (node->right->v.opcode) {
-    case OPCODE_ADD:
-    case OPCODE_SUB:
-      transpose0 (node);
-    default:
-      break;
-    }
-    break;
-  case OPCODE_MUL:
-  case OPCODE_DIV:
-    switch (node->right->v.opcode) {
-    case OPCODE_MUL:
-    case OPCODE_DIV:
-      transpose0 (node);
-    default:
-      break;
-    }
-    break;
+  sweep (mark_free (root));
+  pass_stats_end (n);
 
-  default:
-    break;
+  if (verbose > 2) {
+    printf ("\n=== After optimization pass %d ===\n\n", n);
+    print_node (node);
   }
 }
 
-/*
-   Algorithm:
-   C1 * X / C2 = (C1 / C2) * X
-   C1 / X * C2 = (C1 * C2) / X
-*/
-
 static void
-transpose_left0 (NODE *node)
+optimize_pass (int n, NODE *node, traverse_fp *fptab)
 {
-  NODE *left = node->left;
-  NODE *right = node->right;
-  if (left->type == NODE_BINOP
-      && left->v.opcode == OPCODE_MUL
-      && left->left->type == NODE_CONST
-      && right->type == NODE_CONST)
-    {
-      NODE *s;
-      enum opcode_type op;
-
-      if (verbose > 1)
-	printf ("Transpose, node %4.4lu\n", node->node_id);
-
-      op = node->v.opcode;
-      node->v.opcode = left->v.opcode;
-      left->v.opcode = op;
-
-      s = left->right;
-      left->right = node->right;
-      node->right = s;
-    }
+  optimize_pass_begin (n);
+  traverse (node, fptab);
+  optimize_pass_end (n, node);
 }
 
-static void
-transpose_left (NODE *node)
-{
-  switch (node->v.opcode) {
-  case OPCODE_ADD:
-  case OPCODE_SUB:
-      break;
+
+/* Pass 1: Algebraic rewriting */
 
-  case OPCODE_MUL:
-  case OPCODE_DIV:
-    transpose_left0 (node);
-  default:
-    break;
-  }
-}
+/* The rules are in rewrite.rules.  They sort the operands, constants
+   to the left, bring constants together, and simplify the identities
+   and the logic. */
 
 static void
-pass1_binop (NODE *node)
+pass1_op (NODE *node)
 {
-  if (node->right->type == NODE_CONST) {
-    if (node->left->type == NODE_CONST) {
-      return;
-    }
-    swap_nodes(node);
-  }
-
-  switch (node->left->type) {
-  case NODE_BINOP:
-    transpose_left (node);
-    break;
-  default:
-    break;
-  }
-
-  switch (node->right->type) {
-  case NODE_BINOP:
-    transpose (node);
-    break;
-  case NODE_UNOP:
-    break;
-  default:
-    break;
-  }
+  rewrites += rewrite_node (node);
 }
 
 traverse_fp pass1_fptab[] = {
   NULL,        /* NODE_NOOP */
-  NULL,        /* NODE_UNOP */
-  pass1_binop, /* NODE_BINOP */
+  pass1_op,    /* NODE_UNOP */
+  pass1_op,    /* NODE_BINOP */
   NULL,        /* NODE_CONST */
   NULL,        /* NODE_VAR */
   NULL,        /* NODE_CALL */
@@ -292,6 +196,35 @@ optimize_pass_1 (NODE *node)
 
 static size_t optcnt;
 
+/* Take the nodes of a discarded expression off the def-use chains,
+   the sweep at the end of the pass would do it too late for the
+   worklist driver. */
+
+static void
+unlink_node (NODE *node)
+{
+  du_unlink (node);
+}
+
+traverse_fp unlink_fptab[] = {
+  unlink_node, /* NODE_NOOP */
+  unlink_node, /* NODE_UNOP */
+  unlink_node, /* NODE_BINOP */
+  unlink_node, /* NODE_CONST */
+  unlink_node, /* NODE_VAR */
+  unlink_node, /* NODE_CALL */
+  unlink_node, /* NODE_ASGN */
+  unlink_node, /* NODE_EXPR */
+  unlink_node, /* NODE_RETURN */
+  unlink_node, /* NODE_PRINT */
+  unlink_node, /* NODE_JUMP */
+  unlink_node, /* NODE_COMPOUND  */
+  unlink_node, /* NODE_ITERATION */
+  unlink_node, /* NODE_CONDITION */
+  unlink_node, /* NODE_VAR_DECL */
+  unlink_node  /* NODE_FNC_DECL */
+};
+
 static void
 eval_binop_const (NODE *node)
 {
@@ -312,10 +245,12 @@ eval_binop_const (NODE *node)
     node->v.number = left->v.number * right->v.number;
     break;
   case OPCODE_DIV:
-    if (left->v.number > right->v.number) 
-      node->v.number = left->v.number / right->v.number;
-    else
+    if (right->v.number == 0)
       return;
+    if (right->v.number == -1)
+      node->v.number = - (unsigned long) left->v.number;
+    else
+      node->v.number = left->v.number / right->v.number;
     break;
   case OPCODE_AND:
     node->v.number = left->v.number && right->v.number;
@@ -341,6 +276,23 @@ eval_binop_const (NODE *node)
   case OPCODE_GE:
     node->v.number = left->v.number >= right->v.number;
     break;
+  case OPCODE_MOD:
+    if (right->v.number == 0)
+      return;
+    if (right->v.number == -1)
+      node->v.number = 0;
+    else
+      node->v.number = left->v.number % right->v.number;
+    break;
+  case OPCODE_SHL:
+    node->v.number = (unsigned long) left->v.number << (right->v.number & 63);
+    break;
+  case OPCODE_SHR:
+    node->v.number = left->v.number >> (right->v.number & 63);
+    break;
+  case OPCODE_BAND:
+    node->v.number = left->v.number & right->v.number;
+    break;
   case OPCODE_NEG:
   case OPCODE_NOT:
     abort ();
@@ -350,73 +302,7 @@ eval_binop_const (NODE *node)
   node->left = node->right = NULL;
   node->type = NODE_CONST;
   optcnt++;
-}
-
-static void
-eval_binop_simple (NODE *node)
-{
-  NODE *left  = node->left;
-  NODE *right = node->right;
-
-  if (verbose > 1)
-    printf ("Optimizing node %4.4lu (BINOP)\n", node->node_id);
-
-  if (node->v.opcode == OPCODE_MUL)
-    {
-      if (left->v.number == 0)
-	{
-	  /*  0*x = 0  */
-	  node->type = NODE_CONST;
-	  node->v.number = 0;
-	}
-      else if (left->v.number == 1)
-	{
-	  /*  1*x = x  */
-	  node->type = NODE_VAR;
-	  node->v.symbol = right->v.symbol;
-	}
-    }
-  else if (node->v.opcode == OPCODE_ADD)
-    {
-      if (left->v.number == 0)
-	{
-	  /*  0+x = x  */
-	  node->type = NODE_VAR;
-	  node->v.symbol = right->v.symbol;
-	}
-    }
-
-  freenode (left);
-  freenode (right);
-  node->left = node->right = NULL;
-}
-
-static void
-eval_binop_simple_logic (NODE *node)
-{
-  NODE *right = node->right;
-
-  if (verbose > 1)
-    printf ("Optimizing node %4.4lu (BINOP)\n", node->node_id);
-
-  if (node->v.opcode == OPCODE_AND)
-    {
-      /*  1 && (BINOP|UNOP) = (BINOP|UNOP)  */
-      node->type  = right->type;
-      node->left  = right->left;
-      node->right = right->right;
-      node->v.opcode = right->v.opcode;
-    }
-  else if (node->v.opcode == OPCODE_OR)
-    {
-      /*  1 || (BINOP|UNOP) = 1  */
-      node->type  = NODE_CONST;
-      freenode (node->left);
-      freenode (node->right);
-      node->left  = NULL;
-      node->right = NULL;
-      node->v.number = 1;
-    }
+  rewrites++;
 }
 
 static void
@@ -427,31 +313,7 @@ pass2_binop (NODE *node)
 
   if (left->type == NODE_CONST
       && right->type == NODE_CONST)
-    {
-      eval_binop_const (node);
-    }
-  else if (left->type == NODE_CONST
-	   && right->type == NODE_VAR)
-    {
-      if (node->v.opcode == OPCODE_ADD && left->v.number == 0)
-	{
-	  eval_binop_simple (node);
-	}
-      else if (node->v.opcode == OPCODE_MUL
-	       && (left->v.number == 0 || left->v.number == 1))
-	{
-	  eval_binop_simple (node);
-	}
-    }
-  else if (left->type == NODE_CONST
-	   && (right->type == NODE_BINOP || right->type == NODE_UNOP))
-    {
-      if ((node->v.opcode == OPCODE_AND || node->v.opcode == OPCODE_OR)
-	  && left->v.number != 0)
-	{
-	  eval_binop_simple_logic (node);
-	}
-    }
+    eval_binop_const (node);
 }
 
 static void
@@ -474,6 +336,7 @@ pass2_unop (NODE *node)
     }
     freenode (operand);
     optcnt++;
+    rewrites++;
   }
 }
 
@@ -486,9 +349,12 @@ pass2_asgn (NODE *node)
       if (verbose > 1)
 	printf ("Optimizing node %4.4lu (ASGN)\n", node->node_id);
 
+      du_unlink (node);
+      traverse_expr (node->v.asgn.expr, unlink_fptab);
       freenode (node->v.asgn.expr);
       node->v.asgn.expr = NULL;
       node->type = NODE_NOOP;
+      rewrites++;
     }
 }
 
@@ -534,10 +400,12 @@ pass3_var (NODE *node)
       if (verbose > 1)
 	printf ("Optimizing node %4.4lu (VAR)\n", node->node_id);
 
+      du_unlink (node);
       node->v.expr = NULL;
       node->v.number = s->v.var->entry_point->v.expr->v.number;
       node->type = NODE_CONST;
       optcnt++;
+      rewrites++;
     }
 }
 
@@ -572,163 +440,1224 @@ traverse_fp pass3_fptab[] = {
   NULL,           /* NODE_FNC_DECL */
 };
 
+/* Entry points are only valid during a single walk; an entry point
+   left over from a previous walk may refer to a freed node. */
+
+static void
+reset_entry_points (SYMBOL *s)
+{
+  for (; s; s = s->next)
+    s->v.var->entry_point = NULL;
+}
+
 static void
 optimize_pass_3 (NODE *node)
 {
+  reset_entry_points (symbol_variables);
+  reset_entry_points (symbol_history);
   optimize_pass (3, node, pass3_fptab);
 }
 
-
+
 /* Pass 4: Elimination of unused declarations */
 
-static void
-pass4a_var (NODE *node)
-{
-  node->v.symbol->ref_count++;
-}
+/* A variable is unused if nothing reads it and nothing but its
+   declaration writes it.  Both are answered by the def-use chains,
+   so no walk of the tree is needed. */
 
-static void
-pass4a_asgn (NODE *node)
+static int
+symbol_is_used (SYMBOL *s)
 {
-  node->v.asgn.symbol->ref_count++;
+  NODE *p;
+
+  if (s->nuses)
+    return 1;
+  for (p = s->defs; p; p = p->du_next)
+    if (p->type == NODE_ASGN)
+      return 1;
+  return 0;
 }
 
-traverse_fp pass4a_fptab[] = {
-  NULL,        /* NODE_NOOP */
-  NULL,        /* NODE_UNOP */
-  NULL,        /* NODE_BINOP */
-  NULL,        /* NODE_CONST */
-  pass4a_var,  /* NODE_VAR */
-  NULL,        /* NODE_CALL */
-  pass4a_asgn, /* NODE_ASGN */
-  NULL,        /* NODE_EXPR */
-  NULL,        /* NODE_RETURN */
-  NULL,        /* NODE_PRINT */
-  NULL,        /* NODE_JUMP */
-  NULL,        /* NODE_COMPOUND  */
-  NULL,        /* NODE_ITERATION */
-  NULL,        /* NODE_CONDITION */
-  NULL,        /* NODE_VAR_DECL */
-  NULL,        /* NODE_FNC_DECL */
-};
+/* The initializer of an unused variable goes away with it, unless
+   it may fail or has side effects (see ipa_may_fail).  It is then
+   still computed, by an expression statement in place of the
+   declaration. */
 
 static void
-pass4b_vardecl (NODE *node)
+remove_unused (SYMBOL *s)
 {
-  if (node->v.vardecl.symbol->ref_count == 0)
+  NODE *p, *next, *expr;
+
+  for (; s; s = s->next)
     {
-      if (verbose > 1)
-	printf ("Removing unused %s variable %s (node %4.4lu)\n",
-		node->v.vardecl.symbol->v.var->qualifier == QUA_GLOBAL ?
-	        "global" : "automatic",
-		node->v.vardecl.symbol->name,
-		node->node_id);
-      node->type = NODE_NOOP;
+      if (symbol_is_used (s))
+	continue;
+
+      for (p = s->defs; p; p = next)
+	{
+	  next = p->du_next;
+	  expr = p->v.vardecl.expr;
+	  if (verbose > 1)
+	    printf ("Removing unused %s variable %s (node %4.4lu)\n",
+		    s->v.var->qualifier == QUA_GLOBAL ?
+		    "global" : "automatic",
+		    s->name,
+		    p->node_id);
+	  du_unlink (p);
+	  if (expr && ipa_may_fail (expr))
+	    {
+	      p->type = NODE_EXPR;
+	      p->v.expr = expr->v.expr;
+	    }
+	  else
+	    p->type = NODE_NOOP;
+	  rewrites++;
+	}
     }
 }
 
-traverse_fp pass4b_fptab[] = {
-  NULL,           /* NODE_NOOP */
-  NULL,           /* NODE_UNOP */
-  NULL,           /* NODE_BINOP */
-  NULL,           /* NODE_CONST */
-  NULL,           /* NODE_VAR */
-  NULL,           /* NODE_CALL */
-  NULL,           /* NODE_ASGN */
-  NULL,           /* NODE_EXPR */
-  NULL,           /* NODE_RETURN */
-  NULL,           /* NODE_PRINT */
-  NULL,           /* NODE_JUMP */
-  NULL,           /* NODE_COMPOUND  */
-  NULL,           /* NODE_ITERATION */
-  NULL,           /* NODE_CONDITION */
-  pass4b_vardecl, /* NODE_VAR_DECL */
-  NULL,           /* NODE_FNC_DECL */
-};
-
 void
 optimize_pass_4 (NODE *node)
 {
-  optimize_pass (4, node, pass4a_fptab);
-  optimize_pass (4, node, pass4b_fptab);
+  optimize_pass_begin (4);
+  ipa_analyze (node);
+  remove_unused (symbol_variables);
+  remove_unused (symbol_history);
+  ipa_free ();
+  optimize_pass_end (4, node);
 }
 
-
-/* Pass 5: Elimination of dead conditionals */
+
+/* Pass 5: Elimination of dead code
+
+   First the conditionals with a constant condition are replaced by
+   the branch taken, any nonzero value being true, and the loops
+   whose condition is 0 go away.  Then the statements left in blocks
+   that the control-flow graph cannot reach are removed: the code
+   after `return', `break' and `continue', behind an endless loop,
+   or after a conditional both of whose branches jump away.
+
+   Function declarations are not executed and stay.  A declaration
+   of a variable that is unreachable is kept as long as reachable
+   code, or a function, still refers to the variable.  The discarded
+   statements are freed on the spot. */
+
+int optimize_dce = 1;
+
+static size_t dce_stmts;      /* statements removed */
+static size_t dce_nodes;      /* nodes freed */
+static NODE **dce_decls;      /* unreachable declarations */
+static size_t dce_ndecls, dce_decls_size;
 
 static void
-pass5_condition (NODE *node)
+dce_free_node (NODE *node)
 {
-  NODE *cond = node->v.condition.cond;
-
-  if (cond->v.expr->type == NODE_CONST) {
-    if (cond->v.expr->v.number == 1) /* TRUE */
-      {
-	if (verbose > 1)
-	  printf ("Eliminating conditional, node %4.4lu (always true)\n",
-		  node->node_id);
-	node->v.condition.iftrue_stmt->right = node->right;
-	node->right = node->v.condition.iftrue_stmt;
-	node->type = NODE_NOOP;
-	/* node->v.condition.iffalse_stmt = NULL;
-	   freenode (node->v.condition.iffalse_stmt); */
-      }
-    else if (cond->v.expr->v.number == 0) /* FALSE */
-      {
-	if (verbose > 1)
-	  printf ("Eliminating conditional, node %4.4lu (always false)\n",
-		  node->node_id);
-	node->v.condition.iffalse_stmt->right = node->right;
-	node->right = node->v.condition.iffalse_stmt;
-	node->type = NODE_NOOP;
-      }
-  }
+  freenode (node);
+  dce_nodes++;
 }
 
-traverse_fp pass5_fptab[] = {
-  NULL,           /* NODE_NOOP */
-  NULL,           /* NODE_UNOP */
-  NULL,           /* NODE_BINOP */
-  NULL,           /* NODE_CONST */
-  NULL,           /* NODE_VAR */
-  NULL,           /* NODE_CALL */
-  NULL,           /* NODE_ASGN */
-  NULL,           /* NODE_EXPR */
-  NULL,           /* NODE_RETURN */
-  NULL,           /* NODE_PRINT */
-  NULL,           /* NODE_JUMP */
-  NULL,           /* NODE_COMPOUND  */
-  NULL,           /* NODE_ITERATION */
-  pass5_condition,/* NODE_CONDITION */
-  NULL,           /* NODE_VAR_DECL */
-  NULL,           /* NODE_FNC_DECL */
+traverse_fp dce_free_fptab[] = {
+  dce_free_node, /* NODE_NOOP */
+  dce_free_node, /* NODE_UNOP */
+  dce_free_node, /* NODE_BINOP */
+  dce_free_node, /* NODE_CONST */
+  dce_free_node, /* NODE_VAR */
+  dce_free_node, /* NODE_CALL */
+  dce_free_node, /* NODE_ASGN */
+  dce_free_node, /* NODE_EXPR */
+  dce_free_node, /* NODE_RETURN */
+  dce_free_node, /* NODE_PRINT */
+  dce_free_node, /* NODE_JUMP */
+  dce_free_node, /* NODE_COMPOUND  */
+  dce_free_node, /* NODE_ITERATION */
+  dce_free_node, /* NODE_CONDITION */
+  dce_free_node, /* NODE_VAR_DECL */
+  dce_free_node  /* NODE_FNC_DECL */
 };
 
+/* Free a statement list that is no longer in the tree */
+static void
+dce_free_list (NODE *node)
+{
+  traverse (node, dce_free_fptab);
+}
+
+/* Unlink the statement at *LINK and free it */
+static void
+dce_remove (NODE **link)
+{
+  NODE *node = *link;
+
+  *link = node->right;
+  node->right = NULL;
+  dce_stmts++;
+  dce_free_list (node);
+}
+
+/* Does the statement declare a function?  Functions are global
+   whatever the scope of their declaration, so those stay. */
+static int dce_has_function (NODE *);
+
+static int
+dce_stmt_has_function (NODE *node)
+{
+  switch (node->type) {
+  case NODE_FNC_DECL:
+    return 1;
+  case NODE_COMPOUND:
+    return dce_has_function (node->v.expr);
+  case NODE_CONDITION:
+    return dce_has_function (node->v.condition.iftrue_stmt)
+      || dce_has_function (node->v.condition.iffalse_stmt);
+  case NODE_ITERATION:
+    return dce_has_function (node->v.iteration.stmt);
+  default:
+    return 0;
+  }
+}
+
+static int
+dce_has_function (NODE *node)
+{
+  for (; node; node = node->right)
+    if (dce_stmt_has_function (node))
+      return 1;
+  return 0;
+}
+
+static void
+dce_fold_list (NODE **link)
+{
+  NODE *node, *taken, *tail, *cond;
+
+  while ((node = *link))
+    {
+      switch (node->type) {
+      case NODE_CONDITION:
+	cond = node->v.condition.cond;
+	if (cond->v.expr->type != NODE_CONST
+	    || dce_has_function (cond->v.expr->v.number
+				 ? node->v.condition.iffalse_stmt
+				 : node->v.condition.iftrue_stmt))
+	  {
+	    dce_fold_list (&node->v.condition.iftrue_stmt);
+	    dce_fold_list (&node->v.condition.iffalse_stmt);
+	    break;
+	  }
+	if (verbose > 1)
+	  printf ("Eliminating conditional, node %4.4lu (always %s)\n",
+		  node->node_id, cond->v.expr->v.number ? "true" : "false");
+	if (cond->v.expr->v.number)
+	  {
+	    taken = node->v.condition.iftrue_stmt;
+	    dce_free_list (node->v.condition.iffalse_stmt);
+	  }
+	else
+	  {
+	    taken = node->v.condition.iffalse_stmt;
+	    dce_free_list (node->v.condition.iftrue_stmt);
+	  }
+	traverse_expr (cond, dce_free_fptab);
+	dce_free_node (node);
+	dce_stmts++;
+
+	/* Splice the statements of the branch taken */
+	if (taken)
+	  {
+	    for (tail = taken; tail->right; tail = tail->right)
+	      ;
+	    tail->right = node->right;
+	    *link = taken;
+	  }
+	else
+	  *link = node->right;
+	continue;
+
+      case NODE_ITERATION:
+	cond = node->v.iteration.cond;
+	if (cond->v.expr->type == NODE_CONST && cond->v.expr->v.number == 0
+	    && !dce_has_function (node->v.iteration.stmt))
+	  {
+	    if (verbose > 1)
+	      printf ("Eliminating loop, node %4.4lu (never entered)\n",
+		      node->node_id);
+	    dce_remove (link);
+	    continue;
+	  }
+	dce_fold_list (&node->v.iteration.stmt);
+	break;
+
+      case NODE_COMPOUND:
+	dce_fold_list (&node->v.expr);
+	break;
+
+      case NODE_FNC_DECL:
+	dce_fold_list (&node->v.fncdecl.stmt);
+	break;
+
+      default:
+	break;
+      }
+      link = &node->right;
+    }
+}
+
+static void dce_reach_list (struct cfg *, struct cfg *, NODE **);
+
+/* The blocks reachable when a branch on a constant (an endless
+   loop, by now) only takes the edge it always takes */
+static unsigned char *dce_live;  /* indexed by block->index */
+
+static void
+dce_mark_live (struct cfg *g)
+{
+  struct cfg_block **stack;
+  size_t sp = 0;
+
+  dce_live = calloc (g->nblocks, 1);
+  stack = malloc (g->nblocks * sizeof (*stack));
+  if (!dce_live || !stack)
+    exit (EXIT_FAILURE);
+
+  dce_live[g->entry->index] = 1;
+  stack[sp++] = g->entry;
+  while (sp)
+    {
+      struct cfg_block *b = stack[--sp];
+      NODE *cond = cfg_branch_cond (b);
+      int k;
+
+      for (k = 0; k < 2; k++)
+	{
+	  struct cfg_block *t = b->succ[k];
+	  if (!t || dce_live[t->index])
+	    continue;
+	  if (cond && cond->v.expr->type == NODE_CONST
+	      && (cond->v.expr->v.number != 0) != (k == 0))
+	    continue;
+	  dce_live[t->index] = 1;
+	  stack[sp++] = t;
+	}
+    }
+  free (stack);
+}
+
+static int
+dce_reachable (struct cfg *g, NODE *node)
+{
+  struct cfg_block *b = cfg_block_of (g, node);
+
+  return !b || dce_live[b->index];
+}
+
+static void
+dce_reach_list (struct cfg *graphs, struct cfg *g, NODE **link)
+{
+  unsigned char *saved;
+  struct cfg *fg;
+  NODE *node;
+
+  while ((node = *link))
+    {
+      switch (node->type) {
+      case NODE_FNC_DECL:
+	saved = dce_live;
+	fg = cfg_find (graphs, node->v.fncdecl.symbol);
+	dce_mark_live (fg);
+	dce_reach_list (graphs, fg, &node->v.fncdecl.stmt);
+	free (dce_live);
+	dce_live = saved;
+	break;
+
+      case NODE_COMPOUND:
+	dce_reach_list (graphs, g, &node->v.expr);
+	break;
+
+      case NODE_NOOP:
+	break;
+
+      case NODE_VAR_DECL:
+	if (dce_reachable (g, node))
+	  break;
+	if (dce_ndecls == dce_decls_size)
+	  {
+	    dce_decls_size = dce_decls_size ? dce_decls_size * 2 : 16;
+	    dce_decls = realloc (dce_decls,
+				 dce_decls_size * sizeof (*dce_decls));
+	    if (!dce_decls)
+	      exit (EXIT_FAILURE);
+	  }
+	dce_decls[dce_ndecls++] = node;
+	break;
+
+      default:
+	if (!dce_reachable (g, node) && !dce_stmt_has_function (node))
+	  {
+	    if (verbose > 1)
+	      printf ("Eliminating unreachable node %4.4lu\n", node->node_id);
+	    dce_remove (link);
+	    continue;
+	  }
+	if (node->type == NODE_CONDITION)
+	  {
+	    dce_reach_list (graphs, g, &node->v.condition.iftrue_stmt);
+	    dce_reach_list (graphs, g, &node->v.condition.iffalse_stmt);
+	  }
+	else if (node->type == NODE_ITERATION)
+	  dce_reach_list (graphs, g, &node->v.iteration.stmt);
+	break;
+      }
+      link = &node->right;
+    }
+}
+
 static void
 optimize_pass_5 (NODE *node)
 {
-  optimize_pass (5, node, pass5_fptab);
+  struct cfg *graphs;
+  size_t i, nodes = nodes_counter;
+
+  optimize_pass_begin (5);
+  dce_stmts = dce_nodes = 0;
+  dce_fold_list (&root);
+
+  graphs = cfg_build (root);
+  dce_ndecls = 0;
+  dce_mark_live (graphs);
+  dce_reach_list (graphs, graphs, &root);
+  free (dce_live);
+  dce_live = NULL;
+  cfg_free (graphs);
+
+  /* Later declarations may use the earlier ones */
+  for (i = dce_ndecls; i-- > 0; )
+    {
+      NODE *decl = dce_decls[i];
+      if (symbol_is_used (decl->v.vardecl.symbol))
+	continue;
+      if (verbose > 1)
+	printf ("Eliminating unreachable node %4.4lu\n", decl->node_id);
+      traverse_expr (decl->v.vardecl.expr, dce_free_fptab);
+      du_unlink (decl);
+      decl->type = NODE_NOOP;
+      dce_stmts++;
+    }
+  free (dce_decls);
+  dce_decls = NULL;
+  dce_decls_size = 0;
+
+  rewrites += dce_stmts;
+  if (verbose > 1)
+    printf ("Dead code: %lu statements, %lu of %lu nodes removed\n",
+	    (unsigned long) dce_stmts, (unsigned long) dce_nodes,
+	    (unsigned long) nodes);
+  optimize_pass_end (5, root);
+}
+
+
+/* Worklist driver for passes 1-3
+
+   Instead of repeating the passes over the whole tree, only the
+   statements that may still change are revisited.  The driver works
+   in rounds: pass 1 and then pass 2 are applied to the expressions
+   of the pending statements, and pass 3 to the pending uses in walk
+   order.  A statement is pending in the next round if any of its
+   nodes was rewritten.  A use is pending if its statement is, or if
+   a definition of its variable became constant or went away.
+
+   The entry point of a variable in pass 3 is the definition nearest
+   before the use in walk order.  The driver finds it on the def-use
+   chain by comparing the walk order of the statements, numbered once
+   before the first round. */
+
+static NODE **wl_stmts;       /* statements in walk order */
+static size_t wl_nstmts, wl_stmts_size;
+static size_t *wl_cur;        /* statements pending in this round */
+static size_t *wl_next;       /* and in the next round */
+static size_t wl_ncur, wl_nnext;
+static unsigned char *wl_pending;
+static unsigned char *wl_removed;  /* assignments removed by pass 2 */
+static NODE **wl_uses;        /* heap of pending uses, by walk order */
+static size_t wl_nuses, wl_uses_size;
+static unsigned long wl_order;
+
+/* Apply FPTAB to the expressions of a single statement */
+static void
+wl_traverse (NODE *node, traverse_fp *fptab)
+{
+  ARGLIST *arg;
+
+  switch (node->type) {
+  case NODE_CALL:
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      traverse_expr (arg->node, fptab);
+    break;
+  case NODE_ASGN:
+    traverse_expr (node->v.asgn.expr, fptab);
+    break;
+  case NODE_EXPR:
+  case NODE_RETURN:
+  case NODE_PRINT:
+    traverse_expr (node->v.expr, fptab);
+    break;
+  case NODE_ITERATION:
+    traverse_expr (node->v.iteration.cond, fptab);
+    break;
+  case NODE_CONDITION:
+    traverse_expr (node->v.condition.cond, fptab);
+    break;
+  case NODE_VAR_DECL:
+    traverse_expr (node->v.vardecl.expr, fptab);
+    break;
+  default:
+    break;
+  }
+  if (fptab[node->type])
+    fptab[node->type](node);
+}
+
+static void
+wl_set_order (NODE *node)
+{
+  node->order = wl_order;
+}
+
+traverse_fp wl_order_fptab[] = {
+  wl_set_order, /* NODE_NOOP */
+  wl_set_order, /* NODE_UNOP */
+  wl_set_order, /* NODE_BINOP */
+  wl_set_order, /* NODE_CONST */
+  wl_set_order, /* NODE_VAR */
+  wl_set_order, /* NODE_CALL */
+  wl_set_order, /* NODE_ASGN */
+  wl_set_order, /* NODE_EXPR */
+  wl_set_order, /* NODE_RETURN */
+  wl_set_order, /* NODE_PRINT */
+  wl_set_order, /* NODE_JUMP */
+  wl_set_order, /* NODE_COMPOUND  */
+  wl_set_order, /* NODE_ITERATION */
+  wl_set_order, /* NODE_CONDITION */
+  wl_set_order, /* NODE_VAR_DECL */
+  wl_set_order  /* NODE_FNC_DECL */
+};
+
+static void
+wl_number (NODE *node)
+{
+  for (; node; node = node->right)
+    {
+      if (wl_nstmts == wl_stmts_size)
+	{
+	  wl_stmts_size = wl_stmts_size ? wl_stmts_size * 2 : 64;
+	  wl_stmts = realloc (wl_stmts, wl_stmts_size * sizeof (*wl_stmts));
+	  if (!wl_stmts)
+	    exit (EXIT_FAILURE);
+	}
+      wl_order = wl_nstmts;
+      wl_stmts[wl_nstmts++] = node;
+      wl_traverse (node, wl_order_fptab);
+
+      switch (node->type) {
+      case NODE_COMPOUND:
+	wl_number (node->v.expr);
+	break;
+      case NODE_ITERATION:
+	wl_number (node->v.iteration.stmt);
+	break;
+      case NODE_CONDITION:
+	wl_number (node->v.condition.iftrue_stmt);
+	wl_number (node->v.condition.iffalse_stmt);
+	break;
+      case NODE_FNC_DECL:
+	wl_number (node->v.fncdecl.stmt);
+	break;
+      default:
+	break;
+      }
+    }
+}
+
+/* Make the statement pending in the next round */
+static void
+wl_touch (unsigned long order)
+{
+  if (wl_pending[order])
+    return;
+  wl_pending[order] = 1;
+  wl_next[wl_nnext++] = order;
+}
+
+static void
+wl_push_use (NODE *node)
+{
+  size_t i;
+
+  if (wl_nuses == wl_uses_size)
+    {
+      wl_uses_size = wl_uses_size ? wl_uses_size * 2 : 64;
+      wl_uses = realloc (wl_uses, wl_uses_size * sizeof (*wl_uses));
+      if (!wl_uses)
+	exit (EXIT_FAILURE);
+    }
+  for (i = wl_nuses++; i > 0; i = (i - 1) / 2)
+    {
+      NODE *parent = wl_uses[(i - 1) / 2];
+      if (parent->order <= node->order)
+	break;
+      wl_uses[i] = parent;
+    }
+  wl_uses[i] = node;
+}
+
+static NODE *
+wl_pop_use (void)
+{
+  NODE *top = wl_uses[0];
+  NODE *last = wl_uses[--wl_nuses];
+  size_t i = 0, child;
+
+  while ((child = 2 * i + 1) < wl_nuses)
+    {
+      if (child + 1 < wl_nuses
+	  && wl_uses[child + 1]->order < wl_uses[child]->order)
+	child++;
+      if (last->order <= wl_uses[child]->order)
+	break;
+      wl_uses[i] = wl_uses[child];
+      i = child;
+    }
+  if (wl_nuses)
+    wl_uses[i] = last;
+  return top;
+}
+
+traverse_fp wl_use_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  wl_push_use, /* NODE_VAR */
+  NULL,        /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+static SYMBOL *
+wl_def_symbol (NODE *def)
+{
+  return def->type == NODE_VAR_DECL ?
+    def->v.vardecl.symbol : def->v.asgn.symbol;
+}
+
+/* The value a definition stores, if it is a constant */
+static NODE *
+wl_const_def (NODE *def)
+{
+  NODE *expr = NULL;
+
+  if (def->type == NODE_ASGN)
+    expr = def->v.asgn.expr;
+  else if (def->type == NODE_VAR_DECL)
+    expr = def->v.vardecl.expr;
+  if (expr && expr->v.expr->type == NODE_CONST)
+    return expr;
+  return NULL;
+}
+
+/* The uses of S after DEF may see a new entry point */
+static void
+wl_push_uses (SYMBOL *s, NODE *def)
+{
+  NODE *p;
+
+  for (p = s->uses; p; p = p->du_next)
+    if (p->type == NODE_VAR && p->order > def->order)
+      wl_push_use (p);
+}
+
+static NODE *
+wl_entry_point (NODE *use)
+{
+  NODE *p, *def = NULL;
+
+  for (p = use->v.symbol->defs; p; p = p->du_next)
+    if (p->order < use->order && (!def || p->order > def->order))
+      def = p;
+  return def;
+}
+
+static void
+wl_round (void)
+{
+  size_t i, *t;
+
+  t = wl_cur;
+  wl_cur = wl_next;
+  wl_next = t;
+  wl_ncur = wl_nnext;
+  wl_nnext = 0;
+  for (i = 0; i < wl_ncur; i++)
+    wl_pending[wl_cur[i]] = 0;
+
+  /* Pass 1 */
+  for (i = 0; i < wl_ncur; i++)
+    {
+      size_t n = rewrites;
+      wl_traverse (wl_stmts[wl_cur[i]], pass1_fptab);
+      if (rewrites != n)
+	wl_touch (wl_cur[i]);
+    }
+
+  /* Pass 2.  An assignment turned into NOOP keeps its symbol. */
+  for (i = 0; i < wl_ncur; i++)
+    {
+      NODE *node = wl_stmts[wl_cur[i]];
+      size_t n = rewrites;
+      enum node_type type = node->type;
+
+      wl_traverse (node, pass2_fptab);
+      if (rewrites != n)
+	{
+	  wl_touch (wl_cur[i]);
+	  if (type == NODE_ASGN && node->type == NODE_NOOP)
+	    wl_removed[wl_cur[i]] = 1;
+	}
+    }
+
+  /* Pass 3: the uses of the pending statements, and of the
+     definitions that became constant or were removed.  Nothing
+     gets freed from here on, so the queued nodes stay valid.
+     SCCP takes its place when enabled. */
+  if (optimize_sccp)
+    return;
+  for (i = 0; i < wl_ncur; i++)
+    {
+      NODE *node = wl_stmts[wl_cur[i]];
+
+      if (wl_removed[node->order])
+	{
+	  wl_removed[node->order] = 0;
+	  wl_push_uses (node->v.asgn.symbol, node);
+	}
+      else if (wl_pending[node->order] && wl_const_def (node))
+	wl_push_uses (wl_def_symbol (node), node);
+      wl_traverse (node, wl_use_fptab);
+    }
+
+  while (wl_nuses)
+    {
+      NODE *use = wl_pop_use ();
+      NODE *def, *stmt;
+      SYMBOL *s;
+
+      if (use->type != NODE_VAR)
+	continue;
+      def = wl_entry_point (use);
+      if (!def)
+	continue;
+
+      s = use->v.symbol;
+      s->v.var->entry_point = wl_const_def (def);
+      pass3_var (use);
+      s->v.var->entry_point = NULL;
+      if (use->type == NODE_VAR)
+	continue;
+
+      stmt = wl_stmts[use->order];
+      wl_touch (stmt->order);
+      if (wl_const_def (stmt))
+	wl_push_uses (wl_def_symbol (stmt), stmt);
+    }
+}
+
+static void
+optimize_worklist_run (NODE *node)
+{
+  size_t i;
+  int round = 0;
+
+  mm_set_pass (pass_names[PASS_WORKLIST]);
+  pass_stats_begin ();
+
+  wl_nstmts = 0;
+  wl_number (node);
+  wl_cur = malloc ((wl_nstmts + 1) * sizeof (*wl_cur));
+  wl_next = malloc ((wl_nstmts + 1) * sizeof (*wl_next));
+  wl_pending = malloc (wl_nstmts + 1);
+  wl_removed = calloc (wl_nstmts + 1, 1);
+  if (!wl_cur || !wl_next || !wl_pending || !wl_removed)
+    exit (EXIT_FAILURE);
+
+  for (i = 0; i < wl_nstmts; i++)
+    {
+      wl_next[i] = i;
+      wl_pending[i] = 1;
+    }
+  wl_nnext = wl_nstmts;
+
+  while (wl_nnext)
+    {
+      if (verbose > 1)
+	printf ("\n=== Optimization round %d (%lu statements) ===\n\n",
+		++round, (unsigned long) wl_nnext);
+      wl_round ();
+    }
+
+  free (wl_cur);
+  free (wl_next);
+  free (wl_pending);
+  free (wl_removed);
+  free (wl_stmts);
+  free (wl_uses);
+  wl_stmts = wl_uses = NULL;
+  wl_stmts_size = wl_uses_size = 0;
+
+  sweep (mark_free (root));
+  pass_stats_end (PASS_WORKLIST);
+
+  if (verbose > 2) {
+    printf ("\n=== After worklist optimization ===\n\n");
+    print_node (node);
+  }
 }
 
 
+/* Pass 6: Sparse conditional constant propagation
+
+   Replaces the flow-insensitive pass 3 at -O2.  The constants are
+   propagated along the SSA form of every function, see ssa.c, so
+   a definition only reaches the uses it dominates or merges into,
+   and the code behind a branch that is never taken does not count.
+   Returns nonzero if anything was folded. */
+
+static int
+optimize_pass_6 (NODE *node)
+{
+  size_t n;
+
+  optimize_pass_begin (6);
+  n = ssa_sccp (node);
+  rewrites += n;
+  optimize_pass_end (6, node);
+  return n != 0;
+}
+
+
+/* Pass 7: Global value numbering
+
+   Numbers the expressions along the SSA form, see gvn.c, and makes
+   an expression computed again where it is already available read
+   a temporary holding the first result. */
+
+static void
+optimize_pass_7 (NODE *node)
+{
+  optimize_pass_begin (7);
+  rewrites += gvn_run (&root);
+  optimize_pass_end (7, node);
+}
+
+
+/* Pass 8: Loop-invariant code motion
+
+   Moves the expressions that compute the same value on every trip
+   through a loop to temporaries set before it, see licm.c. */
+
+static void
+optimize_pass_8 (NODE *node)
+{
+  optimize_pass_begin (8);
+  rewrites += licm_run (&root);
+  optimize_pass_end (8, node);
+}
+
+
+/* Pass 9: Strength reduction
+
+   Replaces the products of induction variables and constants with
+   temporaries stepped along with the variables, and multiplications,
+   divisions and modulos by powers of two with shifts and masks, see
+   strength.c. */
+
+static void
+optimize_pass_9 (NODE *node)
+{
+  optimize_pass_begin (9);
+  rewrites += strength_run (&root);
+  optimize_pass_end (9, node);
+}
+
+
+/* Pass 10: Function inlining
+
+   Replaces the calls chosen by a cost model with copies of the
+   bodies of the functions, see inline.c.  Returns nonzero if any
+   call was inlined. */
+
+static int
+optimize_pass_10 (NODE *node)
+{
+  size_t n;
+
+  optimize_pass_begin (10);
+  n = inline_run (&root);
+  rewrites += n;
+  optimize_pass_end (10, node);
+  return n != 0;
+}
+
+
+/* Pass 11: Tail recursion elimination
+
+   Turns the functions returning calls to themselves into loops, see
+   tailrec.c. */
+
+static void
+optimize_pass_11 (NODE *node)
+{
+  optimize_pass_begin (11);
+  rewrites += tailrec_run (&root);
+  optimize_pass_end (11, node);
+}
+
+
+/* Pass 12: Compile-time evaluation
+
+   Replaces the calls to pure functions with constant arguments by
+   the values they return, see ceval.c.  Returns nonzero if any call
+   was replaced. */
+
+static int
+optimize_pass_12 (NODE *node)
+{
+  size_t n;
+
+  optimize_pass_begin (12);
+  n = ceval_run (&root);
+  rewrites += n;
+  optimize_pass_end (12, node);
+  return n != 0;
+}
+
+
+/* Pass 13: Equality saturation
+
+   Replaces the pure expressions by the cheapest ones equal to them
+   that a saturated e-graph finds, see egraph.c. */
+
+static void
+optimize_pass_13 (NODE *node)
+{
+  optimize_pass_begin (13);
+  rewrites += egraph_run (&root);
+  optimize_pass_end (13, node);
+}
+
+
+/* Pass 14: N-ary reassociation
+
+   Folds all the constants of a chain of +, *, &, && or || at once
+   and makes it a balanced tree, see reassoc.c. */
+
+static void
+optimize_pass_14 (NODE *node)
+{
+  optimize_pass_begin (14);
+  rewrites += reassoc_run (&root);
+  optimize_pass_end (14, node);
+}
+
+
+/* Pass 15: Value-range analysis
+
+   Folds the comparisons and conditions that the ranges of the values
+   decide, and marks the divisions whose divisor is never 0, see
+   vra.c.  Returns nonzero if anything was folded. */
+
+static int
+optimize_pass_15 (NODE *node)
+{
+  size_t n;
+
+  optimize_pass_begin (15);
+  n = vra_run (&root);
+  rewrites += n;
+  optimize_pass_end (15, node);
+  return n != 0;
+}
+
+
+/* Pass 16: Loop unrolling
+
+   Copies the bodies of the loops counting from a constant to a
+   constant, see unroll.c.  Returns nonzero if any loop was
+   unrolled. */
+
+static int
+optimize_pass_16 (NODE *node)
+{
+  size_t n;
+
+  optimize_pass_begin (16);
+  n = unroll_run (&root);
+  rewrites += n;
+  optimize_pass_end (16, node);
+  return n != 0;
+}
+
+
+/* Pass 17: Dead-store elimination
+
+   Removes the assignments and initializers whose values are never
+   read, see dse.c.  The declarations left without a use go with
+   pass 4. */
+
+static void
+optimize_pass_17 (NODE *node)
+{
+  optimize_pass_begin (17);
+  rewrites += dse_run (&root);
+  optimize_pass_end (17, node);
+}
+
+
+/* Pass 18: Promotion of globals
+
+   Keeps the globals of the loops in temporaries where no call may
+   see them, see promote.c. */
+
+static void
+optimize_pass_18 (NODE *node)
+{
+  optimize_pass_begin (18);
+  rewrites += promote_run (&root);
+  optimize_pass_end (18, node);
+}
+
+
+/* Fold the constants of the tree until nothing changes */
+static void
+optimize_fold (NODE *root)
+{
+  do {
+    if (optimize_reassoc)
+      optimize_pass_14 (root);
+    if (optimize_worklist)
+      optimize_worklist_run (root);
+    else
+      do {
+	optimize_pass_1 (root);
+	optcnt = 0;
+	optimize_pass_2 (root);
+	if (!optimize_sccp)
+	  optimize_pass_3 (root);
+      } while (optcnt);
+  } while ((optimize_sccp && optimize_pass_6 (root))
+	   || (optimize_level > 1 && optimize_ceval
+	       && optimize_pass_12 (root)));
+}
+
+
+
+/* Pass manager
+
+   The passes are known by name, and -fpasses= gives the pipeline to
+   run instead of the one of the optimization level, -O0 included,
+   e.g. `-fpasses=rewrite,fold,cprop,fold,dce'.  Nothing but the passes
+   named runs; the flags turning passes off only apply to `fixpoint',
+   which folds like -O1 and -O2 do. */
+
+static void
+run_sccp (NODE *node)
+{
+  optimize_pass_6 (node);
+}
+
+static void
+run_inline (NODE *node)
+{
+  optimize_pass_10 (node);
+}
+
+static void
+run_ceval (NODE *node)
+{
+  optimize_pass_12 (node);
+}
+
+static void
+run_vra (NODE *node)
+{
+  optimize_pass_15 (node);
+}
+
+static void
+run_unroll (NODE *node)
+{
+  optimize_pass_16 (node);
+}
+
+static void
+run_tailcalls (NODE *node)
+{
+  tailrec_mark (node);
+}
+
+static const struct
+{
+  const char *name;
+  void (*run) (NODE *);
+  int stats;                 /* its slot in pass_stats, or 0 */
+} passes[] = {
+  { "rewrite",   optimize_pass_1,       1 },
+  { "fold",      optimize_pass_2,       2 },
+  { "cprop",     optimize_pass_3,       3 },
+  { "unused",    optimize_pass_4,       4 },
+  { "dce",       optimize_pass_5,       5 },
+  { "sccp",      run_sccp,              6 },
+  { "gvn",       optimize_pass_7,       7 },
+  { "licm",      optimize_pass_8,       8 },
+  { "strength",  optimize_pass_9,       9 },
+  { "inline",    run_inline,           10 },
+  { "tailrec",   optimize_pass_11,     11 },
+  { "ceval",     run_ceval,            12 },
+  { "egraph",    optimize_pass_13,     13 },
+  { "reassoc",   optimize_pass_14,     14 },
+  { "vra",       run_vra,              15 },
+  { "unroll",    run_unroll,           16 },
+  { "dse",       optimize_pass_17,     17 },
+  { "promote",   optimize_pass_18,     18 },
+  { "worklist",  optimize_worklist_run, PASS_WORKLIST },
+  { "fixpoint",  optimize_fold,         0 },
+  { "tailcalls", run_tailcalls,         0 },
+};
+
+#define NPASS_NAMES (sizeof (passes) / sizeof (passes[0]))
+#define MAX_PIPELINE 64
+
+static int pipeline[MAX_PIPELINE];   /* indices in passes */
+static int pipeline_len;
+
+/* Set the pipeline from the comma-separated pass names in LIST.
+   Returns nonzero if a name is not known or there are too many. */
+int
+optimize_set_pipeline (const char *list)
+{
+  const char *end;
+  size_t i, len;
+
+  pipeline_len = 0;
+  for (; *list; list = *end ? end + 1 : end)
+    {
+      end = strchr (list, ',');
+      if (!end)
+	end = list + strlen (list);
+      len = end - list;
+      for (i = 0; i < NPASS_NAMES; i++)
+	if (strlen (passes[i].name) == len
+	    && strncmp (passes[i].name, list, len) == 0)
+	  break;
+      if (i == NPASS_NAMES || pipeline_len == MAX_PIPELINE)
+	return 1;
+      pipeline[pipeline_len++] = i;
+    }
+  return pipeline_len == 0;
+}
+
+/* Print the counters of the passes that ran */
+void
+optimize_print_stats (FILE *fp)
+{
+  struct pass_stats sum;
+  size_t i;
+  int n;
+
+  fprintf (fp, "\n=== Pass statistics ===\n\n");
+  fprintf (fp, "%-16s %10s %10s %10s %10s %10s\n",
+	   "Pass", "runs", "msec", "traversed", "changed", "freed");
+
+  memset (&sum, 0, sizeof (sum));
+  for (n = 1; n < NPASSES; n++)
+    {
+      struct pass_stats *st = &pass_stats[n];
+
+      if (!st->runs)
+	continue;
+      for (i = 0; passes[i].stats != n; i++)
+	;
+      fprintf (fp, "%-16s %10lu %10.3f %10lu %10lu %10lu\n",
+	       passes[i].name, st->runs, st->msec, st->traversed,
+	       st->changed, st->freed);
+      sum.runs += st->runs;
+      sum.msec += st->msec;
+      sum.traversed += st->traversed;
+      sum.changed += st->changed;
+      sum.freed += st->freed;
+    }
+  fprintf (fp, "%-16s %10lu %10.3f %10lu %10lu %10lu\n", "Total",
+	   sum.runs, sum.msec, sum.traversed, sum.changed, sum.freed);
+}
+
 /* Entry point */
 void
 optimize_tree (NODE *root)
 {
+  int i;
+
+  if (optimize_sccp < 0)
+    optimize_sccp = optimize_level > 1;
+
+  /* An explicit pipeline runs at any level, -O0 included */
+  if (pipeline_len)
+    {
+      for (i = 0; i < pipeline_len; i++)
+	passes[pipeline[i]].run (root);
+      return;
+    }
   if (optimize_level == 0)
     return;
-  
-  do {
-    optimize_pass_1 (root);
-    optcnt = 0;
-    optimize_pass_2 (root);
-    optimize_pass_3 (root);
-  } while (optcnt);
+
+  optimize_fold (root);
 
   if (optimize_level > 1)
     {
+      /* A function without recursion left may be inlined */
+      if (optimize_tailrec)
+	optimize_pass_11 (root);
+      /* The calls with constant arguments fold in the copies */
+      if (optimize_inline && optimize_pass_10 (root))
+	optimize_fold (root);
+      /* The counter reads in the copies fold to constants */
+      if (optimize_unroll && optimize_pass_16 (root))
+	optimize_fold (root);
+      /* The branches the ranges decide go with the dead code */
+      if (optimize_vra && optimize_pass_15 (root))
+	optimize_fold (root);
+      if (optimize_level > 2 && optimize_egraph)
+	optimize_pass_13 (root);
+      if (optimize_dce)
+	optimize_pass_5 (root);
+      /* The loops read the temporaries, which licm may hoist from */
+      if (optimize_promote)
+	optimize_pass_18 (root);
+      if (optimize_licm)
+	optimize_pass_8 (root);
+      if (optimize_gvn)
+	optimize_pass_7 (root);
+      if (optimize_strength)
+	optimize_pass_9 (root);
+      if (optimize_dse)
+	optimize_pass_17 (root);
       optimize_pass_4 (root);
-      optimize_pass_5 (root);
+      if (optimize_tailrec)
+	tailrec_mark (root);
     }
 }
-
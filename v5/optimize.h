@@ -20,6 +20,28 @@
 #ifndef _OPTIMIZE_H
 #define _OPTIMIZE_H
 
+#include <stdio.h>
+
+extern int optimize_worklist; /* run passes 1-3 from a worklist */
+extern int optimize_sccp;     /* SCCP instead of pass 3, -1 for default */
+extern int optimize_dce;      /* dead code elimination at -O2 */
+extern int optimize_gvn;      /* global value numbering at -O2 */
+extern int optimize_licm;     /* loop-invariant code motion at -O2 */
+extern int optimize_strength; /* strength reduction at -O2 */
+extern int optimize_inline;   /* function inlining at -O2 */
+extern int optimize_tailrec;  /* tail recursion elimination at -O2 */
+extern int optimize_ceval;    /* compile-time evaluation at -O2 */
+extern int optimize_egraph;   /* equality saturation at -O3 */
+extern int optimize_reassoc;  /* n-ary reassociation at -O1 */
+extern int optimize_vra;      /* value-range analysis at -O2 */
+extern int optimize_unroll;   /* loop unrolling at -O2 */
+extern int optimize_dse;      /* dead-store elimination at -O2 */
+extern int optimize_promote;  /* promotion of globals at -O2 */
+
+extern traverse_fp unlink_fptab[];
+
+int optimize_set_pipeline (const char *);
+void optimize_print_stats (FILE *);
 void optimize_tree (NODE *);
 
 #endif /* _OPTIMIZE_H */
@@ -0,0 +1,400 @@
+/*
+   V5: promote.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "ipa.h"
+#include "ptrmap.h"
+#include "motion.h"
+#include "promote.h"
+
+extern int verbose;
+
+/*
+  Promotion of globals.
+
+  A global variable read or written in a loop is kept in the data
+  area, where every access goes, since a call could read or change
+  it.  The mod and ref sets of the functions, see ipa.c, tell which
+  calls may.  When no call in the loop may write the global, and
+  none may read it if the loop writes it, the loop works on a copy
+  in a new automatic temporary instead: the temporary is declared
+  with the value of the global before the loop, and if the loop
+  writes it, stored back to the global wherever the loop is left,
+  after it and before each `return' and jump out of it.
+
+  A loop declaring the global or a function is left alone.  The
+  outermost loop that may keep a global in a temporary does; the
+  loops inside the others are tried in turn.
+*/
+
+static int level;                 /* level of new temporaries */
+static size_t npromoted, nstores;
+
+static SYMBOL **globals;          /* globals the loop refers to */
+static size_t nglobals, globals_size;
+static SYMBOL **callees;          /* functions the loop calls */
+static size_t ncallees, callees_size;
+static struct ptrmap seen;        /* symbol -> 1 if in the above */
+static struct ptrmap written;     /* global -> 1 if the loop writes it */
+static struct ptrmap declared;    /* global -> 1 if the loop declares it */
+static int has_function;          /* the loop declares a function */
+static struct ptrmap stores;      /* the stores back to the globals */
+
+static SYMBOL *from, *to;         /* renaming of the loop */
+
+/* The store of the temporary back to the global */
+static NODE *
+new_store (void)
+{
+  NODE *node = make_asgn (from, make_expr (make_var (to)));
+
+  ptrmap_put (&stores, node, 0, node);
+  nstores++;
+  return node;
+}
+
+
+/* What a loop refers to */
+
+static void
+note_global (SYMBOL *s)
+{
+  if (!s || s->v.var->qualifier != QUA_GLOBAL || ptrmap_get (&seen, s, 0))
+    return;
+  ptrmap_put (&seen, s, 0, s);
+  if (nglobals == globals_size)
+    {
+      globals_size = globals_size ? globals_size * 2 : 8;
+      globals = xrealloc (globals, globals_size * sizeof (*globals));
+    }
+  globals[nglobals++] = s;
+}
+
+static void
+note_var (NODE *node)
+{
+  note_global (node->v.symbol);
+}
+
+static void
+note_call (NODE *node)
+{
+  SYMBOL *s = node->v.funcall.symbol;
+
+  if (ptrmap_get (&seen, s, 0))
+    return;
+  ptrmap_put (&seen, s, 0, s);
+  if (ncallees == callees_size)
+    {
+      callees_size = callees_size ? callees_size * 2 : 8;
+      callees = xrealloc (callees, callees_size * sizeof (*callees));
+    }
+  callees[ncallees++] = s;
+}
+
+traverse_fp promote_scan_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  note_var,    /* NODE_VAR */
+  note_call,   /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+/* Apply FPTAB to the arguments of the call statement NODE */
+static void
+traverse_args (NODE *node, traverse_fp *fptab)
+{
+  ARGLIST *arg;
+
+  for (arg = node->v.funcall.args; arg; arg = arg->next)
+    traverse_expr (arg->node, fptab);
+}
+
+/* Note what the statements from NODE refer to.  The stores back of
+   an enclosing loop stay where they are. */
+static void
+scan_list (NODE *node)
+{
+  for (; node; node = node->right)
+    switch (node->type) {
+    case NODE_ASGN:
+      if (ptrmap_get (&stores, node, 0))
+	break;
+      traverse_expr (node->v.asgn.expr, promote_scan_fptab);
+      note_global (node->v.asgn.symbol);
+      ptrmap_put (&written, node->v.asgn.symbol, 0, node);
+      break;
+    case NODE_VAR_DECL:
+      if (node->v.vardecl.expr)
+	traverse_expr (node->v.vardecl.expr, promote_scan_fptab);
+      if (node->v.vardecl.symbol)
+	ptrmap_put (&declared, node->v.vardecl.symbol, 0, node);
+      break;
+    case NODE_CALL:
+      traverse_args (node, promote_scan_fptab);
+      note_call (node);
+      break;
+    case NODE_EXPR:
+      traverse_expr (node->v.expr, promote_scan_fptab);
+      break;
+    case NODE_PRINT:
+    case NODE_RETURN:
+      if (node->v.expr)
+	traverse_expr (node->v.expr, promote_scan_fptab);
+      break;
+    case NODE_COMPOUND:
+      scan_list (node->v.expr);
+      break;
+    case NODE_ITERATION:
+      traverse_expr (node->v.iteration.cond, promote_scan_fptab);
+      scan_list (node->v.iteration.stmt);
+      break;
+    case NODE_CONDITION:
+      traverse_expr (node->v.condition.cond, promote_scan_fptab);
+      scan_list (node->v.condition.iftrue_stmt);
+      scan_list (node->v.condition.iffalse_stmt);
+      break;
+    case NODE_FNC_DECL:
+      has_function = 1;
+      break;
+    default:
+      break;
+    }
+}
+
+/* May the loop keep the global S in a temporary? */
+static int
+promotable (SYMBOL *s)
+{
+  int writes = ptrmap_get (&written, s, 0) != NULL;
+  size_t i;
+
+  if (ptrmap_get (&declared, s, 0))
+    return 0;
+  for (i = 0; i < ncallees; i++)
+    if (ipa_may_write (callees[i], s)
+	|| (writes && ipa_may_read (callees[i], s)))
+      return 0;
+  return 1;
+}
+
+
+/* Renaming */
+
+static void
+rename_var (NODE *node)
+{
+  if (node->v.symbol == from)
+    {
+      du_unlink (node);
+      node->v.symbol = to;
+      du_link (node, to);
+    }
+}
+
+traverse_fp promote_rename_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  rename_var,  /* NODE_VAR */
+  NULL,        /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+/* Make the statements from NODE, DEPTH loops deep in the loop, use
+   the temporary; if STORE, store it back before leaving the loop */
+static void
+rename_list (NODE *node, unsigned depth, int store)
+{
+  for (; node; node = node->right)
+    switch (node->type) {
+    case NODE_ASGN:
+      traverse_expr (node->v.asgn.expr, promote_rename_fptab);
+      if (node->v.asgn.symbol == from)
+	{
+	  du_unlink (node);
+	  node->v.asgn.symbol = to;
+	  du_link (node, to);
+	}
+      break;
+    case NODE_VAR_DECL:
+      if (node->v.vardecl.expr)
+	traverse_expr (node->v.vardecl.expr, promote_rename_fptab);
+      break;
+    case NODE_CALL:
+      traverse_args (node, promote_rename_fptab);
+      break;
+    case NODE_EXPR:
+      traverse_expr (node->v.expr, promote_rename_fptab);
+      break;
+    case NODE_PRINT:
+      traverse_expr (node->v.expr, promote_rename_fptab);
+      break;
+    case NODE_RETURN:
+      if (node->v.expr)
+	traverse_expr (node->v.expr, promote_rename_fptab);
+      if (store)
+	motion_insert_before (node, new_store ());
+      break;
+    case NODE_JUMP:
+      if (store && (node->v.jump.level ? node->v.jump.level : 1) > depth)
+	motion_insert_before (node, new_store ());
+      break;
+    case NODE_COMPOUND:
+      rename_list (node->v.expr, depth, store);
+      break;
+    case NODE_ITERATION:
+      traverse_expr (node->v.iteration.cond, promote_rename_fptab);
+      rename_list (node->v.iteration.stmt, depth + 1, store);
+      break;
+    case NODE_CONDITION:
+      traverse_expr (node->v.condition.cond, promote_rename_fptab);
+      rename_list (node->v.condition.iftrue_stmt, depth, store);
+      rename_list (node->v.condition.iffalse_stmt, depth, store);
+      break;
+    default:
+      break;
+    }
+}
+
+/* Keep the global S in a temporary in LOOP */
+static void
+promote (NODE *loop, SYMBOL *s)
+{
+  int store = ptrmap_get (&written, s, 0) != NULL;
+  NODE *decl;
+
+  from = s;
+  to = make_temp (level);
+  if (verbose > 1)
+    printf ("Promoting global %s to %s in loop, node %4.4lu%s\n",
+	    s->name, to->name, loop->node_id, store ? " (stored back)" : "");
+
+  decl = make_decl (to, make_expr (make_var (s)));
+  motion_insert_before (loop, decl);
+
+  traverse_expr (loop->v.iteration.cond, promote_rename_fptab);
+  rename_list (loop->v.iteration.stmt, 0, store);
+  if (store)
+    motion_insert_after (loop, new_store ());
+  npromoted++;
+}
+
+/* Promote the globals LOOP may keep in temporaries */
+static void
+promote_loop (NODE *loop)
+{
+  size_t i, n;
+
+  nglobals = ncallees = 0;
+  has_function = 0;
+  traverse_expr (loop->v.iteration.cond, promote_scan_fptab);
+  scan_list (loop->v.iteration.stmt);
+
+  if (!has_function)
+    for (i = 0, n = nglobals; i < n; i++)
+      if (promotable (globals[i]))
+	promote (loop, globals[i]);
+
+  ptrmap_free (&seen);
+  ptrmap_free (&written);
+  ptrmap_free (&declared);
+}
+
+static void
+promote_list (NODE *node)
+{
+  int saved_level;
+
+  for (; node; node = node->right)
+    switch (node->type) {
+    case NODE_COMPOUND:
+      promote_list (node->v.expr);
+      break;
+    case NODE_ITERATION:
+      promote_loop (node);
+      promote_list (node->v.iteration.stmt);
+      break;
+    case NODE_CONDITION:
+      promote_list (node->v.condition.iftrue_stmt);
+      promote_list (node->v.condition.iffalse_stmt);
+      break;
+    case NODE_FNC_DECL:
+      saved_level = level;
+      level = 1;
+      promote_list (node->v.fncdecl.stmt);
+      level = saved_level;
+      break;
+    default:
+      break;
+    }
+}
+
+/* Keep the globals of the loops of the program rooted at *ROOTP in
+   temporaries where no call may see them.  Returns the number of
+   globals promoted. */
+size_t
+promote_run (NODE **rootp)
+{
+  npromoted = nstores = 0;
+  level = 0;
+  ipa_analyze (*rootp);
+  motion_begin (rootp);
+  promote_list (*rootp);
+  motion_end ();
+  ipa_free ();
+  ptrmap_free (&stores);
+
+  free (globals);
+  globals = NULL;
+  globals_size = 0;
+  free (callees);
+  callees = NULL;
+  callees_size = 0;
+
+  if (verbose > 1)
+    printf ("Promoted globals: %lu, %lu stores back\n",
+	    (unsigned long) npromoted, (unsigned long) nstores);
+  return npromoted;
+}
@@ -0,0 +1,105 @@
+/*
+   V5: ptrmap.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "ptrmap.h"
+
+/* Open addressing with linear probing; NULL keys mark empty slots.
+   The load factor is kept at or below 1/2. */
+
+static size_t
+ptrmap_hash (const void *key, size_t sub)
+{
+  uintptr_t h = (uintptr_t) key;
+
+  h ^= h >> 4;
+  h = h * 0x9e3779b97f4a7c15ULL + sub;
+  h ^= h >> 29;
+  return (size_t) h;
+}
+
+static struct ptrmap_entry *
+ptrmap_slot (struct ptrmap *m, const void *key, size_t sub)
+{
+  size_t mask = m->size - 1;
+  size_t i = ptrmap_hash (key, sub) & mask;
+
+  while (m->tab[i].key && (m->tab[i].key != key || m->tab[i].sub != sub))
+    i = (i + 1) & mask;
+  return &m->tab[i];
+}
+
+static void
+ptrmap_grow (struct ptrmap *m)
+{
+  struct ptrmap_entry *old = m->tab;
+  size_t i, old_size = m->size;
+
+  m->size = m->size ? m->size * 2 : 64;
+  m->tab = calloc (m->size, sizeof (*m->tab));
+  if (!m->tab)
+    exit (EXIT_FAILURE);
+
+  for (i = 0; i < old_size; i++)
+    if (old[i].key)
+      *ptrmap_slot (m, old[i].key, old[i].sub) = old[i];
+  free (old);
+}
+
+void
+ptrmap_init (struct ptrmap *m)
+{
+  m->tab = NULL;
+  m->size = m->count = 0;
+}
+
+void
+ptrmap_free (struct ptrmap *m)
+{
+  free (m->tab);
+  ptrmap_init (m);
+}
+
+void *
+ptrmap_get (struct ptrmap *m, const void *key, size_t sub)
+{
+  if (m->size == 0)
+    return NULL;
+  return ptrmap_slot (m, key, sub)->value;
+}
+
+void
+ptrmap_put (struct ptrmap *m, const void *key, size_t sub, void *value)
+{
+  struct ptrmap_entry *e;
+
+  if (2 * (m->count + 1) > m->size)
+    ptrmap_grow (m);
+
+  e = ptrmap_slot (m, key, sub);
+  if (!e->key)
+    {
+      e->key = key;
+      e->sub = sub;
+      m->count++;
+    }
+  e->value = value;
+}
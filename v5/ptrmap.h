@@ -0,0 +1,47 @@
+/*
+   V5: ptrmap.h
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _PTRMAP_H
+#define _PTRMAP_H
+
+#include <stddef.h>
+
+/* A hash map from a pointer and an optional index to a pointer,
+   for the analyses that attach data to nodes and symbols. */
+
+struct ptrmap_entry
+{
+  const void *key;
+  size_t sub;
+  void *value;
+};
+
+struct ptrmap
+{
+  struct ptrmap_entry *tab;
+  size_t size;        /* power of two, or 0 */
+  size_t count;
+};
+
+void ptrmap_init (struct ptrmap *);
+void ptrmap_free (struct ptrmap *);
+void *ptrmap_get (struct ptrmap *, const void *, size_t);
+void ptrmap_put (struct ptrmap *, const void *, size_t, void *);
+
+#endif /* not _PTRMAP_H */
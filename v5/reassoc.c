@@ -0,0 +1,466 @@
+/*
+   V5: reassoc.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "rewrite.h"
+#include "reassoc.h"
+
+extern int verbose;
+
+/*
+  N-ary reassociation.
+
+  A chain of one associative and commutative operator, `1 + a + 2 +
+  b + 3', is taken as the list of its operands, 1, a, 2, b and 3.
+  Its constants are folded into one at once, wherever they are in
+  the chain, and the chain is built again as a balanced tree with
+  that constant on the left of its root, (6 + ((a + b))), which is
+  the form the rules of pass 1 keep.  A chain of n operands is done
+  in one walk over it, where the rules would need n rounds to bring
+  the constants of a long one together.
+
+  The chains of +, * and & fold their constants, drop the identity
+  and, if the other operands are pure, let the absorbing 0 of * and
+  & stand for the whole.  The operands are evaluated left to right,
+  so the others are sorted, variables by name first, only when none
+  of them calls a function; the constants go to the front either
+  way.  The chains of && and || are only worked on when all their
+  operands are pure, as the operands after the one deciding are not
+  evaluated.  Their constants decide the chain or are dropped, the
+  operands met twice are dropped, and what is left alone is made a
+  truth value by 0 != X.
+
+  The nodes of the chain are used again for the new tree, so it
+  stays in place, and what is left over is freed by the sweep.
+*/
+
+static NODE **leaves;             /* operands of the chains, a stack */
+static size_t nleaves, leaves_size;
+static NODE **inner;              /* their operator nodes */
+static size_t ninner, inner_size;
+static size_t nchains;            /* chains built again */
+
+static int
+chain_op (NODE *node)
+{
+  if (node->type != NODE_BINOP)
+    return 0;
+  switch (node->v.opcode) {
+  case OPCODE_ADD:
+  case OPCODE_MUL:
+  case OPCODE_BAND:
+  case OPCODE_AND:
+  case OPCODE_OR:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+static int
+has_call (NODE *node)
+{
+  switch (node->type) {
+  case NODE_UNOP:
+    return has_call (node->left);
+  case NODE_BINOP:
+    return has_call (node->left) || has_call (node->right);
+  case NODE_EXPR:
+    return has_call (node->v.expr);
+  case NODE_CONST:
+  case NODE_VAR:
+    return 0;
+  default:
+    return 1;
+  }
+}
+
+static int
+same_tree (NODE *a, NODE *b)
+{
+  if (a->type != b->type)
+    return 0;
+  switch (a->type) {
+  case NODE_CONST:
+    return a->v.number == b->v.number;
+  case NODE_VAR:
+    return a->v.symbol == b->v.symbol;
+  case NODE_UNOP:
+    return a->v.opcode == b->v.opcode && same_tree (a->left, b->left);
+  case NODE_BINOP:
+    return a->v.opcode == b->v.opcode && same_tree (a->left, b->left)
+      && same_tree (a->right, b->right);
+  default:
+    return 0;
+  }
+}
+
+/* Push the operands and the operator nodes of the chain of OP at
+   NODE, left to right.  Returns the depth of the chain. */
+static int
+flatten (NODE *node, enum opcode_type op)
+{
+  int l, r;
+
+  if (node->type != NODE_BINOP || node->v.opcode != op)
+    {
+      if (nleaves == leaves_size)
+	{
+	  leaves_size = leaves_size ? leaves_size * 2 : 256;
+	  leaves = xrealloc (leaves, leaves_size * sizeof (*leaves));
+	}
+      leaves[nleaves++] = node;
+      return 0;
+    }
+  if (ninner == inner_size)
+    {
+      inner_size = inner_size ? inner_size * 2 : 256;
+      inner = xrealloc (inner, inner_size * sizeof (*inner));
+    }
+  inner[ninner++] = node;
+  l = flatten (node->left, op);
+  r = flatten (node->right, op);
+  return 1 + (l > r ? l : r);
+}
+
+/* The order of the operands of a chain without calls */
+static int
+rank (NODE *node)
+{
+  switch (node->type) {
+  case NODE_VAR:
+    return 0;
+  case NODE_UNOP:
+    return 1;
+  case NODE_BINOP:
+    return 2 + node->v.opcode;
+  default:
+    return 3 + OPCODE_BAND;
+  }
+}
+
+static int
+before (NODE *a, NODE *b)
+{
+  int c = rank (a) - rank (b);
+
+  if (c == 0 && a->type == NODE_VAR)
+    c = strcmp (a->v.symbol->name, b->v.symbol->name);
+  return c < 0;
+}
+
+/* A stable merge sort of V[0] to V[N - 1], using T as much */
+static void
+sort_operands (NODE **v, NODE **t, size_t n)
+{
+  size_t h = n / 2, i, j, k;
+
+  if (n < 2)
+    return;
+  sort_operands (v, t, h);
+  sort_operands (v + h, t, n - h);
+  memcpy (t, v, h * sizeof (*t));
+  for (i = 0, j = h, k = 0; i < h; k++)
+    if (j < n && before (v[j], t[i]))
+      v[k] = v[j++];
+    else
+      v[k] = t[i++];
+}
+
+static unsigned long
+fold (enum opcode_type op, unsigned long a, unsigned long b)
+{
+  switch (op) {
+  case OPCODE_ADD:
+    return a + b;
+  case OPCODE_MUL:
+    return a * b;
+  default:
+    return a & b;
+  }
+}
+
+/* Build the operands V[0] to V[N - 1] into a balanced tree of OP,
+   taking the operator nodes from *NEXT on */
+static NODE *
+build (enum opcode_type op, NODE **v, size_t n, NODE ***next)
+{
+  NODE *node;
+
+  if (n == 1)
+    return v[0];
+  node = *(*next)++;
+  node->v.opcode = op;
+  node->left = build (op, v, n / 2, next);
+  node->right = build (op, v + n / 2, n - n / 2, next);
+  return node;
+}
+
+static int
+depth_of (size_t n)
+{
+  int d = 0;
+
+  while (((size_t) 1 << d) < n)
+    d++;
+  return d;
+}
+
+/* Move BY into the root NODE of a chain */
+static void
+replace (NODE *node, NODE *by)
+{
+  SYMBOL *symbol = by->du_symbol;
+
+  du_unlink (by);
+  node->type = by->type;
+  node->left = by->left;
+  node->right = by->right;
+  node->v = by->v;
+  node->safe_div = by->safe_div;
+  if (symbol)
+    du_link (node, symbol);
+  by->type = NODE_NOOP;
+  by->left = by->right = NULL;
+}
+
+/* A constant computed where ROOT is */
+static NODE *
+const_at (NODE *root, long number)
+{
+  NODE *node = make_const (number);
+
+  node->order = root->order;
+  return node;
+}
+
+static void reassoc_expr (NODE *);
+
+/* Build again the chain whose operands are the leaves from BASE on
+   and whose operator nodes are the inner nodes from IBASE on */
+static void
+reassoc_chain (NODE *root, size_t base, size_t ibase, int depth)
+{
+  enum opcode_type op = root->v.opcode;
+  int logic = op == OPCODE_AND || op == OPCODE_OR;
+  size_t n = nleaves - base, i, k, nconst = 0;
+  NODE **v, **next, *c = NULL;
+  unsigned long value = 0;
+  int pure = 1, calls = 0, dropped = 0, changed;
+
+  for (i = base; i < nleaves; i++)
+    {
+      if (leaves[i]->type == NODE_CONST)
+	{
+	  if (nconst++ == 0)
+	    {
+	      c = leaves[i];
+	      value = c->v.number;
+	    }
+	  else
+	    value = fold (op, value, leaves[i]->v.number);
+	}
+      else
+	{
+	  pure &= rewrite_pure (leaves[i]);
+	  calls |= has_call (leaves[i]);
+	}
+    }
+  if (logic && !pure)
+    return;
+
+  v = xrealloc (NULL, n * sizeof (*v));
+  for (i = base, k = 0; i < nleaves; i++)
+    if (leaves[i]->type != NODE_CONST)
+      v[k++] = leaves[i];
+  n = k;
+  if (!calls && n > 1)
+    {
+      NODE **t = xrealloc (NULL, n / 2 * sizeof (*t));
+      sort_operands (v, t, n);
+      free (t);
+    }
+
+  if (logic)
+    {
+      /* A constant deciding the chain, 0 of && and not 0 of ||;
+	 the others do not count */
+      for (i = base, c = NULL; i < nleaves && !c; i++)
+	if (leaves[i]->type == NODE_CONST
+	    && (leaves[i]->v.number != 0) == (op == OPCODE_OR))
+	  c = leaves[i];
+      dropped = nconst > 0;
+      for (i = k = 0; i < n; i++)
+	if (k > 0 && same_tree (v[i], v[k - 1]))
+	  {
+	    rewrite_drop (v[i]);
+	    dropped = 1;
+	  }
+	else
+	  v[k++] = v[i];
+      n = k;
+    }
+  else if (nconst)
+    {
+      c->v.number = value;
+      if ((op == OPCODE_ADD && value == 0)
+	  || (op == OPCODE_MUL && value == 1)
+	  || (op == OPCODE_BAND && (long) value == -1))
+	c = NULL;
+      dropped = nconst > 1 || !c;
+    }
+
+  /* Nothing to do for a chain sorted, folded and balanced already */
+  changed = dropped || (c && leaves[base] != c)
+    || depth > depth_of (n) + (c != NULL);
+  for (i = 0, k = base + (c != NULL); i < n && !changed; i++, k++)
+    changed = leaves[k] != v[i];
+  if (!changed)
+    {
+      free (v);
+      return;
+    }
+
+  if (verbose > 1)
+    printf ("Reassociating node %4.4lu: %lu operands, %lu constants\n",
+	    root->node_id, (unsigned long) (nleaves - base),
+	    (unsigned long) nconst);
+  nchains++;
+
+  if (logic && c)
+    {
+      /* The constant decides */
+      for (i = 0; i < n; i++)
+	rewrite_drop (v[i]);
+      replace (root, const_at (root, op == OPCODE_OR));
+    }
+  else if (!logic && c && c->v.number == 0 && pure)
+    {
+      /* 0 * X and 0 & X */
+      for (i = 0; i < n; i++)
+	rewrite_drop (v[i]);
+      replace (root, c);
+    }
+  else if (n == 0)
+    replace (root, const_at (root, logic ? op == OPCODE_AND
+			     : c ? (long) c->v.number
+			     : op == OPCODE_ADD ? 0
+			     : op == OPCODE_MUL ? 1 : -1));
+  else if (n == 1 && !c)
+    {
+      if (logic && !rewrite_bool (v[0]))
+	{
+	  root->v.opcode = OPCODE_NE;
+	  root->left = const_at (root, 0);
+	  root->right = v[0];
+	}
+      else
+	replace (root, v[0]);
+    }
+  else if (c)
+    {
+      next = inner + ibase + 1;
+      root->left = c;
+      root->right = build (op, v, n, &next);
+    }
+  else
+    {
+      next = inner + ibase;
+      build (op, v, n, &next);
+    }
+  free (v);
+}
+
+/* Work on the chains in the expression NODE, the inner ones first */
+static void
+reassoc_expr (NODE *node)
+{
+  size_t base, ibase, i;
+  int depth;
+
+  switch (node->type) {
+  case NODE_UNOP:
+    reassoc_expr (node->left);
+    return;
+  case NODE_BINOP:
+    if (chain_op (node))
+      break;
+    reassoc_expr (node->left);
+    reassoc_expr (node->right);
+    return;
+  default:
+    /* The arguments of the calls are expressions of their own */
+    return;
+  }
+
+  base = nleaves;
+  ibase = ninner;
+  depth = flatten (node, node->v.opcode);
+  for (i = base; i < nleaves; i++)
+    reassoc_expr (leaves[i]);
+  reassoc_chain (node, base, ibase, depth);
+  nleaves = base;
+  ninner = ibase;
+}
+
+static void
+reassoc_node (NODE *node)
+{
+  reassoc_expr (node->v.expr);
+}
+
+traverse_fp reassoc_fptab[] = {
+  NULL,         /* NODE_NOOP */
+  NULL,         /* NODE_UNOP */
+  NULL,         /* NODE_BINOP */
+  NULL,         /* NODE_CONST */
+  NULL,         /* NODE_VAR */
+  NULL,         /* NODE_CALL */
+  NULL,         /* NODE_ASGN */
+  reassoc_node, /* NODE_EXPR */
+  NULL,         /* NODE_RETURN */
+  NULL,         /* NODE_PRINT */
+  NULL,         /* NODE_JUMP */
+  NULL,         /* NODE_COMPOUND  */
+  NULL,         /* NODE_ITERATION */
+  NULL,         /* NODE_CONDITION */
+  NULL,         /* NODE_VAR_DECL */
+  NULL,         /* NODE_FNC_DECL */
+};
+
+size_t
+reassoc_run (NODE **rootp)
+{
+  nchains = 0;
+  traverse (*rootp, reassoc_fptab);
+
+  free (leaves);
+  free (inner);
+  leaves = inner = NULL;
+  nleaves = leaves_size = ninner = inner_size = 0;
+
+  if (verbose > 1)
+    printf ("Reassociation: %lu chains\n", (unsigned long) nchains);
+  return nchains;
+}
@@ -0,0 +1,199 @@
+/*
+   V5: rewrite.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "rewrite.h"
+
+extern int verbose;
+
+/*
+  Algebraic rewriting.
+
+  The rules of rewrite.rules are compiled by rulegen into
+  rewrite_match, which applies the first rule matching a node in
+  place.  The functions below are what the rules are built of.  The
+  nodes a rule builds are rewritten in turn before they are used, so
+  the result of a rule is rewritten throughout, not only at its top.
+*/
+
+/* Rules applied to a node in a row at most, in case some of them
+   ever undo each other */
+#define REWRITE_LIMIT 64
+
+static size_t rewritten;
+static unsigned long order;   /* of the statement, for the new nodes */
+
+size_t
+rewrite_node (NODE *node)
+{
+  size_t before = rewritten;
+  int n;
+
+  order = node->order;
+  for (n = 0; n < REWRITE_LIMIT; n++)
+    if (!rewrite_match (node))
+      break;
+  return rewritten - before;
+}
+
+/* An expression worth 0 or 1 */
+int
+rewrite_bool (NODE *node)
+{
+  switch (node->type) {
+  case NODE_CONST:
+    return node->v.number == 0 || node->v.number == 1;
+  case NODE_UNOP:
+    return node->v.opcode == OPCODE_NOT;
+  case NODE_BINOP:
+    switch (node->v.opcode) {
+    case OPCODE_AND:
+    case OPCODE_OR:
+    case OPCODE_EQ:
+    case OPCODE_NE:
+    case OPCODE_LT:
+    case OPCODE_GT:
+    case OPCODE_LE:
+    case OPCODE_GE:
+      return 1;
+    default:
+      return 0;
+    }
+  default:
+    return 0;
+  }
+}
+
+/* An expression without calls or divisions that may fail, which may
+   be dropped or evaluated in another order */
+int
+rewrite_pure (NODE *node)
+{
+  switch (node->type) {
+  case NODE_CONST:
+  case NODE_VAR:
+    return 1;
+  case NODE_UNOP:
+    return rewrite_pure (node->left);
+  case NODE_BINOP:
+    if ((node->v.opcode == OPCODE_DIV || node->v.opcode == OPCODE_MOD)
+	&& (node->right->type != NODE_CONST || node->right->v.number == 0))
+      return 0;
+    return rewrite_pure (node->left) && rewrite_pure (node->right);
+  default:
+    return 0;
+  }
+}
+
+NODE *
+rewrite_const (long number)
+{
+  NODE *node = addnode (NODE_CONST);
+  node->order = order;
+  node->v.number = number;
+  return node;
+}
+
+NODE *
+rewrite_unop (enum opcode_type opcode, NODE *operand)
+{
+  NODE *node = addnode (NODE_UNOP);
+  node->order = order;
+  node->v.opcode = opcode;
+  node->left = operand;
+  rewrite_node (node);
+  return node;
+}
+
+NODE *
+rewrite_binop (enum opcode_type opcode, NODE *left, NODE *right)
+{
+  NODE *node = addnode (NODE_BINOP);
+  node->order = order;
+  node->v.opcode = opcode;
+  node->left = left;
+  node->right = right;
+  rewrite_node (node);
+  return node;
+}
+
+traverse_fp rewrite_drop_fptab[] = {
+  du_unlink, /* NODE_NOOP */
+  du_unlink, /* NODE_UNOP */
+  du_unlink, /* NODE_BINOP */
+  du_unlink, /* NODE_CONST */
+  du_unlink, /* NODE_VAR */
+  du_unlink, /* NODE_CALL */
+  du_unlink, /* NODE_ASGN */
+  du_unlink, /* NODE_EXPR */
+  du_unlink, /* NODE_RETURN */
+  du_unlink, /* NODE_PRINT */
+  du_unlink, /* NODE_JUMP */
+  du_unlink, /* NODE_COMPOUND  */
+  du_unlink, /* NODE_ITERATION */
+  du_unlink, /* NODE_CONDITION */
+  du_unlink, /* NODE_VAR_DECL */
+  du_unlink  /* NODE_FNC_DECL */
+};
+
+/* An operand the rule left out; the sweep frees it */
+void
+rewrite_drop (NODE *node)
+{
+  traverse_expr (node, rewrite_drop_fptab);
+}
+
+/* A node of the pattern */
+void
+rewrite_free (NODE *node)
+{
+  freenode (node);
+}
+
+/* Move the result BY of the rule at LINE into NODE */
+int
+rewrite_replace (NODE *node, NODE *by, int line)
+{
+  SYMBOL *symbol = by->du_symbol;
+
+  if (verbose > 1)
+    printf ("Rewriting node %4.4lu (rewrite.rules:%d)\n",
+	    node->node_id, line);
+
+  du_unlink (node);
+  du_unlink (by);
+  node->type = by->type;
+  node->left = by->left;
+  node->right = by->right;
+  node->v = by->v;
+  node->safe_div = by->safe_div;
+  if (symbol)
+    du_link (node, symbol);
+
+  /* The arguments of a call went along */
+  by->type = NODE_NOOP;
+  by->left = by->right = NULL;
+  freenode (by);
+  rewritten++;
+  return line;
+}
@@ -0,0 +1,46 @@
+/*
+   V5: rewrite.h
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _REWRITE_H
+#define _REWRITE_H
+
+#include "tree.h"
+
+size_t rewrite_node (NODE *);
+
+/* For the matcher that rulegen generates from rewrite.rules */
+
+/* The keys the matcher switches on: the type of a node, and the
+   operator of the operations */
+#define RW_TYPE(t) ((int) (t) << 5)
+#define RW_OP(t, op) (RW_TYPE (t) | (int) (op))
+#define RW_KEY(n) ((n)->type == NODE_BINOP || (n)->type == NODE_UNOP \
+		   ? RW_OP ((n)->type, (n)->v.opcode) : RW_TYPE ((n)->type))
+
+int rewrite_match (NODE *);
+int rewrite_bool (NODE *);
+int rewrite_pure (NODE *);
+NODE *rewrite_const (long);
+NODE *rewrite_unop (enum opcode_type, NODE *);
+NODE *rewrite_binop (enum opcode_type, NODE *, NODE *);
+void rewrite_drop (NODE *);
+void rewrite_free (NODE *);
+int rewrite_replace (NODE *, NODE *, int);
+
+#endif /* not _REWRITE_H */
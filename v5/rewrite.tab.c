@@ -0,0 +1,1240 @@
+/* Generated by rulegen from rewrite.rules, do not edit */
+
+#include <stdlib.h>
+
+#include "tree.h"
+#include "rewrite.h"
+
+/* Apply the first of the 58 rules matching NODE.  Returns the
+   line of the rule, or 0 if none did. */
+int
+rewrite_match (NODE *node)
+{
+  switch (RW_KEY (node)) {
+  case RW_OP (NODE_BINOP, OPCODE_ADD):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      /* rewrite.rules:30: (ADD ?x:!const ?c:const) => (ADD ?c ?x); */
+      if (node->left->type != NODE_CONST)
+	{
+	  NODE *by = rewrite_binop (OPCODE_ADD, node->right, node->left);
+	  return rewrite_replace (node, by, 30);
+	}
+      switch (RW_KEY (node->left)) {
+      case RW_OP (NODE_BINOP, OPCODE_ADD):
+	switch (RW_KEY (node->left->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:53: (ADD (ADD ?c:const ?x) ?y) => (ADD ?c (ADD ?x ?y)); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_ADD, node->left->left, rewrite_binop (OPCODE_ADD, node->left->right, node->right));
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 53);
+	  }
+	  break;
+	}
+	break;
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:59: (ADD 0 ?x) => ?x; */
+	  {
+	    NODE *by = node->right;
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 59);
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_ADD):
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (RW_KEY (node->right->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:44: (ADD ?a:const (ADD ?b:const ?x)) => (ADD (CONST ?a + ?b) ?x); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_ADD, rewrite_const ((long) ((unsigned long) node->left->v.number + (unsigned long) node->right->left->v.number)), node->right->right);
+	    rewrite_free (node->left);
+	    rewrite_free (node->right->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 44);
+	  }
+	  break;
+	default:
+	  switch (node->left->v.number) {
+	  case 0:
+	    /* rewrite.rules:59: (ADD 0 ?x) => ?x; */
+	    {
+	      NODE *by = node->right;
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 59);
+	    }
+	    break;
+	  }
+	  break;
+	}
+	break;
+      case RW_OP (NODE_BINOP, OPCODE_ADD):
+	switch (RW_KEY (node->left->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:53: (ADD (ADD ?c:const ?x) ?y) => (ADD ?c (ADD ?x ?y)); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_ADD, node->left->left, rewrite_binop (OPCODE_ADD, node->left->right, node->right));
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 53);
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_SUB):
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (RW_KEY (node->right->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:45: (ADD ?a:const (SUB ?b:const ?x)) => (SUB (CONST ?a + ?b) ?x); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_SUB, rewrite_const ((long) ((unsigned long) node->left->v.number + (unsigned long) node->right->left->v.number)), node->right->right);
+	    rewrite_free (node->left);
+	    rewrite_free (node->right->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 45);
+	  }
+	  break;
+	default:
+	  switch (node->left->v.number) {
+	  case 0:
+	    /* rewrite.rules:59: (ADD 0 ?x) => ?x; */
+	    {
+	      NODE *by = node->right;
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 59);
+	    }
+	    break;
+	  }
+	  break;
+	}
+	break;
+      case RW_OP (NODE_BINOP, OPCODE_ADD):
+	switch (RW_KEY (node->left->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:53: (ADD (ADD ?c:const ?x) ?y) => (ADD ?c (ADD ?x ?y)); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_ADD, node->left->left, rewrite_binop (OPCODE_ADD, node->left->right, node->right));
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 53);
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_UNOP, OPCODE_NEG):
+      switch (RW_KEY (node->left)) {
+      case RW_OP (NODE_BINOP, OPCODE_ADD):
+	switch (RW_KEY (node->left->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:53: (ADD (ADD ?c:const ?x) ?y) => (ADD ?c (ADD ?x ?y)); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_ADD, node->left->left, rewrite_binop (OPCODE_ADD, node->left->right, node->right));
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 53);
+	  }
+	  break;
+	default:
+	  /* rewrite.rules:76: (ADD ?x (NEG ?y)) => (SUB ?x ?y); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_SUB, node->left, node->right->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 76);
+	  }
+	  break;
+	}
+	break;
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:59: (ADD 0 ?x) => ?x; */
+	  {
+	    NODE *by = node->right;
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 59);
+	  }
+	  break;
+	default:
+	  /* rewrite.rules:76: (ADD ?x (NEG ?y)) => (SUB ?x ?y); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_SUB, node->left, node->right->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 76);
+	  }
+	  break;
+	}
+	break;
+      default:
+	/* rewrite.rules:76: (ADD ?x (NEG ?y)) => (SUB ?x ?y); */
+	{
+	  NODE *by = rewrite_binop (OPCODE_SUB, node->left, node->right->left);
+	  rewrite_free (node->right);
+	  return rewrite_replace (node, by, 76);
+	}
+	break;
+      }
+      break;
+    default:
+      switch (RW_KEY (node->left)) {
+      case RW_OP (NODE_BINOP, OPCODE_ADD):
+	switch (RW_KEY (node->left->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:53: (ADD (ADD ?c:const ?x) ?y) => (ADD ?c (ADD ?x ?y)); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_ADD, node->left->left, rewrite_binop (OPCODE_ADD, node->left->right, node->right));
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 53);
+	  }
+	  break;
+	}
+	break;
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:59: (ADD 0 ?x) => ?x; */
+	  {
+	    NODE *by = node->right;
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 59);
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_MUL):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      /* rewrite.rules:31: (MUL ?x:!const ?c:const) => (MUL ?c ?x); */
+      if (node->left->type != NODE_CONST)
+	{
+	  NODE *by = rewrite_binop (OPCODE_MUL, node->right, node->left);
+	  return rewrite_replace (node, by, 31);
+	}
+      switch (RW_KEY (node->left)) {
+      case RW_OP (NODE_BINOP, OPCODE_MUL):
+	switch (RW_KEY (node->left->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:54: (MUL (MUL ?c:const ?x) ?y) => (MUL ?c (MUL ?x ?y)); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_MUL, node->left->left, rewrite_binop (OPCODE_MUL, node->left->right, node->right));
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 54);
+	  }
+	  break;
+	}
+	break;
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 1:
+	  /* rewrite.rules:60: (MUL 1 ?x) => ?x; */
+	  {
+	    NODE *by = node->right;
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 60);
+	  }
+	  break;
+	case 0:
+	  /* rewrite.rules:61: (MUL 0 ?x:pure) => 0; */
+	  if (rewrite_pure (node->right))
+	    {
+	      NODE *by = rewrite_const (0L);
+	      rewrite_drop (node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 61);
+	    }
+	  break;
+	case -1:
+	  /* rewrite.rules:62: (MUL -1 ?x) => (NEG ?x); */
+	  {
+	    NODE *by = rewrite_unop (OPCODE_NEG, node->right);
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 62);
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_MUL):
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (RW_KEY (node->right->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:48: (MUL ?a:const (MUL ?b:const ?x)) => (MUL (CONST ?a * ?b) ?x); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_MUL, rewrite_const ((long) ((unsigned long) node->left->v.number * (unsigned long) node->right->left->v.number)), node->right->right);
+	    rewrite_free (node->left);
+	    rewrite_free (node->right->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 48);
+	  }
+	  break;
+	default:
+	  switch (node->left->v.number) {
+	  case 1:
+	    /* rewrite.rules:60: (MUL 1 ?x) => ?x; */
+	    {
+	      NODE *by = node->right;
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 60);
+	    }
+	    break;
+	  case 0:
+	    /* rewrite.rules:61: (MUL 0 ?x:pure) => 0; */
+	    if (rewrite_pure (node->right))
+	      {
+		NODE *by = rewrite_const (0L);
+		rewrite_drop (node->right);
+		rewrite_free (node->left);
+		return rewrite_replace (node, by, 61);
+	      }
+	    break;
+	  case -1:
+	    /* rewrite.rules:62: (MUL -1 ?x) => (NEG ?x); */
+	    {
+	      NODE *by = rewrite_unop (OPCODE_NEG, node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 62);
+	    }
+	    break;
+	  }
+	  break;
+	}
+	break;
+      case RW_OP (NODE_BINOP, OPCODE_MUL):
+	switch (RW_KEY (node->left->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:54: (MUL (MUL ?c:const ?x) ?y) => (MUL ?c (MUL ?x ?y)); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_MUL, node->left->left, rewrite_binop (OPCODE_MUL, node->left->right, node->right));
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 54);
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_UNOP, OPCODE_NEG):
+      switch (RW_KEY (node->left)) {
+      case RW_OP (NODE_BINOP, OPCODE_MUL):
+	switch (RW_KEY (node->left->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:54: (MUL (MUL ?c:const ?x) ?y) => (MUL ?c (MUL ?x ?y)); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_MUL, node->left->left, rewrite_binop (OPCODE_MUL, node->left->right, node->right));
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 54);
+	  }
+	  break;
+	}
+	break;
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 1:
+	  /* rewrite.rules:60: (MUL 1 ?x) => ?x; */
+	  {
+	    NODE *by = node->right;
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 60);
+	  }
+	  break;
+	case 0:
+	  /* rewrite.rules:61: (MUL 0 ?x:pure) => 0; */
+	  if (rewrite_pure (node->right))
+	    {
+	      NODE *by = rewrite_const (0L);
+	      rewrite_drop (node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 61);
+	    }
+	  /* rewrite.rules:75: (MUL ?c:const (NEG ?x)) => (MUL (CONST -?c) ?x); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_MUL, rewrite_const ((long) (-(unsigned long) node->left->v.number)), node->right->left);
+	    rewrite_free (node->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 75);
+	  }
+	  break;
+	case -1:
+	  /* rewrite.rules:62: (MUL -1 ?x) => (NEG ?x); */
+	  {
+	    NODE *by = rewrite_unop (OPCODE_NEG, node->right);
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 62);
+	  }
+	  break;
+	default:
+	  /* rewrite.rules:75: (MUL ?c:const (NEG ?x)) => (MUL (CONST -?c) ?x); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_MUL, rewrite_const ((long) (-(unsigned long) node->left->v.number)), node->right->left);
+	    rewrite_free (node->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 75);
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    default:
+      switch (RW_KEY (node->left)) {
+      case RW_OP (NODE_BINOP, OPCODE_MUL):
+	switch (RW_KEY (node->left->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:54: (MUL (MUL ?c:const ?x) ?y) => (MUL ?c (MUL ?x ?y)); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_MUL, node->left->left, rewrite_binop (OPCODE_MUL, node->left->right, node->right));
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 54);
+	  }
+	  break;
+	}
+	break;
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 1:
+	  /* rewrite.rules:60: (MUL 1 ?x) => ?x; */
+	  {
+	    NODE *by = node->right;
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 60);
+	  }
+	  break;
+	case 0:
+	  /* rewrite.rules:61: (MUL 0 ?x:pure) => 0; */
+	  if (rewrite_pure (node->right))
+	    {
+	      NODE *by = rewrite_const (0L);
+	      rewrite_drop (node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 61);
+	    }
+	  break;
+	case -1:
+	  /* rewrite.rules:62: (MUL -1 ?x) => (NEG ?x); */
+	  {
+	    NODE *by = rewrite_unop (OPCODE_NEG, node->right);
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 62);
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_BAND):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      /* rewrite.rules:32: (BAND ?x:!const ?c:const) => (BAND ?c ?x); */
+      if (node->left->type != NODE_CONST)
+	{
+	  NODE *by = rewrite_binop (OPCODE_BAND, node->right, node->left);
+	  return rewrite_replace (node, by, 32);
+	}
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case -1:
+	  /* rewrite.rules:70: (BAND -1 ?x) => ?x; */
+	  {
+	    NODE *by = node->right;
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 70);
+	  }
+	  break;
+	case 0:
+	  /* rewrite.rules:71: (BAND 0 ?x:pure) => 0; */
+	  if (rewrite_pure (node->right))
+	    {
+	      NODE *by = rewrite_const (0L);
+	      rewrite_drop (node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 71);
+	    }
+	  break;
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_BAND):
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (RW_KEY (node->right->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:49: (BAND ?a:const (BAND ?b:const ?x)) => (BAND (CONST ?a & ?b) ?x); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_BAND, rewrite_const ((long) ((unsigned long) node->left->v.number & (unsigned long) node->right->left->v.number)), node->right->right);
+	    rewrite_free (node->left);
+	    rewrite_free (node->right->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 49);
+	  }
+	  break;
+	default:
+	  switch (node->left->v.number) {
+	  case -1:
+	    /* rewrite.rules:70: (BAND -1 ?x) => ?x; */
+	    {
+	      NODE *by = node->right;
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 70);
+	    }
+	    break;
+	  case 0:
+	    /* rewrite.rules:71: (BAND 0 ?x:pure) => 0; */
+	    if (rewrite_pure (node->right))
+	      {
+		NODE *by = rewrite_const (0L);
+		rewrite_drop (node->right);
+		rewrite_free (node->left);
+		return rewrite_replace (node, by, 71);
+	      }
+	    break;
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    default:
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case -1:
+	  /* rewrite.rules:70: (BAND -1 ?x) => ?x; */
+	  {
+	    NODE *by = node->right;
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 70);
+	  }
+	  break;
+	case 0:
+	  /* rewrite.rules:71: (BAND 0 ?x:pure) => 0; */
+	  if (rewrite_pure (node->right))
+	    {
+	      NODE *by = rewrite_const (0L);
+	      rewrite_drop (node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 71);
+	    }
+	  break;
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_EQ):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      /* rewrite.rules:33: (EQ ?x:!const ?c:const) => (EQ ?c ?x); */
+      if (node->left->type != NODE_CONST)
+	{
+	  NODE *by = rewrite_binop (OPCODE_EQ, node->right, node->left);
+	  return rewrite_replace (node, by, 33);
+	}
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:91: (EQ 0 ?x) => (NOT ?x); */
+	  {
+	    NODE *by = rewrite_unop (OPCODE_NOT, node->right);
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 91);
+	  }
+	  break;
+	case 1:
+	  /* rewrite.rules:93: (EQ 1 ?x:bool) => ?x; */
+	  if (rewrite_bool (node->right))
+	    {
+	      NODE *by = node->right;
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 93);
+	    }
+	  break;
+	}
+	break;
+      }
+      break;
+    default:
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:91: (EQ 0 ?x) => (NOT ?x); */
+	  {
+	    NODE *by = rewrite_unop (OPCODE_NOT, node->right);
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 91);
+	  }
+	  break;
+	case 1:
+	  /* rewrite.rules:93: (EQ 1 ?x:bool) => ?x; */
+	  if (rewrite_bool (node->right))
+	    {
+	      NODE *by = node->right;
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 93);
+	    }
+	  break;
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_NE):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      /* rewrite.rules:34: (NE ?x:!const ?c:const) => (NE ?c ?x); */
+      if (node->left->type != NODE_CONST)
+	{
+	  NODE *by = rewrite_binop (OPCODE_NE, node->right, node->left);
+	  return rewrite_replace (node, by, 34);
+	}
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:92: (NE 0 ?x:bool) => ?x; */
+	  if (rewrite_bool (node->right))
+	    {
+	      NODE *by = node->right;
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 92);
+	    }
+	  break;
+	case 1:
+	  /* rewrite.rules:94: (NE 1 ?x:bool) => (NOT ?x); */
+	  if (rewrite_bool (node->right))
+	    {
+	      NODE *by = rewrite_unop (OPCODE_NOT, node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 94);
+	    }
+	  break;
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_UNOP, OPCODE_NEG):
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:92: (NE 0 ?x:bool) => ?x; */
+	  if (rewrite_bool (node->right))
+	    {
+	      NODE *by = node->right;
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 92);
+	    }
+	  /* rewrite.rules:95: (NE 0 (NEG ?x)) => (NE 0 ?x); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_NE, rewrite_const (0L), node->right->left);
+	    rewrite_free (node->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 95);
+	  }
+	  break;
+	case 1:
+	  /* rewrite.rules:94: (NE 1 ?x:bool) => (NOT ?x); */
+	  if (rewrite_bool (node->right))
+	    {
+	      NODE *by = rewrite_unop (OPCODE_NOT, node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 94);
+	    }
+	  break;
+	}
+	break;
+      }
+      break;
+    default:
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:92: (NE 0 ?x:bool) => ?x; */
+	  if (rewrite_bool (node->right))
+	    {
+	      NODE *by = node->right;
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 92);
+	    }
+	  break;
+	case 1:
+	  /* rewrite.rules:94: (NE 1 ?x:bool) => (NOT ?x); */
+	  if (rewrite_bool (node->right))
+	    {
+	      NODE *by = rewrite_unop (OPCODE_NOT, node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 94);
+	    }
+	  break;
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_LT):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      /* rewrite.rules:35: (LT ?x:!const ?c:const) => (GT ?c ?x); */
+      if (node->left->type != NODE_CONST)
+	{
+	  NODE *by = rewrite_binop (OPCODE_GT, node->right, node->left);
+	  return rewrite_replace (node, by, 35);
+	}
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_GT):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      /* rewrite.rules:36: (GT ?x:!const ?c:const) => (LT ?c ?x); */
+      if (node->left->type != NODE_CONST)
+	{
+	  NODE *by = rewrite_binop (OPCODE_LT, node->right, node->left);
+	  return rewrite_replace (node, by, 36);
+	}
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_LE):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      /* rewrite.rules:37: (LE ?x:!const ?c:const) => (GE ?c ?x); */
+      if (node->left->type != NODE_CONST)
+	{
+	  NODE *by = rewrite_binop (OPCODE_GE, node->right, node->left);
+	  return rewrite_replace (node, by, 37);
+	}
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_GE):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      /* rewrite.rules:38: (GE ?x:!const ?c:const) => (LE ?c ?x); */
+      if (node->left->type != NODE_CONST)
+	{
+	  NODE *by = rewrite_binop (OPCODE_LE, node->right, node->left);
+	  return rewrite_replace (node, by, 38);
+	}
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_SUB):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      /* rewrite.rules:39: (SUB ?x:!const ?c:const) => (ADD (CONST -?c) ?x); */
+      if (node->left->type != NODE_CONST)
+	{
+	  NODE *by = rewrite_binop (OPCODE_ADD, rewrite_const ((long) (-(unsigned long) node->right->v.number)), node->left);
+	  rewrite_free (node->right);
+	  return rewrite_replace (node, by, 39);
+	}
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:63: (SUB 0 ?x) => (NEG ?x); */
+	  {
+	    NODE *by = rewrite_unop (OPCODE_NEG, node->right);
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 63);
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_ADD):
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (RW_KEY (node->right->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:46: (SUB ?a:const (ADD ?b:const ?x)) => (SUB (CONST ?a - ?b) ?x); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_SUB, rewrite_const ((long) ((unsigned long) node->left->v.number - (unsigned long) node->right->left->v.number)), node->right->right);
+	    rewrite_free (node->left);
+	    rewrite_free (node->right->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 46);
+	  }
+	  break;
+	default:
+	  switch (node->left->v.number) {
+	  case 0:
+	    /* rewrite.rules:63: (SUB 0 ?x) => (NEG ?x); */
+	    {
+	      NODE *by = rewrite_unop (OPCODE_NEG, node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 63);
+	    }
+	    break;
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_SUB):
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (RW_KEY (node->right->left)) {
+	case RW_TYPE (NODE_CONST):
+	  /* rewrite.rules:47: (SUB ?a:const (SUB ?b:const ?x)) => (ADD (CONST ?a - ?b) ?x); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_ADD, rewrite_const ((long) ((unsigned long) node->left->v.number - (unsigned long) node->right->left->v.number)), node->right->right);
+	    rewrite_free (node->left);
+	    rewrite_free (node->right->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 47);
+	  }
+	  break;
+	default:
+	  switch (node->left->v.number) {
+	  case 0:
+	    /* rewrite.rules:63: (SUB 0 ?x) => (NEG ?x); */
+	    {
+	      NODE *by = rewrite_unop (OPCODE_NEG, node->right);
+	      rewrite_free (node->left);
+	      return rewrite_replace (node, by, 63);
+	    }
+	    break;
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_UNOP, OPCODE_NEG):
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:63: (SUB 0 ?x) => (NEG ?x); */
+	  {
+	    NODE *by = rewrite_unop (OPCODE_NEG, node->right);
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 63);
+	  }
+	  break;
+	default:
+	  /* rewrite.rules:77: (SUB ?x (NEG ?y)) => (ADD ?x ?y); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_ADD, node->left, node->right->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 77);
+	  }
+	  break;
+	}
+	break;
+      default:
+	/* rewrite.rules:77: (SUB ?x (NEG ?y)) => (ADD ?x ?y); */
+	{
+	  NODE *by = rewrite_binop (OPCODE_ADD, node->left, node->right->left);
+	  rewrite_free (node->right);
+	  return rewrite_replace (node, by, 77);
+	}
+	break;
+      }
+      break;
+    default:
+      switch (RW_KEY (node->left)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->left->v.number) {
+	case 0:
+	  /* rewrite.rules:63: (SUB 0 ?x) => (NEG ?x); */
+	  {
+	    NODE *by = rewrite_unop (OPCODE_NEG, node->right);
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 63);
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_DIV):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      switch (node->right->v.number) {
+      case 1:
+	/* rewrite.rules:64: (DIV ?x 1) => ?x; */
+	{
+	  NODE *by = node->left;
+	  rewrite_free (node->right);
+	  return rewrite_replace (node, by, 64);
+	}
+	break;
+      case -1:
+	/* rewrite.rules:65: (DIV ?x -1) => (NEG ?x); */
+	{
+	  NODE *by = rewrite_unop (OPCODE_NEG, node->left);
+	  rewrite_free (node->right);
+	  return rewrite_replace (node, by, 65);
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_MOD):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      switch (node->right->v.number) {
+      case 1:
+	/* rewrite.rules:66: (MOD ?x:pure 1) => 0; */
+	if (rewrite_pure (node->left))
+	  {
+	    NODE *by = rewrite_const (0L);
+	    rewrite_drop (node->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 66);
+	  }
+	break;
+      case -1:
+	/* rewrite.rules:67: (MOD ?x:pure -1) => 0; */
+	if (rewrite_pure (node->left))
+	  {
+	    NODE *by = rewrite_const (0L);
+	    rewrite_drop (node->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 67);
+	  }
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_SHL):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      switch (node->right->v.number) {
+      case 0:
+	/* rewrite.rules:68: (SHL ?x 0) => ?x; */
+	{
+	  NODE *by = node->left;
+	  rewrite_free (node->right);
+	  return rewrite_replace (node, by, 68);
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_SHR):
+    switch (RW_KEY (node->right)) {
+    case RW_TYPE (NODE_CONST):
+      switch (node->right->v.number) {
+      case 0:
+	/* rewrite.rules:69: (SHR ?x 0) => ?x; */
+	{
+	  NODE *by = node->left;
+	  rewrite_free (node->right);
+	  return rewrite_replace (node, by, 69);
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_UNOP, OPCODE_NEG):
+    switch (RW_KEY (node->left)) {
+    case RW_OP (NODE_UNOP, OPCODE_NEG):
+      /* rewrite.rules:73: (NEG (NEG ?x)) => ?x; */
+      {
+	NODE *by = node->left->left;
+	rewrite_free (node->left);
+	return rewrite_replace (node, by, 73);
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_MUL):
+      switch (RW_KEY (node->left->left)) {
+      case RW_TYPE (NODE_CONST):
+	/* rewrite.rules:74: (NEG (MUL ?c:const ?x)) => (MUL (CONST -?c) ?x); */
+	{
+	  NODE *by = rewrite_binop (OPCODE_MUL, rewrite_const ((long) (-(unsigned long) node->left->left->v.number)), node->left->right);
+	  rewrite_free (node->left->left);
+	  rewrite_free (node->left);
+	  return rewrite_replace (node, by, 74);
+	}
+	break;
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_SUB):
+      /* rewrite.rules:78: (NEG (SUB ?x:pure ?y:pure)) => (SUB ?y ?x); */
+      if (rewrite_pure (node->left->left)
+	  && rewrite_pure (node->left->right))
+	{
+	  NODE *by = rewrite_binop (OPCODE_SUB, node->left->right, node->left->left);
+	  rewrite_free (node->left);
+	  return rewrite_replace (node, by, 78);
+	}
+      break;
+    }
+    break;
+  case RW_OP (NODE_UNOP, OPCODE_NOT):
+    switch (RW_KEY (node->left)) {
+    case RW_OP (NODE_UNOP, OPCODE_NOT):
+      /* rewrite.rules:83: (NOT (NOT ?x:bool)) => ?x; */
+      if (rewrite_bool (node->left->left))
+	{
+	  NODE *by = node->left->left;
+	  rewrite_free (node->left);
+	  return rewrite_replace (node, by, 83);
+	}
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_EQ):
+      /* rewrite.rules:84: (NOT (EQ ?x ?y)) => (NE ?x ?y); */
+      {
+	NODE *by = rewrite_binop (OPCODE_NE, node->left->left, node->left->right);
+	rewrite_free (node->left);
+	return rewrite_replace (node, by, 84);
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_NE):
+      /* rewrite.rules:85: (NOT (NE ?x ?y)) => (EQ ?x ?y); */
+      {
+	NODE *by = rewrite_binop (OPCODE_EQ, node->left->left, node->left->right);
+	rewrite_free (node->left);
+	return rewrite_replace (node, by, 85);
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_LT):
+      /* rewrite.rules:86: (NOT (LT ?x ?y)) => (GE ?x ?y); */
+      {
+	NODE *by = rewrite_binop (OPCODE_GE, node->left->left, node->left->right);
+	rewrite_free (node->left);
+	return rewrite_replace (node, by, 86);
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_GE):
+      /* rewrite.rules:87: (NOT (GE ?x ?y)) => (LT ?x ?y); */
+      {
+	NODE *by = rewrite_binop (OPCODE_LT, node->left->left, node->left->right);
+	rewrite_free (node->left);
+	return rewrite_replace (node, by, 87);
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_GT):
+      /* rewrite.rules:88: (NOT (GT ?x ?y)) => (LE ?x ?y); */
+      {
+	NODE *by = rewrite_binop (OPCODE_LE, node->left->left, node->left->right);
+	rewrite_free (node->left);
+	return rewrite_replace (node, by, 88);
+      }
+      break;
+    case RW_OP (NODE_BINOP, OPCODE_LE):
+      /* rewrite.rules:89: (NOT (LE ?x ?y)) => (GT ?x ?y); */
+      {
+	NODE *by = rewrite_binop (OPCODE_GT, node->left->left, node->left->right);
+	rewrite_free (node->left);
+	return rewrite_replace (node, by, 89);
+      }
+      break;
+    case RW_OP (NODE_UNOP, OPCODE_NEG):
+      /* rewrite.rules:96: (NOT (NEG ?x)) => (NOT ?x); */
+      {
+	NODE *by = rewrite_unop (OPCODE_NOT, node->left->left);
+	rewrite_free (node->left);
+	return rewrite_replace (node, by, 96);
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_AND):
+    switch (RW_KEY (node->left)) {
+    case RW_TYPE (NODE_CONST):
+      switch (node->left->v.number) {
+      case 0:
+	/* rewrite.rules:100: (AND 0 ?x) => 0; */
+	{
+	  NODE *by = rewrite_const (0L);
+	  rewrite_drop (node->right);
+	  rewrite_free (node->left);
+	  return rewrite_replace (node, by, 100);
+	}
+	break;
+      default:
+	/* rewrite.rules:101: (AND ?c:const ?x) => (NE 0 ?x) if (?c != 0); */
+	if (((long) node->left->v.number != 0))
+	  {
+	    NODE *by = rewrite_binop (OPCODE_NE, rewrite_const (0L), node->right);
+	    rewrite_free (node->left);
+	    return rewrite_replace (node, by, 101);
+	  }
+	switch (RW_KEY (node->right)) {
+	case RW_TYPE (NODE_CONST):
+	  switch (node->right->v.number) {
+	  case 0:
+	    /* rewrite.rules:104: (AND ?x:pure 0) => 0; */
+	    if (rewrite_pure (node->left))
+	      {
+		NODE *by = rewrite_const (0L);
+		rewrite_drop (node->left);
+		rewrite_free (node->right);
+		return rewrite_replace (node, by, 104);
+	      }
+	    /* rewrite.rules:105: (AND ?x ?c:const) => (NE 0 ?x) if (?c != 0); */
+	    if (((long) node->right->v.number != 0))
+	      {
+		NODE *by = rewrite_binop (OPCODE_NE, rewrite_const (0L), node->left);
+		rewrite_free (node->right);
+		return rewrite_replace (node, by, 105);
+	      }
+	    break;
+	  default:
+	    /* rewrite.rules:105: (AND ?x ?c:const) => (NE 0 ?x) if (?c != 0); */
+	    if (((long) node->right->v.number != 0))
+	      {
+		NODE *by = rewrite_binop (OPCODE_NE, rewrite_const (0L), node->left);
+		rewrite_free (node->right);
+		return rewrite_replace (node, by, 105);
+	      }
+	    break;
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    default:
+      switch (RW_KEY (node->right)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->right->v.number) {
+	case 0:
+	  /* rewrite.rules:104: (AND ?x:pure 0) => 0; */
+	  if (rewrite_pure (node->left))
+	    {
+	      NODE *by = rewrite_const (0L);
+	      rewrite_drop (node->left);
+	      rewrite_free (node->right);
+	      return rewrite_replace (node, by, 104);
+	    }
+	  /* rewrite.rules:105: (AND ?x ?c:const) => (NE 0 ?x) if (?c != 0); */
+	  if (((long) node->right->v.number != 0))
+	    {
+	      NODE *by = rewrite_binop (OPCODE_NE, rewrite_const (0L), node->left);
+	      rewrite_free (node->right);
+	      return rewrite_replace (node, by, 105);
+	    }
+	  break;
+	default:
+	  /* rewrite.rules:105: (AND ?x ?c:const) => (NE 0 ?x) if (?c != 0); */
+	  if (((long) node->right->v.number != 0))
+	    {
+	      NODE *by = rewrite_binop (OPCODE_NE, rewrite_const (0L), node->left);
+	      rewrite_free (node->right);
+	      return rewrite_replace (node, by, 105);
+	    }
+	  break;
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  case RW_OP (NODE_BINOP, OPCODE_OR):
+    switch (RW_KEY (node->left)) {
+    case RW_TYPE (NODE_CONST):
+      switch (node->left->v.number) {
+      case 0:
+	/* rewrite.rules:102: (OR 0 ?x) => (NE 0 ?x); */
+	{
+	  NODE *by = rewrite_binop (OPCODE_NE, rewrite_const (0L), node->right);
+	  rewrite_free (node->left);
+	  return rewrite_replace (node, by, 102);
+	}
+	break;
+      default:
+	/* rewrite.rules:103: (OR ?c:const ?x) => 1 if (?c != 0); */
+	if (((long) node->left->v.number != 0))
+	  {
+	    NODE *by = rewrite_const (1L);
+	    rewrite_free (node->left);
+	    rewrite_drop (node->right);
+	    return rewrite_replace (node, by, 103);
+	  }
+	switch (RW_KEY (node->right)) {
+	case RW_TYPE (NODE_CONST):
+	  switch (node->right->v.number) {
+	  case 0:
+	    /* rewrite.rules:106: (OR ?x 0) => (NE 0 ?x); */
+	    {
+	      NODE *by = rewrite_binop (OPCODE_NE, rewrite_const (0L), node->left);
+	      rewrite_free (node->right);
+	      return rewrite_replace (node, by, 106);
+	    }
+	    break;
+	  default:
+	    /* rewrite.rules:107: (OR ?x:pure ?c:const) => 1 if (?c != 0); */
+	    if (rewrite_pure (node->left)
+		&& ((long) node->right->v.number != 0))
+	      {
+		NODE *by = rewrite_const (1L);
+		rewrite_drop (node->left);
+		rewrite_free (node->right);
+		return rewrite_replace (node, by, 107);
+	      }
+	    break;
+	  }
+	  break;
+	}
+	break;
+      }
+      break;
+    default:
+      switch (RW_KEY (node->right)) {
+      case RW_TYPE (NODE_CONST):
+	switch (node->right->v.number) {
+	case 0:
+	  /* rewrite.rules:106: (OR ?x 0) => (NE 0 ?x); */
+	  {
+	    NODE *by = rewrite_binop (OPCODE_NE, rewrite_const (0L), node->left);
+	    rewrite_free (node->right);
+	    return rewrite_replace (node, by, 106);
+	  }
+	  break;
+	default:
+	  /* rewrite.rules:107: (OR ?x:pure ?c:const) => 1 if (?c != 0); */
+	  if (rewrite_pure (node->left)
+	      && ((long) node->right->v.number != 0))
+	    {
+	      NODE *by = rewrite_const (1L);
+	      rewrite_drop (node->left);
+	      rewrite_free (node->right);
+	      return rewrite_replace (node, by, 107);
+	    }
+	  break;
+	}
+	break;
+      }
+      break;
+    }
+    break;
+  }
+  return 0;
+}
@@ -0,0 +1,926 @@
+/*
+   V5: rulegen.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/*
+  Rewrite rule compiler.
+
+  Reads the algebraic rules, see rewrite.rules, and writes the C
+  function rewrite_match, which applies the first of them matching
+  a node.  A rule is
+
+    pattern => result [if (guard)];
+
+  A pattern is an operator applied to patterns, (ADD ?x 0), a
+  constant, 0 or (CONST 0), or a variable, ?x.  A variable matches
+  any expression, unless a kind restricts it: ?x:const and ?x:var
+  match only constants and variables, ?x:!const anything but a
+  constant, ?x:bool expressions worth 0 or 1, and ?x:pure those
+  without calls or divisions that may fail, which may be dropped.
+  No variable appears twice in a pattern.
+
+  The result is built the same way from the variables of the
+  pattern, each used once at most, and from constants computed at
+  compile time, (CONST -?c).  The computation and the guard are C
+  expressions over the variables of kind const; in the computation
+  they are unsigned, so that it wraps around like the machine.
+
+  The rules are compiled into a decision tree.  Each branch of the
+  tree switches on the operator, or the value of a constant, at one
+  place of the patterns, so a node of the expression is looked at
+  once however many rules test it, and the rules it does not match
+  are never tried.  The rules reaching a leaf are tried in the order
+  they are written in.
+
+  With -e the rules are those of the e-graph, see egraph.rules, and
+  are written out as the tables egraph_rules and egraph_nrules
+  instead.  The rules of the e-graph add a form equal to the one
+  matched, which stays, so they have no kinds, guards or computed
+  constants.  A variable may appear twice in a pattern, matching
+  equal classes, and any number of times in the result.
+*/
+
+#define MAX_VARS 8
+#define MAX_TESTS 32
+#define MAX_PATH 16
+#define MAX_KEY 64
+
+struct op
+{
+  const char *name;
+  const char *type;
+  const char *opcode;
+  int arity;
+};
+
+static const struct op ops[] = {
+  { "ADD", "NODE_BINOP", "OPCODE_ADD", 2 },
+  { "SUB", "NODE_BINOP", "OPCODE_SUB", 2 },
+  { "MUL", "NODE_BINOP", "OPCODE_MUL", 2 },
+  { "DIV", "NODE_BINOP", "OPCODE_DIV", 2 },
+  { "MOD", "NODE_BINOP", "OPCODE_MOD", 2 },
+  { "AND", "NODE_BINOP", "OPCODE_AND", 2 },
+  { "OR", "NODE_BINOP", "OPCODE_OR", 2 },
+  { "EQ", "NODE_BINOP", "OPCODE_EQ", 2 },
+  { "NE", "NODE_BINOP", "OPCODE_NE", 2 },
+  { "LT", "NODE_BINOP", "OPCODE_LT", 2 },
+  { "GT", "NODE_BINOP", "OPCODE_GT", 2 },
+  { "LE", "NODE_BINOP", "OPCODE_LE", 2 },
+  { "GE", "NODE_BINOP", "OPCODE_GE", 2 },
+  { "SHL", "NODE_BINOP", "OPCODE_SHL", 2 },
+  { "SHR", "NODE_BINOP", "OPCODE_SHR", 2 },
+  { "BAND", "NODE_BINOP", "OPCODE_BAND", 2 },
+  { "NEG", "NODE_UNOP", "OPCODE_NEG", 1 },
+  { "NOT", "NODE_UNOP", "OPCODE_NOT", 1 },
+  { NULL, NULL, NULL, 0 }
+};
+
+enum pat_type
+{
+  PAT_OP,       /* operator */
+  PAT_CONST,    /* constant */
+  PAT_VAR,      /* variable */
+  PAT_VALUE     /* constant computed by the result */
+};
+
+struct pat
+{
+  enum pat_type type;
+  const struct op *op;
+  struct pat *kid[2];
+  long number;
+  char *text;
+  int var;
+};
+
+struct var
+{
+  char *name;
+  char *kind;
+  char path[MAX_PATH + 1];
+  int used;                     /* by the result */
+};
+
+/* A test of the operator, or of the value of a constant, at a place
+   of the pattern */
+struct test
+{
+  char path[MAX_PATH + 1];
+  int value;
+  char key[MAX_KEY];
+};
+
+struct rule
+{
+  int line;
+  char *source;
+  struct pat *pattern, *result;
+  char *guard;
+  struct var vars[MAX_VARS];
+  int nvars;
+  struct test tests[MAX_TESTS];
+  int ntests;
+  char inner[MAX_TESTS][MAX_PATH + 1]; /* nodes of the pattern to free */
+  int ninner;
+};
+
+struct row
+{
+  struct rule *rule;
+  unsigned long done;           /* tests decided */
+};
+
+static const char *input_name;
+static char *text, *pos;
+static int line = 1;
+static struct rule *rules;
+static int nrules, rules_size;
+static FILE *out;
+static int egraph;              /* -e: the rules of the e-graph */
+static int npats;               /* patterns written out */
+
+static void
+error (const char *msg, const char *arg)
+{
+  fprintf (stderr, "%s:%d: %s%s\n", input_name, line, msg, arg ? arg : "");
+  exit (EXIT_FAILURE);
+}
+
+static void *
+xmalloc (size_t size)
+{
+  void *p = malloc (size);
+  if (!p)
+    exit (EXIT_FAILURE);
+  return p;
+}
+
+static char *
+xstrndup (const char *s, size_t n)
+{
+  char *p = xmalloc (n + 1);
+  memcpy (p, s, n);
+  p[n] = 0;
+  return p;
+}
+
+/* Parsing */
+
+static void
+skip_space (void)
+{
+  for (;;)
+    {
+      if (*pos == '\n')
+	line++;
+      if (isspace ((unsigned char) *pos))
+	pos++;
+      else if (*pos == '#')
+	while (*pos && *pos != '\n')
+	  pos++;
+      else
+	break;
+    }
+}
+
+static char *
+word (void)
+{
+  char *start = pos;
+
+  while (isalnum ((unsigned char) *pos) || *pos == '_' || *pos == '!')
+    pos++;
+  if (pos == start)
+    error ("name expected", NULL);
+  return xstrndup (start, pos - start);
+}
+
+/* The text up to the parenthesis closing the one just read */
+static char *
+group (void)
+{
+  char *start = pos, *end;
+  int depth = 0;
+
+  for (; *pos; pos++)
+    {
+      if (*pos == '\n')
+	line++;
+      else if (*pos == '(')
+	depth++;
+      else if (*pos == ')' && depth-- == 0)
+	break;
+    }
+  if (!*pos)
+    error ("unbalanced parentheses", NULL);
+  for (end = pos; end > start && isspace ((unsigned char) end[-1]); end--)
+    ;
+  pos++;
+  while (isspace ((unsigned char) *start))
+    start++;
+  return xstrndup (start, end - start);
+}
+
+static int
+number (const char *s, long *value)
+{
+  char *end;
+
+  *value = strtol (s, &end, 0);
+  return *s && !*end;
+}
+
+static void
+expect (char c)
+{
+  char msg[2];
+
+  skip_space ();
+  if (*pos != c)
+    {
+      msg[0] = c;
+      msg[1] = 0;
+      error ("expected ", msg);
+    }
+  pos++;
+}
+
+static int
+find_var (struct rule *r, const char *name)
+{
+  int i;
+
+  for (i = 0; i < r->nvars; i++)
+    if (strcmp (r->vars[i].name, name) == 0)
+      return i;
+  return -1;
+}
+
+static struct pat *
+parse (struct rule *r, int result)
+{
+  struct pat *p = xmalloc (sizeof (*p));
+  char *name;
+  int i;
+
+  memset (p, 0, sizeof (*p));
+  skip_space ();
+  if (*pos == '?')
+    {
+      pos++;
+      name = word ();
+      p->type = PAT_VAR;
+      p->var = find_var (r, name);
+      if (result)
+	{
+	  if (p->var < 0)
+	    error ("unknown variable ?", name);
+	  if (r->vars[p->var].used++ && !egraph)
+	    error ("variable used twice in the result: ?", name);
+	  return p;
+	}
+      if (p->var >= 0 && egraph && *pos != ':')
+	return p;
+      if (p->var >= 0)
+	error ("variable used twice in the pattern: ?", name);
+      if (r->nvars == MAX_VARS)
+	error ("too many variables", NULL);
+      p->var = r->nvars++;
+      r->vars[p->var].name = name;
+      r->vars[p->var].kind = "";
+      r->vars[p->var].used = 0;
+      if (*pos == ':')
+	{
+	  if (egraph)
+	    error ("no kinds in e-graph rules", NULL);
+	  pos++;
+	  r->vars[p->var].kind = word ();
+	  if (strcmp (r->vars[p->var].kind, "const")
+	      && strcmp (r->vars[p->var].kind, "var")
+	      && strcmp (r->vars[p->var].kind, "!const")
+	      && strcmp (r->vars[p->var].kind, "bool")
+	      && strcmp (r->vars[p->var].kind, "pure"))
+	    error ("unknown kind ", r->vars[p->var].kind);
+	}
+      return p;
+    }
+
+  if (*pos == '-' || isdigit ((unsigned char) *pos))
+    {
+      char *start = pos++;
+      while (isalnum ((unsigned char) *pos))
+	pos++;
+      p->type = PAT_CONST;
+      if (!number (xstrndup (start, pos - start), &p->number))
+	error ("bad number", NULL);
+      return p;
+    }
+
+  expect ('(');
+  skip_space ();
+  name = word ();
+  if (strcmp (name, "CONST") == 0)
+    {
+      p->text = group ();
+      if (number (p->text, &p->number))
+	p->type = PAT_CONST;
+      else if (result && !egraph)
+	p->type = PAT_VALUE;
+      else
+	error ("constant expected: ", p->text);
+      return p;
+    }
+
+  for (i = 0; ops[i].name; i++)
+    if (strcmp (ops[i].name, name) == 0)
+      break;
+  if (!ops[i].name)
+    error ("unknown operator ", name);
+  p->type = PAT_OP;
+  p->op = &ops[i];
+  for (i = 0; i < p->op->arity; i++)
+    p->kid[i] = parse (r, result);
+  expect (')');
+  return p;
+}
+
+static void
+add_test (struct rule *r, const char *path, int value, const char *key)
+{
+  struct test *t;
+
+  if (r->ntests == MAX_TESTS)
+    error ("pattern too large", NULL);
+  t = &r->tests[r->ntests++];
+  strcpy (t->path, path);
+  t->value = value;
+  strcpy (t->key, key);
+}
+
+/* List the tests of the pattern P at PATH, the places above first,
+   and the nodes of the pattern that the rule frees, the places below
+   first */
+static void
+flatten (struct rule *r, struct pat *p, const char *path)
+{
+  char key[MAX_KEY], sub[MAX_PATH + 1];
+  struct var *v;
+  int i;
+
+  if (strlen (path) == MAX_PATH)
+    error ("pattern too deep", NULL);
+
+  switch (p->type) {
+  case PAT_OP:
+    sprintf (key, "RW_OP (%s, %s)", p->op->type, p->op->opcode);
+    add_test (r, path, 0, key);
+    for (i = 0; i < p->op->arity; i++)
+      {
+	sprintf (sub, "%s%c", path, i ? 'r' : 'l');
+	flatten (r, p->kid[i], sub);
+      }
+    break;
+  case PAT_CONST:
+    add_test (r, path, 0, "RW_TYPE (NODE_CONST)");
+    sprintf (key, "%ld", p->number);
+    add_test (r, path, 1, key);
+    break;
+  case PAT_VAR:
+    v = &r->vars[p->var];
+    strcpy (v->path, path);
+    if (strcmp (v->kind, "const") == 0)
+      add_test (r, path, 0, "RW_TYPE (NODE_CONST)");
+    else if (strcmp (v->kind, "var") == 0)
+      add_test (r, path, 0, "RW_TYPE (NODE_VAR)");
+    return;
+  default:
+    abort ();
+  }
+  if (*path)
+    strcpy (r->inner[r->ninner++], path);
+}
+
+static void
+parse_rule (void)
+{
+  struct rule *r;
+  char *start = pos;
+
+  if (nrules == rules_size)
+    {
+      rules_size = rules_size ? rules_size * 2 : 64;
+      rules = realloc (rules, rules_size * sizeof (*rules));
+      if (!rules)
+	exit (EXIT_FAILURE);
+    }
+  r = &rules[nrules++];
+  memset (r, 0, sizeof (*r));
+  r->line = line;
+
+  r->pattern = parse (r, 0);
+  if (r->pattern->type != PAT_OP)
+    error ("the pattern must be an operator", NULL);
+  skip_space ();
+  if (pos[0] != '=' || pos[1] != '>')
+    error ("expected =>", NULL);
+  pos += 2;
+  r->result = parse (r, 1);
+  skip_space ();
+  if (strncmp (pos, "if", 2) == 0 && !isalnum ((unsigned char) pos[2]))
+    {
+      if (egraph)
+	error ("no guards in e-graph rules", NULL);
+      pos += 2;
+      expect ('(');
+      r->guard = group ();
+    }
+  expect (';');
+  r->source = xstrndup (start, pos - start);
+  if (!egraph)
+    flatten (r, r->pattern, "");
+}
+
+/* Code generation */
+
+static void
+indent (int n)
+{
+  while (n >= 8)
+    {
+      putc ('\t', out);
+      n -= 8;
+    }
+  while (n-- > 0)
+    putc (' ', out);
+}
+
+static void
+print_path (const char *path)
+{
+  fputs ("node", out);
+  for (; *path; path++)
+    fputs (*path == 'l' ? "->left" : "->right", out);
+}
+
+/* Print the C expression TEXT with the variables of R replaced by
+   the values of their constants, cast to CAST */
+static void
+print_expr (struct rule *r, const char *text, const char *cast)
+{
+  const char *p = text, *start;
+  char *name;
+  int i;
+
+  while (*p)
+    {
+      if (*p != '?')
+	{
+	  putc (*p++, out);
+	  continue;
+	}
+      start = ++p;
+      while (isalnum ((unsigned char) *p) || *p == '_')
+	p++;
+      name = xstrndup (start, p - start);
+      i = find_var (r, name);
+      if (i < 0 || strcmp (r->vars[i].kind, "const"))
+	{
+	  line = r->line;
+	  error ("not a constant variable: ?", name);
+	}
+      fprintf (out, "(%s) ", cast);
+      print_path (r->vars[i].path);
+      fputs ("->v.number", out);
+      free (name);
+    }
+}
+
+static void
+print_result (struct rule *r, struct pat *p)
+{
+  switch (p->type) {
+  case PAT_OP:
+    fprintf (out, "rewrite_%s (%s, ",
+	     p->op->arity == 2 ? "binop" : "unop", p->op->opcode);
+    print_result (r, p->kid[0]);
+    if (p->op->arity == 2)
+      {
+	fputs (", ", out);
+	print_result (r, p->kid[1]);
+      }
+    fputs (")", out);
+    break;
+  case PAT_CONST:
+    fprintf (out, "rewrite_const (%ldL)", p->number);
+    break;
+  case PAT_VALUE:
+    fputs ("rewrite_const ((long) (", out);
+    print_expr (r, p->text, "unsigned long");
+    fputs ("))", out);
+    break;
+  case PAT_VAR:
+    print_path (r->vars[p->var].path);
+    break;
+  }
+}
+
+static void
+print_comment (struct rule *r, int n)
+{
+  const char *p;
+
+  indent (n);
+  fprintf (out, "/* %s:%d: ", input_name, r->line);
+  for (p = r->source; *p; p++)
+    if (*p == '\n')
+      {
+	putc ('\n', out);
+	indent (n + 3);
+	while (isspace ((unsigned char) p[1]))
+	  p++;
+      }
+    else if (p[0] != '*' || p[1] != '/')
+      putc (*p, out);
+  fputs (" */\n", out);
+}
+
+/* Apply the rule of a leaf if its kinds and guard allow; returns
+   nonzero if it always applies */
+static int
+print_apply (struct rule *r, int n)
+{
+  int i, conds = 0;
+
+  print_comment (r, n);
+  for (i = 0; i < r->nvars; i++)
+    {
+      const char *kind = r->vars[i].kind;
+      if (strcmp (kind, "bool") && strcmp (kind, "pure")
+	  && strcmp (kind, "!const"))
+	continue;
+      if (conds++)
+	{
+	  fputs ("\n", out);
+	  indent (n + 4);
+	  fputs ("&& ", out);
+	}
+      else
+	{
+	  indent (n);
+	  fputs ("if (", out);
+	}
+      if (strcmp (kind, "!const") == 0)
+	{
+	  print_path (r->vars[i].path);
+	  fputs ("->type != NODE_CONST", out);
+	}
+      else
+	{
+	  fprintf (out, "rewrite_%s (", kind);
+	  print_path (r->vars[i].path);
+	  fputs (")", out);
+	}
+    }
+  if (r->guard)
+    {
+      if (conds++)
+	{
+	  fputs ("\n", out);
+	  indent (n + 4);
+	  fputs ("&& ", out);
+	}
+      else
+	{
+	  indent (n);
+	  fputs ("if (", out);
+	}
+      fputs ("(", out);
+      print_expr (r, r->guard, "long");
+      fputs (")", out);
+    }
+  if (conds)
+    {
+      fputs (")\n", out);
+      n += 2;
+    }
+
+  indent (n);
+  fputs ("{\n", out);
+  indent (n + 2);
+  fputs ("NODE *by = ", out);
+  print_result (r, r->result);
+  fputs (";\n", out);
+  for (i = 0; i < r->nvars; i++)
+    if (!r->vars[i].used)
+      {
+	indent (n + 2);
+	if (strcmp (r->vars[i].kind, "const") == 0)
+	  fputs ("rewrite_free (", out);
+	else
+	  fputs ("rewrite_drop (", out);
+	print_path (r->vars[i].path);
+	fputs (");\n", out);
+      }
+  for (i = 0; i < r->ninner; i++)
+    {
+      indent (n + 2);
+      fputs ("rewrite_free (", out);
+      print_path (r->inner[i]);
+      fputs (");\n", out);
+    }
+  indent (n + 2);
+  fprintf (out, "return rewrite_replace (node, by, %d);\n", r->line);
+  indent (n);
+  fputs ("}\n", out);
+  return conds == 0;
+}
+
+/* The first test of the row not decided yet */
+static struct test *
+next_test (struct row *row)
+{
+  int i;
+
+  for (i = 0; i < row->rule->ntests; i++)
+    if (!(row->done & (1UL << i)))
+      return &row->rule->tests[i];
+  return NULL;
+}
+
+/* The test of the row at the place of T, if not decided yet */
+static int
+test_at (struct row *row, struct test *t)
+{
+  int i;
+
+  for (i = 0; i < row->rule->ntests; i++)
+    if (!(row->done & (1UL << i))
+	&& row->rule->tests[i].value == t->value
+	&& strcmp (row->rule->tests[i].path, t->path) == 0)
+      return i;
+  return -1;
+}
+
+static void
+build (struct row *rows, int nrows, int n)
+{
+  struct test *t, at;
+  struct row *sub;
+  const char *keys[64];
+  int i, j, k, nkeys = 0, nsub, rest = 0;
+
+  if (nrows == 0)
+    return;
+  t = next_test (&rows[0]);
+  if (!t)
+    {
+      /* The first rule matched as far as the tree goes */
+      if (!print_apply (rows[0].rule, n))
+	build (rows + 1, nrows - 1, n);
+      return;
+    }
+
+  at = *t;
+  for (i = 0; i < nrows; i++)
+    {
+      k = test_at (&rows[i], &at);
+      if (k < 0)
+	{
+	  rest++;
+	  continue;
+	}
+      for (j = 0; j < nkeys; j++)
+	if (strcmp (keys[j], rows[i].rule->tests[k].key) == 0)
+	  break;
+      if (j == nkeys)
+	{
+	  if (nkeys == 64)
+	    error ("too many cases", NULL);
+	  keys[nkeys++] = rows[i].rule->tests[k].key;
+	}
+    }
+
+  indent (n);
+  fputs ("switch (", out);
+  if (at.value)
+    {
+      print_path (at.path);
+      fputs ("->v.number", out);
+    }
+  else
+    {
+      fputs ("RW_KEY (", out);
+      print_path (at.path);
+      fputs (")", out);
+    }
+  fputs (") {\n", out);
+
+  sub = xmalloc (nrows * sizeof (*sub));
+  for (j = 0; j <= nkeys; j++)
+    {
+      if (j == nkeys && rest == 0)
+	break;
+      nsub = 0;
+      for (i = 0; i < nrows; i++)
+	{
+	  k = test_at (&rows[i], &at);
+	  if (k < 0)
+	    sub[nsub++] = rows[i];
+	  else if (j < nkeys && strcmp (keys[j], rows[i].rule->tests[k].key) == 0)
+	    {
+	      sub[nsub] = rows[i];
+	      sub[nsub++].done |= 1UL << k;
+	    }
+	}
+      indent (n);
+      if (j < nkeys)
+	fprintf (out, "case %s:\n", keys[j]);
+      else
+	fputs ("default:\n", out);
+      build (sub, nsub, n + 2);
+      indent (n + 2);
+      fputs ("break;\n", out);
+    }
+  free (sub);
+  indent (n);
+  fputs ("}\n", out);
+}
+
+/* E-graph tables */
+
+/* Write out the pattern P, its operands first.  Returns its number. */
+static int
+print_pat (struct pat *p)
+{
+  int kid[2] = { -1, -1 };
+  int i, n;
+
+  if (p->type == PAT_OP)
+    for (i = 0; i < p->op->arity; i++)
+      kid[i] = print_pat (p->kid[i]);
+  n = npats++;
+  fprintf (out, "static const struct egraph_pat p%d =\n  { ", n);
+  switch (p->type) {
+  case PAT_OP:
+    fprintf (out, "RW_OP (%s, %s), 0, 0", p->op->type, p->op->opcode);
+    break;
+  case PAT_CONST:
+    fprintf (out, "RW_TYPE (NODE_CONST), %ldL, 0", p->number);
+    break;
+  case PAT_VAR:
+    fprintf (out, "-1, 0, %d", p->var);
+    break;
+  default:
+    abort ();
+  }
+  fputs (", { ", out);
+  for (i = 0; i < 2; i++)
+    {
+      if (kid[i] < 0)
+	fputs ("NULL", out);
+      else
+	fprintf (out, "&p%d", kid[i]);
+      fputs (i ? " } };\n" : ", ", out);
+    }
+  return n;
+}
+
+static void
+print_egraph (void)
+{
+  int *lhs = xmalloc ((nrules ? nrules : 1) * sizeof (*lhs));
+  int *rhs = xmalloc ((nrules ? nrules : 1) * sizeof (*rhs));
+  int i, nvars = 0;
+
+  for (i = 0; i < nrules; i++)
+    if (rules[i].nvars > nvars)
+      nvars = rules[i].nvars;
+  fprintf (out, "#if EGRAPH_VARS < %d\n"
+	   "#error \"%s: more variables in a rule than EGRAPH_VARS\"\n"
+	   "#endif\n", nvars, input_name);
+  for (i = 0; i < nrules; i++)
+    {
+      fputs ("\n", out);
+      print_comment (&rules[i], 0);
+      lhs[i] = print_pat (rules[i].pattern);
+      rhs[i] = print_pat (rules[i].result);
+    }
+  fputs ("\nconst struct egraph_rule egraph_rules[] = {\n", out);
+  for (i = 0; i < nrules; i++)
+    fprintf (out, "  { &p%d, &p%d },\n", lhs[i], rhs[i]);
+  fprintf (out, "};\n\nconst int egraph_nrules = %d;\n", nrules);
+  free (lhs);
+  free (rhs);
+}
+
+static char *
+read_file (const char *name)
+{
+  FILE *fp = fopen (name, "r");
+  char *buf = NULL;
+  size_t len = 0, size = 0, n;
+
+  if (!fp)
+    {
+      perror (name);
+      exit (EXIT_FAILURE);
+    }
+  do {
+    if (len + 1024 + 1 > size)
+      {
+	size = size ? size * 2 : 4096;
+	buf = realloc (buf, size);
+	if (!buf)
+	  exit (EXIT_FAILURE);
+      }
+    n = fread (buf + len, 1, size - len - 1, fp);
+    len += n;
+  } while (n > 0);
+  fclose (fp);
+  buf[len] = 0;
+  return buf;
+}
+
+int
+main (int argc, char *argv[])
+{
+  struct row *rows;
+  int i;
+
+  if (argc == 4 && strcmp (argv[1], "-e") == 0)
+    {
+      egraph = 1;
+      argc--;
+      argv++;
+    }
+  if (argc != 3)
+    {
+      fprintf (stderr, "usage: %s [-e] rules output\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  input_name = argv[1];
+  text = pos = read_file (input_name);
+
+  for (skip_space (); *pos; skip_space ())
+    parse_rule ();
+
+  rows = xmalloc ((nrules ? nrules : 1) * sizeof (*rows));
+  for (i = 0; i < nrules; i++)
+    {
+      rows[i].rule = &rules[i];
+      rows[i].done = 0;
+    }
+
+  out = fopen (argv[2], "w");
+  if (!out)
+    {
+      perror (argv[2]);
+      return EXIT_FAILURE;
+    }
+  fprintf (out, "/* Generated by rulegen from %s, do not edit */\n\n",
+	   input_name);
+  fputs ("#include <stdlib.h>\n\n#include \"tree.h\"\n"
+	 "#include \"rewrite.h\"\n", out);
+  if (egraph)
+    {
+      fputs ("#include \"egraph.h\"\n\n", out);
+      print_egraph ();
+    }
+  else
+    {
+      fputs ("\n", out);
+      fprintf (out, "/* Apply the first of the %d rules matching NODE.  "
+	       "Returns the\n   line of the rule, or 0 if none did. */\n",
+	       nrules);
+      fputs ("int\nrewrite_match (NODE *node)\n{\n", out);
+      build (rows, nrules, 2);
+      fputs ("  return 0;\n}\n", out);
+    }
+  if (fclose (out) != 0)
+    {
+      perror (argv[2]);
+      remove (argv[2]);
+      return EXIT_FAILURE;
+    }
+  return 0;
+}
@@ -0,0 +1,1113 @@
+/*
+   V5: ssa.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "ipa.h"
+#include "optimize.h"
+#include "ssa.h"
+
+extern int verbose;
+
+/*
+  Static single assignment form.
+
+  The SSA form is built over the control-flow graph without changing
+  the tree: every use of a variable (a NODE_VAR) is mapped to the
+  single value reaching it, which is the value stored by an assignment
+  or declaration, a phi merging the values of the predecessors, the
+  value on entry, or a clobber left by a call whose mod set holds the
+  variable.  Calls are clobbered before any use of the statement is
+  mapped, whatever the order of evaluation.
+
+  The construction follows Braun et al., "Simple and Efficient
+  Construction of Static Single Assignment Form": blocks are filled
+  in reverse postorder, and sealed once all their predecessors are
+  filled.  A phi all of whose operands are the same value, or itself,
+  forwards to that value; the phis are checked again once the form is
+  complete, since removing one phi may leave another trivial.
+*/
+
+static struct ssa *ssa;            /* form being built */
+static struct ssa_site *cur_site;  /* site being filled */
+
+static struct ssa_value *
+find (struct ssa_value *v)
+{
+  while (v && v->forward)
+    v = v->forward;
+  return v;
+}
+
+static struct ssa_value *
+new_value (enum ssa_kind kind, SYMBOL *s, struct cfg_block *b)
+{
+  struct ssa_value *v = calloc (1, sizeof (*v));
+
+  if (!v)
+    exit (EXIT_FAILURE);
+  if (ssa->nvalues == ssa->values_size)
+    {
+      ssa->values_size = ssa->values_size ? ssa->values_size * 2 : 64;
+      ssa->values = xrealloc (ssa->values,
+			      ssa->values_size * sizeof (*ssa->values));
+    }
+  v->id = ssa->nvalues;
+  ssa->values[ssa->nvalues++] = v;
+  v->kind = kind;
+  v->symbol = s;
+  v->block = b;
+  v->lat = (kind == SSA_ENTRY || kind == SSA_CLOBBER) ? LAT_BOTTOM : LAT_TOP;
+
+  if (b && kind == SSA_PHI)
+    {
+      v->block_next = ssa->blocks[b->index].phis;
+      ssa->blocks[b->index].phis = v;
+    }
+  else if (b)
+    {
+      struct ssa_block *sb = &ssa->blocks[b->index];
+      if (!sb->values_tail)
+	sb->values_tail = &sb->values;
+      *sb->values_tail = v;
+      sb->values_tail = &v->block_next;
+    }
+  return v;
+}
+
+static void
+write_variable (SYMBOL *s, struct cfg_block *b, struct ssa_value *v)
+{
+  ptrmap_put (&ssa->current, s, b->index, v);
+}
+
+static struct ssa_value *
+entry_value (SYMBOL *s)
+{
+  size_t sub = ssa->cfg->nblocks;
+  struct ssa_value *v = ptrmap_get (&ssa->current, s, sub);
+
+  if (!v)
+    {
+      v = new_value (SSA_ENTRY, s, NULL);
+      ptrmap_put (&ssa->current, s, sub, v);
+    }
+  return v;
+}
+
+static struct ssa_value *read_variable (SYMBOL *, struct cfg_block *);
+
+static struct ssa_value *
+try_remove_trivial_phi (struct ssa_value *phi)
+{
+  struct ssa_value *same = NULL;
+  size_t i;
+
+  for (i = 0; i < phi->nargs; i++)
+    {
+      struct ssa_value *op = find (phi->args[i]);
+      if (op == same || op == phi)
+	continue;
+      if (same)
+	return phi;
+      same = op;
+    }
+  if (!same)
+    same = entry_value (phi->symbol);
+  phi->forward = same;
+  return same;
+}
+
+static struct ssa_value *
+add_phi_operands (struct ssa_value *phi)
+{
+  struct cfg_block *b = phi->block;
+  size_t i;
+
+  phi->nargs = b->npreds;
+  phi->args = xrealloc (NULL, b->npreds * sizeof (*phi->args));
+  for (i = 0; i < b->npreds; i++)
+    phi->args[i] = read_variable (phi->symbol, b->preds[i]);
+  return try_remove_trivial_phi (phi);
+}
+
+static struct ssa_value *
+read_variable_recursive (SYMBOL *s, struct cfg_block *b)
+{
+  struct ssa_block *sb = &ssa->blocks[b->index];
+  struct ssa_value *v;
+
+  if (!sb->sealed)
+    {
+      v = new_value (SSA_PHI, s, b);
+      if (sb->nincomplete == sb->incomplete_size)
+	{
+	  sb->incomplete_size = sb->incomplete_size
+	    ? sb->incomplete_size * 2 : 4;
+	  sb->incomplete = xrealloc (sb->incomplete, sb->incomplete_size
+				     * sizeof (*sb->incomplete));
+	}
+      sb->incomplete[sb->nincomplete++] = v;
+    }
+  else if (b->npreds == 0)
+    v = entry_value (s);
+  else if (b->npreds == 1)
+    v = read_variable (s, b->preds[0]);
+  else
+    {
+      v = new_value (SSA_PHI, s, b);
+      write_variable (s, b, v);
+      v = add_phi_operands (v);
+    }
+  write_variable (s, b, v);
+  return v;
+}
+
+static struct ssa_value *
+read_variable (SYMBOL *s, struct cfg_block *b)
+{
+  struct ssa_value *v = ptrmap_get (&ssa->current, s, b->index);
+
+  if (v)
+    return find (v);
+  return read_variable_recursive (s, b);
+}
+
+static void
+seal_block (struct cfg_block *b)
+{
+  struct ssa_block *sb = &ssa->blocks[b->index];
+  size_t i;
+
+  for (i = 0; i < sb->nincomplete; i++)
+    add_phi_operands (sb->incomplete[i]);
+  free (sb->incomplete);
+  sb->incomplete = NULL;
+  sb->nincomplete = sb->incomplete_size = 0;
+  sb->sealed = 1;
+}
+
+static int
+preds_filled (struct cfg_block *b)
+{
+  size_t i;
+
+  for (i = 0; i < b->npreds; i++)
+    if (!ssa->blocks[b->preds[i]->index].filled)
+      return 0;
+  return 1;
+}
+
+
+/* Sites */
+
+/* The NODE_EXPR holding the expression evaluated by a statement */
+static NODE *
+stmt_expr (NODE *node)
+{
+  switch (node->type) {
+  case NODE_ASGN:
+    return node->v.asgn.expr;
+  case NODE_VAR_DECL:
+    return node->v.vardecl.expr;
+  case NODE_RETURN:
+  case NODE_PRINT:
+    return node->v.expr;
+  case NODE_EXPR:
+    return node;
+  default:
+    return NULL;
+  }
+}
+
+/* Apply FPTAB to the expressions of a site */
+static void
+site_traverse (struct ssa_site *site, traverse_fp *fptab)
+{
+  ARGLIST *arg;
+
+  if (site->expr)
+    traverse_expr (site->expr->v.expr, fptab);
+  else if (site->stmt->type == NODE_CALL)
+    {
+      for (arg = site->stmt->v.funcall.args; arg; arg = arg->next)
+	traverse_expr (arg->node, fptab);
+      fptab[NODE_CALL] (site->stmt);
+    }
+}
+
+static void
+track_var (NODE *node)
+{
+  ptrmap_put (&ssa->tracked, node->v.symbol, 0, node->v.symbol);
+}
+
+static void
+clobber_call (NODE *node)
+{
+  SYMBOL *f = node->v.funcall.symbol;
+  size_t i;
+
+  for (i = 0; i < f->v.fnc->nmod; i++)
+    {
+      SYMBOL *s = f->v.fnc->mod[i];
+      if (ptrmap_get (&ssa->tracked, s, 0))
+	write_variable (s, cur_site->block,
+			new_value (SSA_CLOBBER, s, cur_site->block));
+    }
+}
+
+static void
+map_use (NODE *node)
+{
+  ptrmap_put (&ssa->uses, node, 0,
+	      read_variable (node->v.symbol, cur_site->block));
+}
+
+static void
+no_op (NODE *node)
+{
+}
+
+traverse_fp ssa_track_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  track_var,   /* NODE_VAR */
+  no_op,       /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+traverse_fp ssa_clobber_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  NULL,        /* NODE_VAR */
+  clobber_call,/* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+traverse_fp ssa_use_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  map_use,     /* NODE_VAR */
+  no_op,       /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+static struct ssa_site *
+new_site (struct cfg_block *b, NODE *stmt, NODE *expr, int is_branch)
+{
+  struct ssa_block *sb = &ssa->blocks[b->index];
+  struct ssa_site *site = calloc (1, sizeof (*site));
+
+  if (!site)
+    exit (EXIT_FAILURE);
+  site->stmt = stmt;
+  site->expr = expr;
+  site->block = b;
+  site->is_branch = is_branch;
+
+  if (ssa->nsites == ssa->sites_size)
+    {
+      ssa->sites_size = ssa->sites_size ? ssa->sites_size * 2 : 64;
+      ssa->sites = xrealloc (ssa->sites,
+			     ssa->sites_size * sizeof (*ssa->sites));
+    }
+  ssa->sites[ssa->nsites++] = site;
+  if (sb->nsites == sb->sites_size)
+    {
+      sb->sites_size = sb->sites_size ? sb->sites_size * 2 : 4;
+      sb->sites = xrealloc (sb->sites, sb->sites_size * sizeof (*sb->sites));
+    }
+  sb->sites[sb->nsites++] = site;
+  return site;
+}
+
+static void
+fill_site (struct ssa_site *site)
+{
+  NODE *node = site->stmt;
+  SYMBOL *s = NULL;
+
+  cur_site = site;
+  site_traverse (site, ssa_clobber_fptab);
+  site_traverse (site, ssa_use_fptab);
+
+  if (site->is_branch)
+    return;
+  if (node->type == NODE_ASGN)
+    s = node->v.asgn.symbol;
+  else if (node->type == NODE_VAR_DECL)
+    s = node->v.vardecl.symbol;
+  if (s)
+    {
+      site->def = new_value (SSA_DEF, s, site->block);
+      site->def->def = node;
+      if (!site->expr)
+	site->def->lat = LAT_BOTTOM;
+      write_variable (s, site->block, site->def);
+    }
+}
+
+static void
+fill_block (struct cfg_block *b)
+{
+  size_t i;
+
+  for (i = 0; i < b->nstmts; i++)
+    fill_site (new_site (b, b->stmts[i], stmt_expr (b->stmts[i]), 0));
+  if (b->branch)
+    fill_site (new_site (b, b->branch, cfg_branch_cond (b), 1));
+  ssa->blocks[b->index].filled = 1;
+}
+
+static void
+add_user (struct ssa_value *v, struct ssa_site *site, struct ssa_value *phi)
+{
+  if (v->nusers
+      && v->users[v->nusers - 1].site == site
+      && v->users[v->nusers - 1].phi == phi)
+    return;
+  if (v->nusers == v->users_size)
+    {
+      v->users_size = v->users_size ? v->users_size * 2 : 4;
+      v->users = xrealloc (v->users, v->users_size * sizeof (*v->users));
+    }
+  v->users[v->nusers].site = site;
+  v->users[v->nusers].phi = phi;
+  v->nusers++;
+}
+
+static void
+note_user (NODE *node)
+{
+  add_user (ssa_use_value (ssa, node), cur_site, NULL);
+}
+
+traverse_fp ssa_user_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  note_user,   /* NODE_VAR */
+  no_op,       /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+struct ssa *
+ssa_build (struct cfg *g)
+{
+  size_t i, j;
+  int changed;
+
+  ssa = calloc (1, sizeof (*ssa));
+  if (!ssa)
+    exit (EXIT_FAILURE);
+  ssa->cfg = g;
+  ssa->blocks = calloc (g->nblocks ? g->nblocks : 1, sizeof (*ssa->blocks));
+  if (!ssa->blocks)
+    exit (EXIT_FAILURE);
+  ptrmap_init (&ssa->current);
+  ptrmap_init (&ssa->uses);
+  ptrmap_init (&ssa->tracked);
+
+  /* The variables used in the graph; a call clobbers only those */
+  for (i = 0; i < g->nrpo; i++)
+    {
+      struct cfg_block *b = g->rpo[i];
+      struct ssa_site site;
+
+      site.block = b;
+      for (j = 0; j <= b->nstmts; j++)
+	{
+	  NODE *node = j < b->nstmts ? b->stmts[j] : b->branch;
+	  if (!node)
+	    continue;
+	  site.stmt = node;
+	  site.expr = j < b->nstmts ? stmt_expr (node) : cfg_branch_cond (b);
+	  site_traverse (&site, ssa_track_fptab);
+	  if (node->type == NODE_ASGN)
+	    ptrmap_put (&ssa->tracked, node->v.asgn.symbol, 0,
+			node->v.asgn.symbol);
+	  else if (node->type == NODE_VAR_DECL)
+	    ptrmap_put (&ssa->tracked, node->v.vardecl.symbol, 0,
+			node->v.vardecl.symbol);
+	}
+    }
+
+  for (i = 0; i < g->nrpo; i++)
+    {
+      struct cfg_block *b = g->rpo[i];
+      int k;
+
+      if (preds_filled (b))
+	seal_block (b);
+      fill_block (b);
+      for (k = 0; k < 2; k++)
+	if (b->succ[k] && !ssa->blocks[b->succ[k]->index].sealed
+	    && preds_filled (b->succ[k]))
+	  seal_block (b->succ[k]);
+    }
+
+  /* A phi may become trivial once one of its operands is removed */
+  do
+    {
+      changed = 0;
+      for (i = 0; i < ssa->nvalues; i++)
+	{
+	  struct ssa_value *v = ssa->values[i];
+	  if (v->kind == SSA_PHI && !v->forward && v->args
+	      && try_remove_trivial_phi (v) != v)
+	    changed = 1;
+	}
+    }
+  while (changed);
+
+  /* The users of every value */
+  for (i = 0; i < ssa->nsites; i++)
+    {
+      cur_site = ssa->sites[i];
+      site_traverse (cur_site, ssa_user_fptab);
+    }
+  for (i = 0; i < ssa->nvalues; i++)
+    {
+      struct ssa_value *v = ssa->values[i];
+      if (v->kind == SSA_PHI && !v->forward)
+	for (j = 0; j < v->nargs; j++)
+	  add_user (find (v->args[j]), NULL, v);
+    }
+
+  cur_site = NULL;
+  return ssa;
+}
+
+void
+ssa_free (struct ssa *f)
+{
+  size_t i;
+
+  if (!f)
+    return;
+  for (i = 0; i < f->nvalues; i++)
+    {
+      free (f->values[i]->args);
+      free (f->values[i]->users);
+      free (f->values[i]);
+    }
+  for (i = 0; i < f->nsites; i++)
+    free (f->sites[i]);
+  for (i = 0; i < f->cfg->nblocks; i++)
+    {
+      free (f->blocks[i].incomplete);
+      free (f->blocks[i].sites);
+      free (f->blocks[i].edge_executable);
+    }
+  free (f->values);
+  free (f->sites);
+  free (f->blocks);
+  ptrmap_free (&f->current);
+  ptrmap_free (&f->uses);
+  ptrmap_free (&f->tracked);
+  free (f);
+}
+
+/* The value reaching the variable reference NODE */
+struct ssa_value *
+ssa_use_value (struct ssa *f, NODE *node)
+{
+  return find (ptrmap_get (&f->uses, node, 0));
+}
+
+/* The value flowing into PHI from its I-th predecessor */
+struct ssa_value *
+ssa_phi_arg (struct ssa_value *phi, size_t i)
+{
+  return find (phi->args[i]);
+}
+
+static void
+print_value (struct ssa_value *v)
+{
+  printf ("%s.%lu", v->symbol->name, (unsigned long) v->id);
+}
+
+static void
+print_lattice (struct ssa_value *v)
+{
+  if (v->lat == LAT_CONST)
+    printf (" [%ld]", v->constant);
+  else if (v->lat == LAT_TOP)
+    printf (" [top]");
+}
+
+void
+ssa_print (struct ssa *f)
+{
+  struct cfg *g = f->cfg;
+  size_t i, j;
+
+  printf ("=== SSA form of %s ===\n\n",
+	  g->function ? g->function->name : "the top level");
+  for (i = 0; i < g->nrpo; i++)
+    {
+      struct cfg_block *b = g->rpo[i];
+      struct ssa_block *sb = &f->blocks[b->index];
+      struct ssa_value *v;
+
+      printf ("B%lu:%s\n", (unsigned long) b->index,
+	      sb->executable ? "" : " (not executed)");
+      for (v = sb->phis; v; v = v->block_next)
+	{
+	  if (v->forward)
+	    continue;
+	  printf ("\t ");
+	  print_value (v);
+	  printf (" = phi (");
+	  for (j = 0; j < v->nargs; j++)
+	    {
+	      if (j)
+		printf (", ");
+	      print_value (find (v->args[j]));
+	    }
+	  printf (")");
+	  print_lattice (v);
+	  printf ("\n");
+	}
+      for (v = sb->values; v; v = v->block_next)
+	{
+	  printf ("\t ");
+	  print_value (v);
+	  if (v->kind == SSA_CLOBBER)
+	    printf (" = clobber");
+	  else
+	    printf (" = node %4.4lu", v->def->node_id);
+	  print_lattice (v);
+	  printf ("\n");
+	}
+    }
+  printf ("\n");
+}
+
+
+/* Sparse conditional constant propagation
+
+   Wegman and Zadeck: values start at TOP and only go down the
+   lattice TOP > CONST > BOTTOM.  Blocks are evaluated once they
+   are reached by an executable edge, and a phi meets only the
+   operands coming over executable edges.  Arithmetic wraps around,
+   and division by zero is left to the run time. */
+
+struct lat
+{
+  enum ssa_lattice k;
+  long c;
+};
+
+static struct ssa_value **value_work;
+static size_t nvalue_work, value_work_size;
+static struct cfg_block **block_work;
+static size_t nblock_work, block_work_size;
+
+static struct lat
+lat_make (enum ssa_lattice k, long c)
+{
+  struct lat r;
+
+  r.k = k;
+  r.c = c;
+  return r;
+}
+
+static struct lat
+eval_expr (NODE *node)
+{
+  struct lat l, r;
+  unsigned long a, b;
+
+  if (!node)
+    return lat_make (LAT_BOTTOM, 0);
+
+  switch (node->type) {
+  case NODE_CONST:
+    return lat_make (LAT_CONST, node->v.number);
+
+  case NODE_VAR:
+    {
+      struct ssa_value *v = ssa_use_value (ssa, node);
+      if (!v)
+	return lat_make (LAT_BOTTOM, 0);
+      return lat_make (v->lat, v->constant);
+    }
+
+  case NODE_EXPR:
+    return eval_expr (node->v.expr);
+
+  case NODE_UNOP:
+    l = eval_expr (node->left);
+    if (l.k != LAT_CONST)
+      return l;
+    if (node->v.opcode == OPCODE_NEG)
+      return lat_make (LAT_CONST, (long) (0UL - (unsigned long) l.c));
+    if (node->v.opcode == OPCODE_NOT)
+      return lat_make (LAT_CONST, !l.c);
+    return lat_make (LAT_BOTTOM, 0);
+
+  case NODE_BINOP:
+    l = eval_expr (node->left);
+    if (node->v.opcode == OPCODE_AND)
+      {
+	if (l.k == LAT_CONST && !l.c)
+	  return lat_make (LAT_CONST, 0);
+	r = eval_expr (node->right);
+	if (l.k == LAT_TOP || r.k == LAT_TOP)
+	  return lat_make (LAT_TOP, 0);
+	if (r.k == LAT_CONST && !r.c)
+	  return lat_make (LAT_CONST, 0);
+	if (l.k == LAT_CONST && r.k == LAT_CONST)
+	  return lat_make (LAT_CONST, 1);
+	return lat_make (LAT_BOTTOM, 0);
+      }
+    if (node->v.opcode == OPCODE_OR)
+      {
+	if (l.k == LAT_CONST && l.c)
+	  return lat_make (LAT_CONST, 1);
+	r = eval_expr (node->right);
+	if (l.k == LAT_TOP || r.k == LAT_TOP)
+	  return lat_make (LAT_TOP, 0);
+	if (r.k == LAT_CONST && r.c)
+	  return lat_make (LAT_CONST, 1);
+	if (l.k == LAT_CONST && r.k == LAT_CONST)
+	  return lat_make (LAT_CONST, 0);
+	return lat_make (LAT_BOTTOM, 0);
+      }
+    r = eval_expr (node->right);
+    if (node->v.opcode == OPCODE_MUL
+	&& ((l.k == LAT_CONST && !l.c) || (r.k == LAT_CONST && !r.c)))
+      return lat_make (LAT_CONST, 0);
+    if (l.k == LAT_BOTTOM || r.k == LAT_BOTTOM)
+      return lat_make (LAT_BOTTOM, 0);
+    if (l.k == LAT_TOP || r.k == LAT_TOP)
+      return lat_make (LAT_TOP, 0);
+
+    a = l.c;
+    b = r.c;
+    switch (node->v.opcode) {
+    case OPCODE_ADD:
+      return lat_make (LAT_CONST, (long) (a + b));
+    case OPCODE_SUB:
+      return lat_make (LAT_CONST, (long) (a - b));
+    case OPCODE_MUL:
+      return lat_make (LAT_CONST, (long) (a * b));
+    case OPCODE_DIV:
+      if (r.c == 0 || (l.c == LONG_MIN && r.c == -1))
+	return lat_make (LAT_BOTTOM, 0);
+      return lat_make (LAT_CONST, l.c / r.c);
+    case OPCODE_EQ:
+      return lat_make (LAT_CONST, l.c == r.c);
+    case OPCODE_NE:
+      return lat_make (LAT_CONST, l.c != r.c);
+    case OPCODE_LT:
+      return lat_make (LAT_CONST, l.c < r.c);
+    case OPCODE_GT:
+      return lat_make (LAT_CONST, l.c > r.c);
+    case OPCODE_LE:
+      return lat_make (LAT_CONST, l.c <= r.c);
+    case OPCODE_GE:
+      return lat_make (LAT_CONST, l.c >= r.c);
+    case OPCODE_MOD:
+      if (r.c == 0)
+	return lat_make (LAT_BOTTOM, 0);
+      if (r.c == -1)
+	return lat_make (LAT_CONST, 0);
+      return lat_make (LAT_CONST, l.c % r.c);
+    case OPCODE_SHL:
+      return lat_make (LAT_CONST, (long) (a << (b & 63)));
+    case OPCODE_SHR:
+      return lat_make (LAT_CONST, l.c >> (b & 63));
+    case OPCODE_BAND:
+      return lat_make (LAT_CONST, l.c & r.c);
+    default:
+      return lat_make (LAT_BOTTOM, 0);
+    }
+
+  default:
+    /* calls */
+    return lat_make (LAT_BOTTOM, 0);
+  }
+}
+
+static void
+lower (struct ssa_value *v, struct lat r)
+{
+  if (v->lat == LAT_BOTTOM || r.k == LAT_TOP)
+    return;
+  if (r.k == LAT_CONST && v->lat == LAT_CONST && r.c == v->constant)
+    return;
+  if (r.k == LAT_CONST && v->lat == LAT_TOP)
+    {
+      v->lat = LAT_CONST;
+      v->constant = r.c;
+    }
+  else
+    v->lat = LAT_BOTTOM;
+
+  if (nvalue_work == value_work_size)
+    {
+      value_work_size = value_work_size ? value_work_size * 2 : 64;
+      value_work = xrealloc (value_work,
+			     value_work_size * sizeof (*value_work));
+    }
+  value_work[nvalue_work++] = v;
+}
+
+static void mark_edge (struct cfg_block *, int);
+
+static void
+eval_phi (struct ssa_value *phi)
+{
+  struct ssa_block *sb = &ssa->blocks[phi->block->index];
+  struct lat r = lat_make (LAT_TOP, 0);
+  size_t i;
+
+  if (!sb->executable || phi->forward)
+    return;
+  for (i = 0; i < phi->nargs && r.k != LAT_BOTTOM; i++)
+    {
+      struct ssa_value *op = find (phi->args[i]);
+      if (!sb->edge_executable[i] || op->lat == LAT_TOP)
+	continue;
+      if (op->lat == LAT_BOTTOM
+	  || (r.k == LAT_CONST && r.c != op->constant))
+	r = lat_make (LAT_BOTTOM, 0);
+      else
+	r = lat_make (LAT_CONST, op->constant);
+    }
+  lower (phi, r);
+}
+
+static void
+eval_site (struct ssa_site *site)
+{
+  struct lat r;
+
+  if (!ssa->blocks[site->block->index].executable)
+    return;
+  if (site->is_branch)
+    {
+      r = eval_expr (site->expr);
+      if (r.k == LAT_CONST)
+	mark_edge (site->block, r.c ? 0 : 1);
+      else if (r.k == LAT_BOTTOM)
+	{
+	  mark_edge (site->block, 0);
+	  mark_edge (site->block, 1);
+	}
+    }
+  else if (site->def && site->expr)
+    lower (site->def, eval_expr (site->expr));
+}
+
+static void
+mark_edge (struct cfg_block *b, int k)
+{
+  struct cfg_block *s = b->succ[k];
+  struct ssa_block *sb;
+  struct ssa_value *phi;
+
+  if (!s)
+    return;
+  sb = &ssa->blocks[s->index];
+  if (sb->edge_executable[b->succ_pred[k]])
+    return;
+  sb->edge_executable[b->succ_pred[k]] = 1;
+
+  if (!sb->executable)
+    {
+      sb->executable = 1;
+      if (nblock_work == block_work_size)
+	{
+	  block_work_size = block_work_size ? block_work_size * 2 : 16;
+	  block_work = xrealloc (block_work,
+				 block_work_size * sizeof (*block_work));
+	}
+      block_work[nblock_work++] = s;
+    }
+  else
+    for (phi = sb->phis; phi; phi = phi->block_next)
+      eval_phi (phi);
+}
+
+static void
+visit_block (struct cfg_block *b)
+{
+  struct ssa_block *sb = &ssa->blocks[b->index];
+  struct ssa_value *phi;
+  size_t i;
+
+  for (phi = sb->phis; phi; phi = phi->block_next)
+    eval_phi (phi);
+  for (i = 0; i < sb->nsites; i++)
+    eval_site (sb->sites[i]);
+  if (!b->branch)
+    mark_edge (b, 0);
+}
+
+static void
+sccp_solve (void)
+{
+  struct cfg *g = ssa->cfg;
+  size_t i, j;
+
+  for (i = 0; i < g->nrpo; i++)
+    {
+      struct cfg_block *b = g->rpo[i];
+      ssa->blocks[b->index].edge_executable = calloc (b->npreds ? b->npreds
+						      : 1, 1);
+      if (!ssa->blocks[b->index].edge_executable)
+	exit (EXIT_FAILURE);
+    }
+
+  ssa->blocks[g->entry->index].executable = 1;
+  nblock_work = nvalue_work = 0;
+  block_work = xrealloc (block_work, sizeof (*block_work)
+			 * (block_work_size = block_work_size ? block_work_size
+			    : 16));
+  block_work[nblock_work++] = g->entry;
+
+  while (nblock_work || nvalue_work)
+    {
+      if (nblock_work)
+	{
+	  visit_block (block_work[--nblock_work]);
+	  continue;
+	}
+      {
+	struct ssa_value *v = value_work[--nvalue_work];
+	for (j = 0; j < v->nusers; j++)
+	  if (v->users[j].site)
+	    eval_site (v->users[j].site);
+	  else
+	    eval_phi (v->users[j].phi);
+      }
+    }
+}
+
+
+/* Rewriting the tree */
+
+static size_t nrewrites;
+
+static int may_fail;
+
+static void
+note_call (NODE *node)
+{
+  may_fail = 1;
+}
+
+/* A division by anything but a nonzero constant may fail */
+static void
+note_div (NODE *node)
+{
+  if ((node->v.opcode == OPCODE_DIV || node->v.opcode == OPCODE_MOD)
+      && (node->right->type != NODE_CONST || node->right->v.number == 0))
+    may_fail = 1;
+}
+
+static void
+fold_var (NODE *node)
+{
+  struct ssa_value *v = ssa_use_value (ssa, node);
+
+  if (v && v->lat == LAT_CONST)
+    {
+      if (verbose > 1)
+	printf ("Optimizing node %4.4lu (VAR)\n", node->node_id);
+
+      du_unlink (node);
+      node->v.expr = NULL;
+      node->v.number = v->constant;
+      node->type = NODE_CONST;
+      nrewrites++;
+    }
+}
+
+traverse_fp ssa_fail_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  note_div,    /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  NULL,        /* NODE_VAR */
+  note_call,   /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+traverse_fp ssa_fold_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  fold_var,    /* NODE_VAR */
+  no_op,       /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+/* Replace a constant expression without calls or divisions that may
+   fail by its value, or else the constant variables in it.  A
+   product by 0 is 0 whatever the other factor, but the factor still
+   has to fail. */
+static void
+rewrite_site (struct ssa_site *site)
+{
+  NODE *expr = site->expr ? site->expr->v.expr : NULL;
+  struct lat r;
+
+  if (expr)
+    {
+      may_fail = 0;
+      traverse_expr (expr, ssa_fail_fptab);
+      r = eval_expr (expr);
+      if (!may_fail && r.k == LAT_CONST)
+	{
+	  if (expr->type == NODE_CONST)
+	    return;
+	  if (verbose > 1)
+	    printf ("Optimizing node %4.4lu (EXPR)\n", expr->node_id);
+
+	  traverse_expr (expr, unlink_fptab);
+	  expr->left = expr->right = NULL;
+	  expr->v.expr = NULL;
+	  expr->v.number = r.c;
+	  expr->type = NODE_CONST;
+	  nrewrites++;
+	  return;
+	}
+    }
+  site_traverse (site, ssa_fold_fptab);
+}
+
+/* The code that is never executed may take any value; its constant
+   variables are folded anyway, so that pass 4 finds them unused. */
+static void
+sccp_rewrite (void)
+{
+  size_t i;
+
+  for (i = 0; i < ssa->nsites; i++)
+    if (ssa->blocks[ssa->sites[i]->block->index].executable)
+      rewrite_site (ssa->sites[i]);
+    else
+      site_traverse (ssa->sites[i], ssa_fold_fptab);
+}
+
+/* Run SCCP on the program rooted at ROOT and fold what it proves
+   constant.  Returns the number of rewritten nodes. */
+size_t
+ssa_sccp (NODE *root)
+{
+  struct cfg *graphs, *g;
+
+  nrewrites = 0;
+  ipa_analyze (root);
+  graphs = cfg_build (root);
+  for (g = graphs; g; g = g->next)
+    {
+      if (verbose > 2)
+	cfg_print (g);
+      ssa = ssa_build (g);
+      sccp_solve ();
+      if (verbose > 2)
+	ssa_print (ssa);
+      sccp_rewrite ();
+      ssa_free (ssa);
+      ssa = NULL;
+    }
+  cfg_free (graphs);
+  ipa_free ();
+
+  free (value_work);
+  free (block_work);
+  value_work = NULL;
+  block_work = NULL;
+  value_work_size = block_work_size = 0;
+  return nrewrites;
+}
@@ -0,0 +1,114 @@
+/*
+   V5: ssa.h
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SSA_H
+#define _SSA_H
+
+#include "cfg.h"
+#include "ptrmap.h"
+
+enum ssa_kind
+{
+  SSA_ENTRY,      /* value on entry, or of an uninitialized variable */
+  SSA_CLOBBER,    /* value after a call that may write the variable */
+  SSA_DEF,        /* value stored by an assignment or a declaration */
+  SSA_PHI         /* merge of the values on the incoming edges */
+};
+
+enum ssa_lattice
+{
+  LAT_TOP,        /* no value seen yet */
+  LAT_CONST,      /* a single constant */
+  LAT_BOTTOM      /* any value */
+};
+
+struct ssa_user;
+
+struct ssa_value
+{
+  enum ssa_kind kind;
+  size_t id;
+  SYMBOL *symbol;
+  struct cfg_block *block;
+  NODE *def;                    /* SSA_DEF: the ASGN or VAR_DECL */
+  struct ssa_value **args;      /* SSA_PHI: one per predecessor */
+  size_t nargs;
+  struct ssa_value *forward;    /* a trivial phi stands for this */
+  struct ssa_value *block_next; /* next value created in the block */
+
+  enum ssa_lattice lat;         /* SCCP lattice value */
+  long constant;
+
+  struct ssa_user *users;
+  size_t nusers, users_size;
+};
+
+/* A place where an expression is evaluated: a statement, or the
+   condition ending a block.  DEF is the value a definition stores. */
+struct ssa_site
+{
+  NODE *stmt;                   /* statement or branch */
+  NODE *expr;                   /* its expression, or NULL */
+  struct cfg_block *block;
+  struct ssa_value *def;
+  int is_branch;
+};
+
+struct ssa_user
+{
+  struct ssa_site *site;        /* either a site */
+  struct ssa_value *phi;        /* or a phi */
+};
+
+struct ssa_block
+{
+  struct ssa_value *phis;
+  struct ssa_value *values;     /* other values, in creation order */
+  struct ssa_value **values_tail;
+  struct ssa_value **incomplete;
+  size_t nincomplete, incomplete_size;
+  struct ssa_site **sites;      /* sites, in execution order */
+  size_t nsites, sites_size;
+  int filled, sealed;
+  int executable;               /* SCCP */
+  unsigned char *edge_executable; /* per predecessor */
+};
+
+struct ssa
+{
+  struct cfg *cfg;
+  struct ssa_block *blocks;     /* indexed like cfg->blocks */
+  struct ssa_value **values;
+  size_t nvalues, values_size;
+  struct ssa_site **sites;
+  size_t nsites, sites_size;
+  struct ptrmap current;        /* (symbol, block) -> value */
+  struct ptrmap uses;           /* NODE_VAR -> value */
+  struct ptrmap tracked;        /* variables used in the graph */
+};
+
+struct ssa *ssa_build (struct cfg *);
+void ssa_free (struct ssa *);
+struct ssa_value *ssa_use_value (struct ssa *, NODE *);
+struct ssa_value *ssa_phi_arg (struct ssa_value *, size_t);
+void ssa_print (struct ssa *);
+
+size_t ssa_sccp (NODE *);
+
+#endif /* not _SSA_H */
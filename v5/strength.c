@@ -0,0 +1,575 @@
+/*
+   V5: strength.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "cfg.h"
+#include "ssa.h"
+#include "ipa.h"
+#include "motion.h"
+#include "strength.h"
+
+extern int verbose;
+
+/*
+  Strength reduction.
+
+  An induction variable of a loop is a variable whose phi at the
+  loop header takes, along every back edge, the value of a single
+  assignment `i = C + i' reading that phi.  The variable then steps
+  by C once per trip.  A product `K * i' of the variable and a
+  constant, read anywhere in the loop, is replaced by a temporary
+  holding it: the temporary is declared as `K * i' before the loop
+  and stepped by K * C right after the assignment to the variable.
+  Products reading the value before the step and after it both see
+  the temporary in step with the variable, and the arithmetic wraps
+  around the same way.
+
+  After that, a multiplication by a power of two becomes a shift
+  left, which wraps around like the product.  A division or modulo
+  by a power of two becomes a shift right or a mask only when the
+  dividend is known not to be negative, since both round towards
+  zero while the shift rounds down.
+
+  Both parts read the SSA form, built with the mod sets of the
+  callees: a call writing a global gives it a new value, so the
+  global is neither stepped by C alone nor known not to be negative
+  after the call.
+*/
+
+#define STEP_MAX  65536L          /* largest step of a counting loop */
+#define START_MAX 4294967296L     /* largest start of a counting loop */
+
+struct iv
+{
+  struct ssa_value *phi;          /* value at the header */
+  struct ssa_value *step;         /* value after the step */
+  long inc;                       /* C */
+  struct iv_temp *temps;          /* products of it */
+};
+
+struct iv_temp
+{
+  long factor;                    /* K */
+  SYMBOL *temp;
+  struct iv_temp *next;
+};
+
+static struct ssa *ssa;
+static struct cfg *graph;
+static struct cfg_loop *loop;
+static struct iv *ivs;
+static size_t nivs, ivs_size;
+static size_t nreduced, nshifts;
+
+static struct ptrmap nonneg_memo;  /* value -> one of the marks */
+static char visiting, yes, no;
+
+/* Split NODE into a constant and a variable operand of OP */
+static int
+const_var (NODE *node, enum opcode_type op, long *c, NODE **var)
+{
+  NODE *l, *r;
+
+  node = strip (node);
+  if (node->type != NODE_BINOP || node->v.opcode != op)
+    return 0;
+  l = strip (node->left);
+  r = strip (node->right);
+  if (l->type == NODE_CONST && r->type == NODE_VAR)
+    {
+      *c = l->v.number;
+      *var = r;
+      return 1;
+    }
+  if (r->type == NODE_CONST && l->type == NODE_VAR)
+    {
+      *c = r->v.number;
+      *var = l;
+      return 1;
+    }
+  return 0;
+}
+
+
+/* Induction variables */
+
+/* The step of PHI, if it is a value assigned `PHI + C' */
+static int
+step_of (struct ssa_value *phi, struct ssa_value *v, long *inc)
+{
+  NODE *var;
+
+  if (v->kind != SSA_DEF || v->def->type != NODE_ASGN)
+    return 0;
+  return const_var (v->def->v.asgn.expr, OPCODE_ADD, inc, &var)
+    && ssa_use_value (ssa, var) == phi;
+}
+
+static void
+find_ivs (void)
+{
+  struct cfg_block *h = loop->header;
+  struct ssa_value *phi, *arg, *step;
+  size_t i;
+  long inc = 0;
+
+  nivs = 0;
+  for (phi = ssa->blocks[h->index].phis; phi; phi = phi->block_next)
+    {
+      if (phi->forward || phi->nargs != h->npreds)
+	continue;
+      step = NULL;
+      for (i = 0; i < phi->nargs; i++)
+	{
+	  if (!cfg_in_loop (loop, h->preds[i]))
+	    continue;
+	  arg = ssa_phi_arg (phi, i);
+	  if (step ? arg != step : !step_of (phi, arg, &inc))
+	    break;
+	  step = arg;
+	}
+      if (i < phi->nargs || !step || !cfg_in_loop (loop, step->block))
+	continue;
+
+      if (nivs == ivs_size)
+	{
+	  ivs_size = ivs_size ? ivs_size * 2 : 8;
+	  ivs = xrealloc (ivs, ivs_size * sizeof (*ivs));
+	}
+      ivs[nivs].phi = phi;
+      ivs[nivs].step = step;
+      ivs[nivs].inc = inc;
+      ivs[nivs].temps = NULL;
+      nivs++;
+    }
+}
+
+/* The temporary holding FACTOR times the induction variable IV */
+static SYMBOL *
+iv_temp (struct iv *iv, long factor)
+{
+  struct iv_temp *t;
+  NODE *decl, *asgn;
+  SYMBOL *s = iv->phi->symbol;
+  long inc = (long) ((unsigned long) factor * (unsigned long) iv->inc);
+
+  for (t = iv->temps; t; t = t->next)
+    if (t->factor == factor)
+      return t->temp;
+
+  t = malloc (sizeof (*t));
+  if (!t)
+    exit (EXIT_FAILURE);
+  t->factor = factor;
+  t->temp = make_temp (graph->function ? 1 : 0);
+  t->next = iv->temps;
+  iv->temps = t;
+
+  decl = make_decl (t->temp,
+		    make_expr (make_binop (OPCODE_MUL, make_const (factor),
+					   make_var (s))));
+  motion_insert_before (loop->header->branch, decl);
+
+  asgn = make_asgn (t->temp,
+		    make_expr (make_binop (OPCODE_ADD, make_const (inc),
+					   make_var (t->temp))));
+  motion_insert_after (iv->step->def, asgn);
+  return t->temp;
+}
+
+static void
+reduce_expr (NODE *node)
+{
+  struct ssa_value *v;
+  ARGLIST *arg;
+  NODE *var;
+  long factor;
+  size_t i;
+
+  node = strip (node);
+  if (const_var (node, OPCODE_MUL, &factor, &var)
+      && factor != 0 && factor != 1
+      && (v = ssa_use_value (ssa, var)))
+    for (i = 0; i < nivs; i++)
+      if (v == ivs[i].phi || v == ivs[i].step)
+	{
+	  SYMBOL *s = iv_temp (&ivs[i], factor);
+	  if (verbose > 1)
+	    printf ("Strength reduction: node %4.4lu reads %s\n",
+		    node->node_id, s->name);
+	  motion_replace (node, s);
+	  nreduced++;
+	  return;
+	}
+
+  switch (node->type) {
+  case NODE_UNOP:
+    reduce_expr (node->left);
+    break;
+  case NODE_BINOP:
+    reduce_expr (node->left);
+    reduce_expr (node->right);
+    break;
+  case NODE_CALL:
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      reduce_expr (arg->node);
+    break;
+  default:
+    break;
+  }
+}
+
+static void
+reduce_loop (void)
+{
+  struct ssa_block *sb;
+  struct ssa_site *site;
+  struct iv_temp *t;
+  ARGLIST *arg;
+  size_t i, j;
+
+  if (!loop->header->branch
+      || loop->header->branch->type != NODE_ITERATION)
+    return;
+  find_ivs ();
+  if (nivs == 0)
+    return;
+
+  for (i = 0; i < loop->nblocks; i++)
+    {
+      sb = &ssa->blocks[loop->blocks[i]->index];
+      for (j = 0; j < sb->nsites; j++)
+	{
+	  site = sb->sites[j];
+	  if (site->expr)
+	    reduce_expr (site->expr->v.expr);
+	  else if (site->stmt->type == NODE_CALL)
+	    for (arg = site->stmt->v.funcall.args; arg; arg = arg->next)
+	      reduce_expr (arg->node);
+	}
+    }
+
+  for (i = 0; i < nivs; i++)
+    while ((t = ivs[i].temps))
+      {
+	ivs[i].temps = t->next;
+	free (t);
+      }
+}
+
+
+/* Powers of two */
+
+static int nonneg (NODE *);
+static int nonneg_value (struct ssa_value *);
+
+/* Is V a small constant a counting loop may start from? */
+static int
+small_start (struct ssa_value *v)
+{
+  NODE *expr;
+
+  if (v->kind != SSA_DEF)
+    return 0;
+  expr = v->def->type == NODE_ASGN
+    ? v->def->v.asgn.expr : v->def->v.vardecl.expr;
+  if (!expr)
+    return 1;
+  expr = strip (expr);
+  return expr->type == NODE_CONST
+    && expr->v.number >= 0 && expr->v.number <= START_MAX;
+}
+
+/* A phi is not negative when its other operands are not, or when
+   it counts up by small steps from a small start, which takes more
+   trips than any program makes to wrap around. */
+static int
+nonneg_phi (struct ssa_value *phi)
+{
+  struct ssa_value *arg;
+  size_t i;
+  long inc;
+  int counting = 0, small = 1;
+
+  for (i = 0; i < phi->nargs; i++)
+    {
+      arg = ssa_phi_arg (phi, i);
+      if (arg == phi)
+	continue;
+      if (step_of (phi, arg, &inc))
+	{
+	  if (inc < 0 || inc > STEP_MAX)
+	    return 0;
+	  counting = 1;
+	  continue;
+	}
+      if (!small_start (arg))
+	small = 0;
+    }
+  if (counting)
+    return small;
+
+  for (i = 0; i < phi->nargs; i++)
+    {
+      arg = ssa_phi_arg (phi, i);
+      if (arg != phi && !nonneg_value (arg))
+	return 0;
+    }
+  return 1;
+}
+
+static int
+nonneg_value (struct ssa_value *v)
+{
+  void *memo = ptrmap_get (&nonneg_memo, v, 0);
+  NODE *expr;
+  int r;
+
+  if (memo)
+    return memo == &yes;
+  ptrmap_put (&nonneg_memo, v, 0, &visiting);
+
+  switch (v->kind) {
+  case SSA_DEF:
+    expr = v->def->type == NODE_ASGN
+      ? v->def->v.asgn.expr : v->def->v.vardecl.expr;
+    r = !expr || nonneg (expr);
+    break;
+  case SSA_PHI:
+    r = nonneg_phi (v);
+    break;
+  default:
+    r = 0;
+    break;
+  }
+  ptrmap_put (&nonneg_memo, v, 0, r ? &yes : &no);
+  return r;
+}
+
+/* Is the value of NODE known not to be negative? */
+static int
+nonneg (NODE *node)
+{
+  struct ssa_value *v;
+  NODE *r;
+
+  node = strip (node);
+  switch (node->type) {
+  case NODE_CONST:
+    return node->v.number >= 0;
+  case NODE_VAR:
+    v = ssa_use_value (ssa, node);
+    return v && nonneg_value (v);
+  case NODE_UNOP:
+    return node->v.opcode == OPCODE_NOT;
+  case NODE_BINOP:
+    r = strip (node->right);
+    switch (node->v.opcode) {
+    case OPCODE_AND:
+    case OPCODE_OR:
+    case OPCODE_EQ:
+    case OPCODE_NE:
+    case OPCODE_LT:
+    case OPCODE_GT:
+    case OPCODE_LE:
+    case OPCODE_GE:
+      return 1;
+    case OPCODE_BAND:
+      return nonneg (node->left) || nonneg (node->right);
+    case OPCODE_SHR:
+      return nonneg (node->left);
+    case OPCODE_DIV:
+      return r->type == NODE_CONST && r->v.number > 0
+	&& nonneg (node->left);
+    case OPCODE_MOD:
+      return nonneg (node->left);
+    default:
+      return 0;
+    }
+  default:
+    return 0;
+  }
+}
+
+/* The power of two NUMBER is, or -1 */
+static int
+log2_exact (long number)
+{
+  int k;
+
+  if (number <= 0 || (number & (number - 1)))
+    return -1;
+  for (k = 0; number > 1; k++)
+    number >>= 1;
+  return k;
+}
+
+static void
+shift_expr (NODE *node)
+{
+  NODE *l, *r;
+  ARGLIST *arg;
+  int k;
+
+  node = strip (node);
+  switch (node->type) {
+  case NODE_UNOP:
+    shift_expr (node->left);
+    return;
+  case NODE_CALL:
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      shift_expr (arg->node);
+    return;
+  case NODE_BINOP:
+    break;
+  default:
+    return;
+  }
+
+  shift_expr (node->left);
+  shift_expr (node->right);
+
+  l = strip (node->left);
+  r = strip (node->right);
+  switch (node->v.opcode) {
+  case OPCODE_MUL:
+    /* C * X = X << log2 C */
+    if (l->type == NODE_CONST && r->type != NODE_CONST
+	&& (k = log2_exact (l->v.number)) >= 1)
+      {
+	NODE *t = node->left;
+	node->left = node->right;
+	node->right = t;
+	l->v.number = k;
+      }
+    else if (r->type == NODE_CONST && (k = log2_exact (r->v.number)) >= 1)
+      r->v.number = k;
+    else
+      return;
+    node->v.opcode = OPCODE_SHL;
+    break;
+  case OPCODE_DIV:
+  case OPCODE_MOD:
+    if (r->type != NODE_CONST || (k = log2_exact (r->v.number)) < 1
+	|| !nonneg (node->left))
+      return;
+    if (node->v.opcode == OPCODE_DIV)
+      {
+	node->v.opcode = OPCODE_SHR;
+	r->v.number = k;
+      }
+    else
+      {
+	node->v.opcode = OPCODE_BAND;
+	r->v.number = r->v.number - 1;
+      }
+    break;
+  default:
+    return;
+  }
+  if (verbose > 1)
+    printf ("Strength reduction: node %4.4lu to a shift or mask\n",
+	    node->node_id);
+  nshifts++;
+}
+
+static void
+shift_graph (void)
+{
+  struct ssa_block *sb;
+  struct ssa_site *site;
+  ARGLIST *arg;
+  size_t i, j;
+
+  for (i = 0; i < graph->nrpo; i++)
+    {
+      sb = &ssa->blocks[graph->rpo[i]->index];
+      for (j = 0; j < sb->nsites; j++)
+	{
+	  site = sb->sites[j];
+	  if (site->expr)
+	    shift_expr (site->expr->v.expr);
+	  else if (site->stmt->type == NODE_CALL)
+	    for (arg = site->stmt->v.funcall.args; arg; arg = arg->next)
+	      shift_expr (arg->node);
+	}
+    }
+}
+
+/* Reduce the strength of the operations of the program rooted at
+   *ROOTP.  Returns the number of operations replaced. */
+size_t
+strength_run (NODE **rootp)
+{
+  struct cfg *graphs, *g;
+  size_t i;
+
+  nreduced = nshifts = 0;
+  ipa_analyze (*rootp);
+
+  /* The products of induction variables */
+  motion_begin (rootp);
+  graphs = cfg_build (*rootp);
+  for (g = graphs; g; g = g->next)
+    {
+      if (g->nloops == 0)
+	continue;
+      graph = g;
+      ssa = ssa_build (g);
+      for (i = 0; i < g->nloops; i++)
+	{
+	  loop = g->loops[i];
+	  reduce_loop ();
+	}
+      ssa_free (ssa);
+    }
+  cfg_free (graphs);
+  motion_end ();
+
+  /* The powers of two, over the statements added above too */
+  graphs = cfg_build (*rootp);
+  for (g = graphs; g; g = g->next)
+    {
+      graph = g;
+      ssa = ssa_build (g);
+      ptrmap_init (&nonneg_memo);
+      shift_graph ();
+      ptrmap_free (&nonneg_memo);
+      ssa_free (ssa);
+    }
+  cfg_free (graphs);
+  ipa_free ();
+  ssa = NULL;
+  graph = NULL;
+  loop = NULL;
+
+  free (ivs);
+  ivs = NULL;
+  nivs = ivs_size = 0;
+
+  if (verbose > 1)
+    printf ("Strength reduction: %lu products of induction variables, "
+	    "%lu shifts and masks\n",
+	    (unsigned long) nreduced, (unsigned long) nshifts);
+  return nreduced + nshifts;
+}
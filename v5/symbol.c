@@ -23,73 +23,280 @@
 
 #include "symbol.h"
 #include "tree.h"
+#include "mm.h"
 
 static void copy_to_history (SYMBOL *);
-static void free_symbol (SYMBOL *s);
 
 SYMBOL *symbol_functions;
 SYMBOL *symbol_variables;
 SYMBOL *symbol_history;
 
 int nesting_level;
+int frame_layout = FRAME_SIMPLE;
+int data_layout = DATA_DECL;
+const char *data_profile;
 extern size_t input_line_num;
+extern int verbose;
+extern int errcnt;
+
+/*
+  Symbol arena.
+
+  A symbol is a single record: the SYMBOL itself, followed by its
+  variable_t or function_t, followed by the name.  Records are carved
+  out of large chunks and released all at once by free_all_symbols.
+*/
+
+#define ARENA_CHUNK_SIZE 16384
+#define ARENA_ALIGN(n) (((n) + 15) & ~(size_t) 15)
+
+struct arena_chunk
+{
+  struct arena_chunk *next;
+  size_t size;        /* bytes available for records */
+  size_t used;        /* bytes handed out */
+};
+
+static struct arena_chunk *symbol_arena;
+
+static void *
+arena_alloc (size_t size)
+{
+  struct arena_chunk *c = symbol_arena;
+  void *p;
+
+  size = ARENA_ALIGN (size);
+  if (!c || c->used + size > c->size)
+    {
+      size_t n = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+      c = mm_alloc (MEM_SYMBOL, ARENA_ALIGN (sizeof (*c)) + n);
+      c->size = n;
+      c->used = 0;
+      c->next = symbol_arena;
+      symbol_arena = c;
+    }
+  p = (char *) c + ARENA_ALIGN (sizeof (*c)) + c->used;
+  c->used += size;
+  return p;
+}
+
+static void
+arena_release (void)
+{
+  struct arena_chunk *c, *next;
+
+  for (c = symbol_arena; c; c = next)
+    {
+      next = c->next;
+      mm_free (MEM_SYMBOL, c, ARENA_ALIGN (sizeof (*c)) + c->size);
+    }
+  symbol_arena = NULL;
+}
+
+/*
+  Symbol tables.
+
+  Every namespace has an open-addressing hash table keyed by name
+  (the key points to the name of the first symbol bound there).
+  A slot holds the innermost visible binding; bindings it hides are
+  chained through `shadow'.  Variables are also pushed onto the scope
+  stack, so that closing a block only visits the symbols declared in
+  it.
+*/
+
+struct symtab_entry
+{
+  char *name;
+  unsigned hash;
+  SYMBOL *symbol;     /* NULL if the name is not bound */
+};
+
+struct symtab
+{
+  size_t size;        /* number of slots, a power of 2 */
+  size_t count;       /* number of used slots */
+  struct symtab_entry *tab;
+};
+
+static struct symtab variable_table;
+static struct symtab function_table;
+
+static SYMBOL *scope_stack;
+
+#define SYMTAB_INITIAL_SIZE 64
+
+static unsigned
+hash_name (const char *name)
+{
+  unsigned h = 2166136261u;
+
+  for (; *name; name++)
+    h = (h ^ (unsigned char) *name) * 16777619u;
+  return h;
+}
+
+static struct symtab_entry *
+symtab_slot (struct symtab *t, const char *name, unsigned hash)
+{
+  size_t i = hash & (t->size - 1);
+
+  while (t->tab[i].name)
+    {
+      if (t->tab[i].hash == hash && strcmp (t->tab[i].name, name) == 0)
+	break;
+      i = (i + 1) & (t->size - 1);
+    }
+  return &t->tab[i];
+}
+
+static void
+symtab_grow (struct symtab *t)
+{
+  struct symtab_entry *old = t->tab;
+  size_t i, old_size = t->size;
+
+  t->size = old_size ? old_size * 2 : SYMTAB_INITIAL_SIZE;
+  t->tab = mm_alloc (MEM_SYMBOL, t->size * sizeof (struct symtab_entry));
+  memset (t->tab, 0, t->size * sizeof (struct symtab_entry));
+
+  for (i = 0; i < old_size; i++)
+    if (old[i].name)
+      *symtab_slot (t, old[i].name, old[i].hash) = old[i];
+  mm_free (MEM_SYMBOL, old, old_size * sizeof (struct symtab_entry));
+}
+
+static void
+symtab_free (struct symtab *t)
+{
+  mm_free (MEM_SYMBOL, t->tab, t->size * sizeof (struct symtab_entry));
+  t->tab = NULL;
+  t->size = t->count = 0;
+}
+
+static struct symtab *
+symtab_for (enum symbol_type type)
+{
+  return type == SYMBOL_FNC ? &function_table : &variable_table;
+}
+
+static void
+bind_symbol (SYMBOL *s)
+{
+  struct symtab *t = symtab_for (s->type);
+  struct symtab_entry *e;
+  unsigned hash = hash_name (s->name);
+
+  if ((t->count + 1) * 2 > t->size)
+    symtab_grow (t);
+
+  e = symtab_slot (t, s->name, hash);
+  if (!e->name)
+    {
+      e->name = s->name;
+      e->hash = hash;
+      t->count++;
+    }
+  s->shadow = e->symbol;
+  e->symbol = s;
+}
+
+static void
+unbind_symbol (SYMBOL *s)
+{
+  struct symtab *t = symtab_for (s->type);
+  struct symtab_entry *e = symtab_slot (t, s->name, hash_name (s->name));
+  SYMBOL *p;
+
+  if (e->symbol == s)
+    {
+      e->symbol = s->shadow;
+      return;
+    }
+  /* S is hidden by a newer binding (e.g. a global declared
+     in an inner block) */
+  for (p = e->symbol; p; p = p->shadow)
+    if (p->shadow == s)
+      {
+	p->shadow = s->shadow;
+	break;
+      }
+}
 
 SYMBOL *
 putsym (SYMBOL **s, const char *name, enum symbol_type type)
 {
   SYMBOL *new;
+  size_t payload, size;
 
-  new = (SYMBOL *)malloc (sizeof(SYMBOL));
-  if (!new)
-    exit (EXIT_FAILURE);
+  payload = type == SYMBOL_FNC ? sizeof(function_t) : sizeof(variable_t);
+  size = ARENA_ALIGN (sizeof(SYMBOL)) + ARENA_ALIGN (payload);
 
-  new->name = strdup (name);
+  new = (SYMBOL *)arena_alloc (size + strlen (name) + 1);
+  memset (new, 0, size);
+  new->name = (char *) new + size;
+  strcpy (new->name, name);
   new->type = type;
   new->sourceline = input_line_num;
-  new->ref_count = 0;
 
   if (type == SYMBOL_VAR)
     {
-      variable_t *var;
-      var = (variable_t *) malloc (sizeof(variable_t));
-      if (!var)
-	exit (EXIT_FAILURE);
-      memset (var, 0, sizeof(variable_t));
-      new->v.var = var;
+      new->v.var = (variable_t *) ((char *) new
+				   + ARENA_ALIGN (sizeof(SYMBOL)));
       new->v.var->level = nesting_level;
     }
   else if (type == SYMBOL_FNC)
-    {
-      function_t *fnc;
-      fnc = (function_t *) malloc (sizeof(function_t));
-      if (!fnc)
-	exit (EXIT_FAILURE);
-      memset (fnc, 0, sizeof(function_t));
-      new->v.fnc = fnc;
-    }
+    new->v.fnc = (function_t *) ((char *) new + ARENA_ALIGN (sizeof(SYMBOL)));
 
+  new->prev = NULL;
   if (*s)
-    new->next = *s;
+    {
+      new->next = *s;
+      (*s)->prev = new;
+    }
   else
     new->next = NULL;
   *s = new;
+
+  bind_symbol (new);
+  if (type == SYMBOL_VAR)
+    {
+      new->scope_next = scope_stack;
+      scope_stack = new;
+    }
+  else
+    new->scope_next = NULL;
   return new;
 }
 
 SYMBOL *
-getsym (SYMBOL *s, const char *name)
+getsym (enum symbol_type type, const char *name)
 {
-  SYMBOL *ptr;
+  struct symtab *t = symtab_for (type);
 
-  if (s == NULL)
+  if (t->size == 0)
     return NULL;
+  return symtab_slot (t, name, hash_name (name))->symbol;
+}
 
-  for (ptr = s; ptr; ptr = ptr->next)
-    {
-      if (strcmp (ptr->name, name) == 0)
-	return ptr;
-    }
-  return NULL;
+/* A compiler temporary: an automatic variable at nesting LEVEL whose
+   name cannot clash with an identifier.  The temporaries of functions
+   go straight to the past variables, since their scopes are closed;
+   those of the top level stay with the data, like its variables. */
+SYMBOL *
+make_temp (int level)
+{
+  static unsigned ntemps;
+  char name[32];
+  SYMBOL *s;
+
+  sprintf (name, "tmp.%u", ++ntemps);
+  s = putsym (level ? &symbol_history : &symbol_variables, name, SYMBOL_VAR);
+  unbind_symbol (s);
+  scope_stack = s->scope_next;
+  s->scope_next = NULL;
+  s->v.var->qualifier = QUA_AUTO;
+  s->v.var->level = level;
+  return s;
 }
 
 SYMLIST *
@@ -97,10 +304,7 @@ make_symlist (SYMBOL *s, SYMLIST *next)
 {
   SYMLIST *x;
 
-  x = (SYMLIST *)malloc (sizeof(SYMLIST));
-  if (x == NULL)
-    exit (EXIT_FAILURE);
-
+  x = (SYMLIST *)mm_alloc (MEM_SYMLIST, sizeof(SYMLIST));
   x->symbol = s;
   x->next   = next;
   return x;
@@ -118,64 +322,63 @@ copy_to_history (SYMBOL *s)
   symbol_history = s;
 }
 
-static void
-free_symbol (SYMBOL *s)
-{
-  if (!s)
-    return;
-
-  free (s->name);
-  if (s->type == SYMBOL_VAR && s->v.var)
-    free (s->v.var);
-  else if (s->type == SYMBOL_FNC && s->v.fnc)
-    free (s->v.fnc);
-  free (s);
-}
-
 void
 delsym_level (SYMBOL **s, int level)
 {
-  SYMBOL *p, *prev = NULL;
+  SYMBOL *p;
 
-  if (!*s)
-    return;
-
-  p = *s;
-  while (p)
+  while ((p = scope_stack))
     {
-      SYMBOL *next = p->next;
-      if (p->type == SYMBOL_VAR && (p->v.var->qualifier == QUA_AUTO ||
-				    p->v.var->qualifier == QUA_PARAMETER))
+      /* Globals stay visible; they only leave the scope stack */
+      if (p->v.var->qualifier == QUA_AUTO ||
+	  p->v.var->qualifier == QUA_PARAMETER)
 	{
 	  if (p->v.var->level < level)
 	    break;
-	  if (!prev)
-	    *s = next;
+
+	  if (p->prev)
+	    p->prev->next = p->next;
 	  else
-	    prev->next = next;
+	    *s = p->next;
+	  if (p->next)
+	    p->next->prev = p->prev;
+	  unbind_symbol (p);
+
+	  scope_stack = p->scope_next;
 
 	  /* NOTE: Do not free the symbol, since it may be referenced
 	     to by the code */
 
-	  copy_to_history (p); 
+	  copy_to_history (p);
 	}
       else
-	prev = p;
-      p = next;
+	scope_stack = p->scope_next;
     }
 }
 
 void
-free_all_symbols (SYMBOL **s)
+free_all_symbols (void)
 {
-  SYMBOL *ptr, *next;
+  SYMBOL *ptr;
 
-  for (ptr = *s; ptr; ptr = next)
+  for (ptr = symbol_functions; ptr; ptr = ptr->next)
     {
-      next = ptr->next;
-      free_symbol (ptr);
+      SYMLIST *p, *next;
+      for (p = ptr->v.fnc->param; p; p = next)
+	{
+	  next = p->next;
+	  mm_free (MEM_SYMLIST, p, sizeof(SYMLIST));
+	}
     }
-  *s = NULL;
+
+  symtab_free (&function_table);
+  symtab_free (&variable_table);
+  arena_release ();
+
+  symbol_functions = NULL;
+  symbol_variables = NULL;
+  symbol_history = NULL;
+  scope_stack = NULL;
 }
 
 void
@@ -229,44 +432,8 @@ print_all_symbols (SYMBOL *s)
   Computing the stack.
 */
 
-static varlist_t *varlist;
-
-int
-find_variable (variable_t *var)
-{
-  varlist_t *p;
-
-  for (p = varlist; p; p = p->next)
-    if (p->var == var)
-      return 1; /* found */
-  return 0; /* not found */
-}
-
-void
-add_variable (variable_t *var)
-{
-  varlist_t *new = (varlist_t *) malloc (sizeof (varlist_t));
-
-  if (varlist == NULL)
-    new->next = NULL;
-  else
-    new->next = varlist;
-
-  new->var = var;
-  varlist  = new;
-}
-
-void
-free_varlist (void)
-{
-  varlist_t *p, *next;
-  for (p = varlist; p; p = next)
-    {
-      next = p->next;
-      free (p);
-    }
-  varlist = NULL;
-}
+static unsigned frame_epoch;   /* stamp of the frame being laid out */
+static variable_t *frame_vars; /* automatic variables of that frame */
 
 static void
 register_var (NODE *node)
@@ -274,8 +441,12 @@ register_var (NODE *node)
   if (node->v.symbol->type == SYMBOL_VAR)
     {
       variable_t *var = node->v.symbol->v.var;
-      if (var->qualifier == QUA_AUTO && !find_variable (var))
-	add_variable (var);
+      if (var->qualifier == QUA_AUTO && var->epoch != frame_epoch)
+	{
+	  var->epoch = frame_epoch;
+	  var->frame_next = frame_vars;
+	  frame_vars = var;
+	}
     }
 }
 
@@ -302,27 +473,492 @@ static void
 count_offsets (function_t *fnc)
 {
   off_t tos_offset = 0;
-  varlist_t *p;
+  variable_t *p;
 
-  for (p = varlist; p; p = p->next)
-    p->var->rel_address = 1 + tos_offset++;
+  for (p = frame_vars; p; p = p->frame_next)
+    p->rel_address = 1 + tos_offset++;
   fnc->nauto = tos_offset;
 }
 
+/*
+  Reference walk.
+
+  Visits statements in execution order and reports every reference
+  to a variable (the reads of a statement before its write) as well
+  as the beginning and the end of every loop.
+*/
+
+struct ref_walker
+{
+  void (*touch) (SYMBOL *);
+  void (*loop_begin) (void);
+  void (*loop_end) (void);
+  int nested_functions;   /* descend into nested function bodies */
+};
+
+static struct ref_walker *walker;
+
+static void
+ref_expr (NODE *node)
+{
+  ARGLIST *arg;
+
+  if (!node)
+    return;
+
+  switch (node->type) {
+  case NODE_VAR:
+    walker->touch (node->v.symbol);
+    break;
+  case NODE_CALL:
+    for (arg = node->v.funcall.args; arg; arg = arg->next)
+      ref_expr (arg->node);
+    break;
+  case NODE_EXPR:
+    ref_expr (node->v.expr);
+    break;
+  default:
+    ref_expr (node->left);
+    ref_expr (node->right);
+  }
+}
+
+static void ref_stmt_list (NODE *);
+
+static void
+ref_stmt (NODE *node)
+{
+  switch (node->type) {
+  case NODE_CALL:
+  case NODE_EXPR:
+    ref_expr (node);
+    break;
+  case NODE_ASGN:
+    ref_expr (node->v.asgn.expr);
+    walker->touch (node->v.asgn.symbol);
+    break;
+  case NODE_RETURN:
+  case NODE_PRINT:
+    ref_expr (node->v.expr);
+    break;
+  case NODE_COMPOUND:
+    ref_stmt_list (node->v.expr);
+    break;
+  case NODE_ITERATION:
+    walker->loop_begin ();
+    ref_expr (node->v.iteration.cond);
+    ref_stmt_list (node->v.iteration.stmt);
+    walker->loop_end ();
+    break;
+  case NODE_CONDITION:
+    ref_expr (node->v.condition.cond);
+    ref_stmt_list (node->v.condition.iftrue_stmt);
+    ref_stmt_list (node->v.condition.iffalse_stmt);
+    break;
+  case NODE_VAR_DECL:
+    ref_expr (node->v.vardecl.expr);
+    walker->touch (node->v.vardecl.symbol);
+    break;
+  case NODE_FNC_DECL:
+    if (walker->nested_functions)
+      ref_stmt_list (node->v.fncdecl.stmt);
+    break;
+  case NODE_JUMP:
+  case NODE_NOOP:
+    break;
+  default:
+    abort ();
+  }
+}
+
+static void
+ref_stmt_list (NODE *node)
+{
+  for (; node; node = node->right)
+    ref_stmt (node);
+}
+
+static void
+ref_walk (struct ref_walker *w, NODE *node)
+{
+  walker = w;
+  ref_stmt_list (node);
+  walker = NULL;
+}
+
+/*
+  Stack slot sharing (frame_layout == FRAME_SHARE_SLOTS).
+
+  Every reference to an automatic variable gets a position in
+  execution order.  The live range of a variable spans from its
+  first to its last reference, and is widened to cover any loop
+  it intersects, since the back edge may carry its value around.
+  Loops nest, so it is enough to widen it to the outermost loops
+  around its first and its last reference.  Two variables interfere
+  when their ranges overlap.  This is an interval graph, so coloring
+  it greedily in the order of range starts gives the minimal number
+  of slots.
+*/
+
+#define NO_LOOP ((size_t) -1)
+
+struct live_range
+{
+  variable_t *var;
+  unsigned start;
+  unsigned end;
+  size_t first_loop;  /* outermost loop around the first reference */
+  size_t last_loop;   /* outermost loop around the last reference */
+};
+
+struct loop_span
+{
+  unsigned start;
+  unsigned end;
+  size_t parent;      /* enclosing loop */
+};
+
+static struct live_range *ranges;
+static size_t nranges, ranges_size;
+static struct loop_span *loops;
+static size_t nloops, loops_size;
+static size_t inner_loop;   /* innermost loop being walked */
+static size_t outer_loop;   /* outermost loop being walked */
+static unsigned position;
+
+static void
+live_touch (SYMBOL *s)
+{
+  variable_t *var;
+  size_t loop = inner_loop != NO_LOOP ? outer_loop : NO_LOOP;
+
+  if (!s || s->type != SYMBOL_VAR || s->v.var->qualifier != QUA_AUTO)
+    return;
+  var = s->v.var;
+
+  if (var->epoch == frame_epoch)
+    {
+      ranges[var->range].end = position++;
+      ranges[var->range].last_loop = loop;
+      return;
+    }
+  var->epoch = frame_epoch;
+  var->range = nranges;
+
+  if (nranges == ranges_size)
+    {
+      ranges_size = ranges_size ? ranges_size * 2 : 16;
+      ranges = realloc (ranges, ranges_size * sizeof (*ranges));
+      if (!ranges)
+	exit (EXIT_FAILURE);
+    }
+  ranges[nranges].var = var;
+  ranges[nranges].start = ranges[nranges].end = position++;
+  ranges[nranges].first_loop = ranges[nranges].last_loop = loop;
+  nranges++;
+}
+
+static void
+live_loop_begin (void)
+{
+  if (nloops == loops_size)
+    {
+      loops_size = loops_size ? loops_size * 2 : 8;
+      loops = realloc (loops, loops_size * sizeof (*loops));
+      if (!loops)
+	exit (EXIT_FAILURE);
+    }
+  if (inner_loop == NO_LOOP)
+    outer_loop = nloops;
+  loops[nloops].parent = inner_loop;
+  loops[nloops].start = position++;
+  inner_loop = nloops++;
+}
+
+static void
+live_loop_end (void)
+{
+  loops[inner_loop].end = position++;
+  inner_loop = loops[inner_loop].parent;
+}
+
+static struct ref_walker live_walker = {
+  live_touch,
+  live_loop_begin,
+  live_loop_end,
+  0
+};
+
+static int
+range_cmp (const void *a, const void *b)
+{
+  const struct live_range *x = a, *y = b;
+
+  if (x->start != y->start)
+    return x->start < y->start ? -1 : 1;
+  return 0;
+}
+
+/* Min-heap of slots ordered by the end of their last range */
+
+struct slot
+{
+  unsigned end;
+  off_t offset;
+};
+
+static void
+slot_sift_down (struct slot *heap, size_t n, size_t i)
+{
+  for (;;)
+    {
+      size_t min = i, l = 2 * i + 1, r = l + 1;
+      struct slot tmp;
+
+      if (l < n && heap[l].end < heap[min].end)
+	min = l;
+      if (r < n && heap[r].end < heap[min].end)
+	min = r;
+      if (min == i)
+	break;
+      tmp = heap[i];
+      heap[i] = heap[min];
+      heap[min] = tmp;
+      i = min;
+    }
+}
+
+static void
+slot_push (struct slot *heap, size_t n, struct slot s)
+{
+  size_t i = n;
+
+  while (i > 0 && s.end < heap[(i - 1) / 2].end)
+    {
+      heap[i] = heap[(i - 1) / 2];
+      i = (i - 1) / 2;
+    }
+  heap[i] = s;
+}
+
+static void
+share_offsets (function_t *fnc)
+{
+  struct slot *heap;
+  size_t i, nslots = 0;
+
+  fnc->nauto = 0;
+  nranges = nloops = 0;
+  inner_loop = NO_LOOP;
+  position = 0;
+  ref_walk (&live_walker, fnc->entry_point);
+
+  for (i = 0; i < nranges; i++)
+    {
+      struct live_range *r = &ranges[i];
+      if (r->first_loop != NO_LOOP && loops[r->first_loop].start < r->start)
+	r->start = loops[r->first_loop].start;
+      if (r->last_loop != NO_LOOP && loops[r->last_loop].end > r->end)
+	r->end = loops[r->last_loop].end;
+    }
+
+  qsort (ranges, nranges, sizeof (*ranges), range_cmp);
+
+  heap = malloc ((nranges ? nranges : 1) * sizeof (*heap));
+  if (!heap)
+    exit (EXIT_FAILURE);
+
+  for (i = 0; i < nranges; i++)
+    {
+      struct slot s;
+
+      if (nslots && heap[0].end < ranges[i].start)
+	{
+	  /* reuse the slot that became free first */
+	  s = heap[0];
+	  heap[0] = heap[nslots - 1];
+	  slot_sift_down (heap, nslots - 1, 0);
+	  nslots--;
+	}
+      else
+	s.offset = fnc->nauto + 1;
+
+      if (s.offset > fnc->nauto)
+	fnc->nauto = s.offset;
+      s.end = ranges[i].end;
+      ranges[i].var->rel_address = s.offset;
+      slot_push (heap, nslots++, s);
+    }
+  free (heap);
+}
+
 static void
 compute_auto_offsets (function_t *fnc)
 {
-  varlist = NULL;
+  frame_epoch++;
+
+  if (frame_layout == FRAME_SHARE_SLOTS)
+    {
+      share_offsets (fnc);
+      return;
+    }
+
+  frame_vars = NULL;
   traverse (fnc->entry_point, locate_vars_fptab);
   count_offsets (fnc);
-  free_varlist ();
+}
+
+/*
+  Global data layout.
+
+  Globals are placed in the data area in the order of decreasing
+  access weight, so that the hottest ones share the first cache
+  lines.  Ties keep the declaration order.
+*/
+
+#define MAX_LOOP_WEIGHT_DEPTH 16  /* 8^16 still fits in 64 bits */
+
+static unsigned loop_weight_depth;
+
+static void
+weight_touch (SYMBOL *s)
+{
+  unsigned depth = loop_weight_depth;
+
+  if (!s || s->type != SYMBOL_VAR || s->v.var->qualifier != QUA_GLOBAL)
+    return;
+  if (depth > MAX_LOOP_WEIGHT_DEPTH)
+    depth = MAX_LOOP_WEIGHT_DEPTH;
+  s->v.var->access_weight += 1UL << (3 * depth);
+}
+
+static void
+weight_loop_begin (void)
+{
+  loop_weight_depth++;
+}
+
+static void
+weight_loop_end (void)
+{
+  loop_weight_depth--;
+}
+
+static struct ref_walker weight_walker = {
+  weight_touch,
+  weight_loop_begin,
+  weight_loop_end,
+  1
+};
+
+/* Read "name count" lines from the profile file. */
+static void
+read_data_profile (const char *file)
+{
+  FILE *fp = fopen (file, "r");
+  char name[256];
+  unsigned long count;
+  size_t line = 0;
+  int c;
+
+  if (!fp)
+    {
+      perror (file);
+      errcnt++;
+      return;
+    }
+
+  for (;;)
+    {
+      SYMBOL *s;
+      int n = fscanf (fp, "%255s %lu", name, &count);
+
+      if (n == EOF)
+	break;
+      line++;
+      if (n != 2)
+	{
+	  fprintf (stderr, "%s:%lu: malformed profile entry\n",
+		   file, (unsigned long) line);
+	  errcnt++;
+	  break;
+	}
+      while ((c = getc (fp)) != EOF && c != '\n')
+	;
+
+      s = getsym (SYMBOL_VAR, name);
+      if (s && s->v.var->qualifier == QUA_GLOBAL)
+	s->v.var->access_weight += count;
+      else if (verbose > 1)
+	printf ("Data layout: no global `%s' for profile entry\n", name);
+    }
+  fclose (fp);
+}
+
+static int
+weight_cmp (const void *a, const void *b)
+{
+  const SYMBOL *x = *(const SYMBOL * const *) a;
+  const SYMBOL *y = *(const SYMBOL * const *) b;
+
+  if (x->v.var->access_weight != y->v.var->access_weight)
+    return x->v.var->access_weight > y->v.var->access_weight ? -1 : 1;
+  /* declaration order, kept in rel_address by the caller */
+  return x->v.var->rel_address < y->v.var->rel_address ? -1 : 1;
+}
+
+static void
+compute_data_offsets (void)
+{
+  SYMBOL *s;
+  SYMBOL **globals;
+  size_t i, n = 0;
+
+  for (s = symbol_variables; s && s->type == SYMBOL_VAR; s = s->next)
+    {
+      s->v.var->access_weight = 0;
+      s->v.var->rel_address = ++n;
+    }
+  if (data_layout == DATA_DECL || n == 0)
+    return;
+
+  switch (data_layout) {
+  case DATA_REFS:
+    for (s = symbol_variables; s && s->type == SYMBOL_VAR; s = s->next)
+      s->v.var->access_weight = s->nuses + s->ndefs;
+    break;
+  case DATA_LOOPS:
+    loop_weight_depth = 0;
+    ref_walk (&weight_walker, root);
+    break;
+  case DATA_PROFILE:
+    read_data_profile (data_profile);
+    break;
+  }
+
+  globals = malloc (n * sizeof (*globals));
+  if (!globals)
+    exit (EXIT_FAILURE);
+  i = 0;
+  for (s = symbol_variables; s && s->type == SYMBOL_VAR; s = s->next)
+    globals[i++] = s;
+  qsort (globals, n, sizeof (*globals), weight_cmp);
+
+  for (i = 0; i < n; i++)
+    {
+      globals[i]->v.var->rel_address = i + 1;
+      if (verbose > 1)
+	printf ("Data layout: %s at DATA+%lu, weight %lu\n",
+		globals[i]->name, (unsigned long) i + 1,
+		globals[i]->v.var->access_weight);
+    }
+  free (globals);
 }
 
 void
 compute_stack_and_data (void)
 {
   SYMBOL *s = symbol_functions;
-  off_t rel = 1;
 
   /* function parameters */
 
@@ -337,12 +973,14 @@ compute_stack_and_data (void)
       compute_auto_offsets (s->v.fnc);
     }
 
+  free (ranges);
+  free (loops);
+  ranges = NULL;
+  loops = NULL;
+  ranges_size = loops_size = 0;
+
   /* global variables */
 
-  s = symbol_variables;
-  for (; s && s->type == SYMBOL_VAR; s = s->next)
-    {
-      s->v.var->rel_address = rel++;
-    }
+  compute_data_offsets ();
 }
 
@@ -40,12 +40,11 @@ struct variable_struct
   enum qualifier_type qualifier;    /* qualifier */
   struct node_struct *entry_point;  /* Entry point to the variable */
   off_t rel_address;                /* relative address against TOS */
-};
 
-struct varlist_struct
-{
-  struct varlist_struct *next;
-  struct variable_struct *var;
+  unsigned epoch;                   /* frame layout stamp */
+  struct variable_struct *frame_next; /* next variable in the frame */
+  size_t range;                     /* index of the live range */
+  unsigned long access_weight;     /* data layout weight */
 };
 
 struct function_struct
@@ -54,16 +53,30 @@ struct function_struct
   int nauto;                        /* Number of automatic variables */
   struct symlist_struct *param;     /* Parameter list */
   struct node_struct *entry_point;  /* Entry point to the function */
+
+  struct symbol_struct **mod;       /* Variables it may write, see ipa.c */
+  size_t nmod;
+  struct symbol_struct **ref;       /* and variables it may read */
+  size_t nref;
+  int pure;                         /* No side effects, result depends
+                                       on the arguments only */
+  int total;                        /* Pure, and always returns */
 };
 
 struct symbol_struct
 {
   struct symbol_struct *next;
+  struct symbol_struct *prev;       /* previous symbol in the list */
+  struct symbol_struct *shadow;     /* binding hidden by this one */
+  struct symbol_struct *scope_next; /* next symbol on the scope stack */
   char *name;                       /* name of symbol */
   enum symbol_type type;            /* type of symbol */
   size_t sourceline;                /* source code line number */
-  size_t ref_count;                 /* Number of times this symbol
-                                       is referenced in the code */
+
+  struct node_struct *uses;         /* Def-use chains: nodes reading */
+  struct node_struct *defs;         /* and nodes writing the symbol */
+  size_t nuses;                     /* Number of uses */
+  size_t ndefs;                     /* Number of definitions */
 
   union {
     struct variable_struct *var;    /* pointer to VAR struct */
@@ -79,7 +92,6 @@ struct symlist_struct
 
 typedef struct function_struct function_t;
 typedef struct variable_struct variable_t;
-typedef struct varlist_struct varlist_t;
 typedef struct symbol_struct SYMBOL;
 typedef struct symlist_struct SYMLIST;
 
@@ -87,13 +99,33 @@ extern SYMBOL *symbol_functions;
 extern SYMBOL *symbol_variables;
 extern SYMBOL *symbol_history;
 
+/* Frame layout modes */
+enum frame_layout_type
+{
+  FRAME_SIMPLE,       /* one slot per automatic variable */
+  FRAME_SHARE_SLOTS   /* variables with disjoint live ranges share slots */
+};
+
+/* Global data layout modes */
+enum data_layout_type
+{
+  DATA_DECL,     /* declaration order */
+  DATA_REFS,     /* by static reference count */
+  DATA_LOOPS,    /* by reference count weighted by loop nesting */
+  DATA_PROFILE   /* by access counts read from a profile */
+};
+
 extern int nesting_level; /* nesting level */
+extern int frame_layout;  /* frame layout mode */
+extern int data_layout;   /* global data layout mode */
+extern const char *data_profile; /* profile for DATA_PROFILE */
 
 SYMBOL *putsym (SYMBOL **, const char *, enum symbol_type);
-SYMBOL *getsym (SYMBOL *, const char *);
+SYMBOL *getsym (enum symbol_type, const char *);
+SYMBOL *make_temp (int);
 SYMLIST *make_symlist (SYMBOL *, SYMLIST *);
 void delsym_level (SYMBOL **, int);
-void free_all_symbols (SYMBOL **);
+void free_all_symbols (void);
 void print_all_symbols (SYMBOL *);
 
 void compute_stack_and_data (void);
@@ -0,0 +1,395 @@
+/*
+   V5: tailrec.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "tailrec.h"
+
+extern int verbose;
+
+/*
+  Tail recursion elimination.
+
+  A function returning the value of a call to itself, `return f (...)',
+  needs nothing of its frame after the call, so the call can reuse
+  it: the arguments are stored to the parameters and the body starts
+  over.  The body is put into a `while (1)' loop, and each such
+  `return' becomes the assignments followed by a `continue' of that
+  loop.  A body that may run off its end gets a `break' at the end
+  of the loop.
+
+  A parameter is assigned only after all the arguments reading it
+  are computed; when that order cannot be found, or the arguments
+  call functions and must keep their order, they are computed into
+  temporaries first.  The jumps of the
+  body must stay in its own loops, or they would reach the new one.
+
+  The calls in tail position that remain, to other functions or not
+  eliminated, are marked at the end of the optimization for the code
+  generator, which may reuse the frame there too.
+*/
+
+static SYMBOL *fnc;              /* function being rewritten */
+static int bad;                  /* the body cannot be a loop */
+static size_t nsites, nfunctions, nmarked;
+
+/* The call to F returned by the statement NODE, if any */
+static NODE *
+tail_call (NODE *node, SYMBOL *f)
+{
+  NODE *call;
+
+  if (node->type != NODE_RETURN || !node->v.expr)
+    return NULL;
+  call = strip (node->v.expr);
+  if (call->type != NODE_CALL || (f && call->v.funcall.symbol != f))
+    return NULL;
+  return call;
+}
+
+/* Count the self tail calls from NODE on, DEPTH loops deep */
+static size_t
+count_sites (NODE *node, unsigned depth)
+{
+  NODE *call;
+  ARGLIST *arg;
+  size_t n = 0;
+  int nargs;
+
+  for (; node; node = node->right)
+    switch (node->type) {
+    case NODE_RETURN:
+      if ((call = tail_call (node, fnc)))
+	{
+	  for (arg = call->v.funcall.args, nargs = 0; arg; arg = arg->next)
+	    nargs++;
+	  if (nargs != fnc->v.fnc->nparam)
+	    bad = 1;
+	  n++;
+	}
+      break;
+    case NODE_JUMP:
+      /* It would reach the new loop */
+      if ((node->v.jump.level ? node->v.jump.level : 1) > depth)
+	bad = 1;
+      break;
+    case NODE_COMPOUND:
+      n += count_sites (node->v.expr, depth);
+      break;
+    case NODE_ITERATION:
+      n += count_sites (node->v.iteration.stmt, depth + 1);
+      break;
+    case NODE_CONDITION:
+      n += count_sites (node->v.condition.iftrue_stmt, depth);
+      n += count_sites (node->v.condition.iffalse_stmt, depth);
+      break;
+    default:
+      break;
+    }
+  return n;
+}
+
+static NODE *
+wrap_expr (NODE *node)
+{
+  return node->type == NODE_EXPR ? node : make_expr (node);
+}
+
+/* Does the expression NODE read S, or call a function? */
+static int
+reads (NODE *node, SYMBOL *s)
+{
+  node = strip (node);
+  switch (node->type) {
+  case NODE_VAR:
+    return node->v.symbol == s;
+  case NODE_UNOP:
+    return reads (node->left, s);
+  case NODE_BINOP:
+    return reads (node->left, s) || reads (node->right, s);
+  case NODE_CALL:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/* Could the parameter P be assigned before the arguments left in
+   ARGS are computed? */
+static int
+free_param (SYMLIST *p, ARGLIST *args)
+{
+  for (; args; args = args->next)
+    if (args->node && reads (args->node, p->symbol))
+      return 0;
+  return 1;
+}
+
+/* Replace the tail call CALL of the statement at *LINK, DEPTH loops
+   deep in the body, with the assignments of the arguments to the
+   parameters and a jump to the start of the body */
+static void
+rewrite_site (NODE **link, NODE *call, unsigned depth)
+{
+  NODE *stmt = *link, *first = NULL, *decls = NULL, *asgns = NULL;
+  NODE *node, *expr, **tail = &first;
+  ARGLIST *arg, *args = call->v.funcall.args;
+  SYMLIST *p;
+  int calls = 0, progress = 1;
+
+  if (verbose > 1)
+    printf ("Eliminating tail call at node %4.4lu\n", stmt->node_id);
+
+  /* A parameter passed to itself keeps its value.  The arguments
+     done with are cleared. */
+  for (p = fnc->v.fnc->param, arg = args; p; p = p->next, arg = arg->next)
+    {
+      expr = strip (arg->node);
+      if (expr->type == NODE_VAR && expr->v.symbol == p->symbol)
+	arg->node = NULL;
+      else if (reads (arg->node, NULL))
+	calls = 1;
+    }
+
+  /* Without calls the order of the arguments does not matter, so a
+     parameter no other argument reads is assigned directly */
+  while (!calls && progress)
+    {
+      progress = 0;
+      for (p = fnc->v.fnc->param, arg = args; p; p = p->next, arg = arg->next)
+	if (arg->node)
+	  {
+	    expr = arg->node;
+	    arg->node = NULL;
+	    if (!free_param (p, args))
+	      {
+		arg->node = expr;
+		continue;
+	      }
+	    *tail = make_asgn (p->symbol, wrap_expr (expr));
+	    tail = &(*tail)->right;
+	    progress = 1;
+	  }
+    }
+
+  /* The rest go through temporaries.  Both lists are kept backwards,
+     so prepending puts the arguments in the order they are computed. */
+  for (p = fnc->v.fnc->param, arg = args; p; p = p->next, arg = arg->next)
+    if (arg->node)
+      {
+	SYMBOL *t = make_temp (1);
+	node = make_decl (t, wrap_expr (arg->node));
+	node->right = decls;
+	decls = node;
+	node = make_asgn (p->symbol, make_expr (make_var (t)));
+	node->right = asgns;
+	asgns = node;
+      }
+
+  *tail = decls;
+  for (; *tail; tail = &(*tail)->right)
+    ;
+  *tail = asgns;
+  for (; *tail; tail = &(*tail)->right)
+    ;
+  node = addnode (NODE_JUMP);
+  node->v.jump.type = JUMP_CONTINUE;
+  node->v.jump.level = depth ? depth + 1 : 0;
+  node->right = stmt->right;
+  *tail = node;
+  *link = first;
+
+  /* The arguments moved, the call and the return go */
+  call->v.funcall.args = NULL;
+  while (args)
+    {
+      arg = args->next;
+      mm_free (MEM_ARGLIST, args, sizeof (ARGLIST));
+      args = arg;
+    }
+  du_unlink (call);
+  nsites++;
+}
+
+static void
+rewrite_list (NODE **link, unsigned depth)
+{
+  NODE *node, *call;
+
+  while ((node = *link))
+    {
+      switch (node->type) {
+      case NODE_RETURN:
+	if ((call = tail_call (node, fnc)))
+	  {
+	    rewrite_site (link, call, depth);
+	    /* Skip the new statements */
+	    while ((*link)->type != NODE_JUMP)
+	      link = &(*link)->right;
+	  }
+	break;
+      case NODE_COMPOUND:
+	rewrite_list (&node->v.expr, depth);
+	break;
+      case NODE_ITERATION:
+	rewrite_list (&node->v.iteration.stmt, depth + 1);
+	break;
+      case NODE_CONDITION:
+	rewrite_list (&node->v.condition.iftrue_stmt, depth);
+	rewrite_list (&node->v.condition.iffalse_stmt, depth);
+	break;
+      default:
+	break;
+      }
+      link = &(*link)->right;
+    }
+}
+
+static void
+eliminate (NODE *decl)
+{
+  NODE *body, *last, *loop, *cond;
+  int nparam = 0;
+  SYMLIST *p;
+
+  fnc = decl->v.fncdecl.symbol;
+  if (!fnc)
+    return;
+  for (p = fnc->v.fnc->param; p; p = p->next)
+    nparam++;
+  if (nparam != fnc->v.fnc->nparam)
+    return;
+
+  bad = 0;
+  if (count_sites (decl->v.fncdecl.stmt, 0) == 0 || bad)
+    return;
+
+  if (verbose > 1)
+    printf ("Turning function %s into a loop\n", fnc->name);
+
+  body = decl->v.fncdecl.stmt;
+  for (last = body; last->right; last = last->right)
+    ;
+  if (last->type != NODE_RETURN)
+    {
+      NODE *jump = addnode (NODE_JUMP);
+      jump->v.jump.type = JUMP_BREAK;
+      last->right = jump;
+    }
+
+  cond = make_expr (make_const (1));
+  loop = addnode (NODE_ITERATION);
+  loop->v.iteration.cond = cond;
+  loop->v.iteration.stmt = addnode (NODE_COMPOUND);
+  loop->v.iteration.stmt->v.expr = body;
+  decl->v.fncdecl.stmt = loop;
+  fnc->v.fnc->entry_point = loop;
+
+  rewrite_list (&loop->v.iteration.stmt->v.expr, 0);
+  nfunctions++;
+}
+
+static void
+eliminate_list (NODE *node)
+{
+  for (; node; node = node->right)
+    switch (node->type) {
+    case NODE_FNC_DECL:
+      eliminate_list (node->v.fncdecl.stmt);
+      eliminate (node);
+      break;
+    case NODE_COMPOUND:
+      eliminate_list (node->v.expr);
+      break;
+    case NODE_ITERATION:
+      eliminate_list (node->v.iteration.stmt);
+      break;
+    case NODE_CONDITION:
+      eliminate_list (node->v.condition.iftrue_stmt);
+      eliminate_list (node->v.condition.iffalse_stmt);
+      break;
+    default:
+      break;
+    }
+}
+
+/* Turn the tail calls of the functions of the program rooted at
+   *ROOTP to themselves into loops.  Returns the number of calls
+   eliminated. */
+size_t
+tailrec_run (NODE **rootp)
+{
+  nsites = nfunctions = 0;
+  eliminate_list (*rootp);
+
+  if (verbose > 1)
+    printf ("Tail recursion: %lu calls in %lu functions eliminated\n",
+	    (unsigned long) nsites, (unsigned long) nfunctions);
+  return nsites;
+}
+
+static void
+mark_list (NODE *node, int in_function)
+{
+  NODE *call;
+
+  for (; node; node = node->right)
+    switch (node->type) {
+    case NODE_RETURN:
+      if (in_function && (call = tail_call (node, NULL)))
+	{
+	  if (verbose > 1 && !call->v.funcall.tail)
+	    printf ("Tail call at node %4.4lu\n", call->node_id);
+	  call->v.funcall.tail = 1;
+	  nmarked++;
+	}
+      break;
+    case NODE_FNC_DECL:
+      mark_list (node->v.fncdecl.stmt, 1);
+      break;
+    case NODE_COMPOUND:
+      mark_list (node->v.expr, in_function);
+      break;
+    case NODE_ITERATION:
+      mark_list (node->v.iteration.stmt, in_function);
+      break;
+    case NODE_CONDITION:
+      mark_list (node->v.condition.iftrue_stmt, in_function);
+      mark_list (node->v.condition.iffalse_stmt, in_function);
+      break;
+    default:
+      break;
+    }
+}
+
+/* Mark the calls in tail position of the program rooted at ROOT.
+   Returns the number of calls marked. */
+size_t
+tailrec_mark (NODE *root)
+{
+  nmarked = 0;
+  mark_list (root, 0);
+
+  if (verbose > 1)
+    printf ("Tail calls: %lu marked\n", (unsigned long) nmarked);
+  return nmarked;
+}
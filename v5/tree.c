@@ -29,32 +29,37 @@ int print_offsets; /* Print data offsets of the variables */
 
 static unsigned int last_node_id;
 unsigned int nodes_counter;
+unsigned long traverse_visits;
+
+static void free_arglist (ARGLIST *);
 
 NODE *
 addnode (enum node_type type)
 {
   NODE *new;
+  int recycled = 0;
 
   if (free_memory_pool)
     {
       new = free_memory_pool;
-      free_memory_pool = free_memory_pool->memory_link;
+      mpool_remove (&free_memory_pool, new);
+      recycled = 1;
+      /* A call keeps its arguments until it is released */
+      if (new->type == NODE_CALL)
+	free_arglist (new->v.funcall.args);
     }
   else
-    {
-      new = (NODE *)malloc (sizeof(NODE));
-      if (!new)
-	exit (EXIT_FAILURE);
-    }
+    new = (NODE *)mm_alloc (MEM_NODE, sizeof(NODE));
   memset (new, 0, sizeof(NODE));
 
-  new->node_id = nodes_counter = ++last_node_id;
+  new->node_id = ++last_node_id;
+  nodes_counter++;
   new->type    = type;
   new->left    = NULL;
   new->right   = NULL;
+  mm_count_alloc (new, recycled);
 
-  new->memory_link = memory_pool;
-  memory_pool = new;
+  mpool_append (&memory_pool, new);
   return new;
 }
 
@@ -64,12 +69,34 @@ freenode (NODE *node)
   /* Should remove the node from memory_pool and append
      (or prepend) it to free_memory_pool */
 
+  du_unlink (node);
   mpool_remove (&memory_pool, node);
   mpool_append (&free_memory_pool, node);
+  mm_count_free (node);
 
   nodes_counter--;
 }
 
+static void
+free_arglist (ARGLIST *args)
+{
+  ARGLIST *next;
+
+  for (; args; args = next)
+    {
+      next = args->next;
+      mm_free (MEM_ARGLIST, args, sizeof(ARGLIST));
+    }
+}
+
+static void
+release_node (NODE *node)
+{
+  if (node->type == NODE_CALL)
+    free_arglist (node->v.funcall.args);
+  mm_free (MEM_NODE, node, sizeof(NODE));
+}
+
 void
 free_all_nodes (void)
 {
@@ -78,7 +105,7 @@ free_all_nodes (void)
   for (p = memory_pool; p; p = next)
     {
       next = p->memory_link;
-      free (p);
+      release_node (p);
       nodes_counter--;
     }
   memory_pool = NULL;
@@ -86,7 +113,7 @@ free_all_nodes (void)
   for (p = free_memory_pool; p; p = next)
     {
       next = p->memory_link;
-      free (p);
+      release_node (p);
     }
   free_memory_pool = NULL;
 
@@ -100,15 +127,144 @@ make_arglist (NODE *node, ARGLIST *next)
 {
   ARGLIST *x;
 
-  x = (ARGLIST *)malloc (sizeof(ARGLIST));
-  if (!x)
-    exit (EXIT_FAILURE);
-
+  x = (ARGLIST *)mm_alloc (MEM_ARGLIST, sizeof(ARGLIST));
   x->node = node;
   x->next = next;
   return x;
 }
 
+NODE *
+make_const (long number)
+{
+  NODE *node = addnode (NODE_CONST);
+
+  node->v.number = number;
+  return node;
+}
+
+NODE *
+make_var (SYMBOL *s)
+{
+  NODE *node = addnode (NODE_VAR);
+
+  node->v.symbol = s;
+  du_link (node, s);
+  return node;
+}
+
+NODE *
+make_binop (enum opcode_type opcode, NODE *left, NODE *right)
+{
+  NODE *node = addnode (NODE_BINOP);
+
+  node->v.opcode = opcode;
+  node->left = left;
+  node->right = right;
+  return node;
+}
+
+/* The expression EXPR wrapped in a NODE_EXPR */
+NODE *
+make_expr (NODE *expr)
+{
+  NODE *node = addnode (NODE_EXPR);
+
+  node->v.expr = expr;
+  return node;
+}
+
+NODE *
+make_asgn (SYMBOL *s, NODE *expr)
+{
+  NODE *node = addnode (NODE_ASGN);
+
+  node->v.asgn.symbol = s;
+  node->v.asgn.expr = expr;
+  du_link (node, s);
+  return node;
+}
+
+NODE *
+make_decl (SYMBOL *s, NODE *expr)
+{
+  NODE *node = addnode (NODE_VAR_DECL);
+
+  node->v.vardecl.symbol = s;
+  node->v.vardecl.expr = expr;
+  du_link (node, s);
+  return node;
+}
+
+/* The expression below the NODE_EXPR wrappers of NODE */
+NODE *
+strip (NODE *node)
+{
+  while (node->type == NODE_EXPR)
+    node = node->v.expr;
+  return node;
+}
+
+
+/*
+   Def-use chains.
+
+   Every NODE_VAR and NODE_CALL is kept on the `uses' chain of its
+   symbol, every NODE_ASGN and NODE_VAR_DECL on the `defs' chain.
+   The chains are updated whenever a node gets or loses its symbol,
+   so they always describe the nodes that are still alive.
+*/
+
+void
+du_link (NODE *node, SYMBOL *s)
+{
+  NODE **head;
+
+  du_unlink (node);
+  if (!s)
+    return;
+
+  node->du_def = (node->type == NODE_ASGN || node->type == NODE_VAR_DECL);
+  head = node->du_def ? &s->defs : &s->uses;
+
+  node->du_symbol = s;
+  node->du_prev = NULL;
+  node->du_next = *head;
+  if (*head)
+    (*head)->du_prev = node;
+  *head = node;
+
+  if (node->du_def)
+    s->ndefs++;
+  else
+    s->nuses++;
+}
+
+void
+du_unlink (NODE *node)
+{
+  SYMBOL *s = node->du_symbol;
+
+  if (!s)
+    return;
+
+  if (node->du_prev)
+    node->du_prev->du_next = node->du_next;
+  else if (node->du_def)
+    s->defs = node->du_next;
+  else
+    s->uses = node->du_next;
+  if (node->du_next)
+    node->du_next->du_prev = node->du_prev;
+
+  if (node->du_def)
+    s->ndefs--;
+  else
+    s->nuses--;
+
+  node->du_symbol = NULL;
+  node->du_prev = node->du_next = NULL;
+}
+
 
 /*
    General routines to traverse the parse tree.
@@ -131,6 +287,7 @@ traverse_node (NODE *node, traverse_fp *fptab)
   if (!node)
     return;
 
+  traverse_visits++;
   traverse_node (node->left, fptab);
   traverse_node (node->right, fptab);
 
@@ -157,6 +314,7 @@ traverse_node (NODE *node, traverse_fp *fptab)
 static void
 traverse_stmt (NODE *node, traverse_fp *fptab)
 {
+  traverse_visits++;
   switch (node->type) {
   case NODE_CALL:
     traverse_funcall (node, fptab);
@@ -206,6 +364,175 @@ traverse (NODE *node, traverse_fp *fptab)
     traverse_stmt (node, fptab);
 }
 
+void
+traverse_expr (NODE *node, traverse_fp *fptab)
+{
+  traverse_node (node, fptab);
+}
+
+static size_t counted;
+
+static void
+count_node (NODE *node)
+{
+  counted++;
+}
+
+static traverse_fp count_fptab[] = {
+  count_node,  /* NODE_NOOP */
+  count_node,  /* NODE_UNOP */
+  count_node,  /* NODE_BINOP */
+  count_node,  /* NODE_CONST */
+  count_node,  /* NODE_VAR */
+  count_node,  /* NODE_CALL */
+  count_node,  /* NODE_ASGN */
+  count_node,  /* NODE_EXPR */
+  count_node,  /* NODE_RETURN */
+  count_node,  /* NODE_PRINT */
+  count_node,  /* NODE_JUMP */
+  count_node,  /* NODE_COMPOUND  */
+  count_node,  /* NODE_ITERATION */
+  count_node,  /* NODE_CONDITION */
+  count_node,  /* NODE_VAR_DECL */
+  count_node,  /* NODE_FNC_DECL */
+};
+
+/* The number of nodes of the statements from NODE on */
+size_t
+count_nodes (NODE *node)
+{
+  counted = 0;
+  traverse (node, count_fptab);
+  return counted;
+}
+
+
+/*
+   Copying the parse tree.
+
+   The copies go on the def-use chains of their symbols.  The hooks
+   let the caller give the copy other symbols, replace variable reads
+   by expressions of its own, and copy some statements itself.
+*/
+
+static SYMBOL *
+copy_symbol (SYMBOL *s, struct copy_hooks *hooks)
+{
+  return hooks && hooks->symbol ? hooks->symbol (s) : s;
+}
+
+static ARGLIST *
+copy_args (ARGLIST *arg, struct copy_hooks *hooks)
+{
+  ARGLIST *head = NULL, **tail = &head;
+
+  for (; arg; arg = arg->next)
+    {
+      *tail = make_arglist (copy_expr (arg->node, hooks), NULL);
+      tail = &(*tail)->next;
+    }
+  return head;
+}
+
+NODE *
+copy_expr (NODE *node, struct copy_hooks *hooks)
+{
+  NODE *copy;
+
+  if (!node)
+    return NULL;
+  if (node->type == NODE_VAR && hooks && hooks->var
+      && (copy = hooks->var (node)))
+    return copy;
+  copy = addnode (node->type);
+  copy->v = node->v;
+  copy->safe_div = node->safe_div;
+  copy->left = copy_expr (node->left, hooks);
+  copy->right = copy_expr (node->right, hooks);
+  switch (node->type) {
+  case NODE_VAR:
+    copy->v.symbol = copy_symbol (node->v.symbol, hooks);
+    du_link (copy, copy->v.symbol);
+    break;
+  case NODE_CALL:
+    copy->v.funcall.args = copy_args (node->v.funcall.args, hooks);
+    du_link (copy, copy->v.funcall.symbol);
+    break;
+  case NODE_EXPR:
+    copy->v.expr = copy_expr (node->v.expr, hooks);
+    break;
+  default:
+    break;
+  }
+  return copy;
+}
+
+/* Copy the statement NODE, DEPTH loops deep, to the end of the list
+   at *TAIL; returns the new end */
+static NODE **
+copy_stmt (NODE *node, unsigned depth, NODE **tail,
+	   struct copy_hooks *hooks)
+{
+  NODE *copy, **end;
+
+  if (hooks && hooks->stmt && (end = hooks->stmt (node, depth, tail)))
+    return end;
+  copy = addnode (node->type);
+  copy->v = node->v;
+  switch (node->type) {
+  case NODE_CALL:
+    copy->v.funcall.args = copy_args (node->v.funcall.args, hooks);
+    du_link (copy, copy->v.funcall.symbol);
+    break;
+  case NODE_ASGN:
+    copy->v.asgn.symbol = copy_symbol (node->v.asgn.symbol, hooks);
+    copy->v.asgn.expr = copy_expr (node->v.asgn.expr, hooks);
+    du_link (copy, copy->v.asgn.symbol);
+    break;
+  case NODE_VAR_DECL:
+    copy->v.vardecl.symbol = copy_symbol (node->v.vardecl.symbol, hooks);
+    copy->v.vardecl.expr = copy_expr (node->v.vardecl.expr, hooks);
+    du_link (copy, copy->v.vardecl.symbol);
+    break;
+  case NODE_EXPR:
+  case NODE_PRINT:
+  case NODE_RETURN:
+    copy->v.expr = copy_expr (node->v.expr, hooks);
+    break;
+  case NODE_COMPOUND:
+    copy->v.expr = copy_list (node->v.expr, NULL, depth, hooks);
+    break;
+  case NODE_ITERATION:
+    copy->v.iteration.cond = copy_expr (node->v.iteration.cond, hooks);
+    copy->v.iteration.stmt =
+      copy_list (node->v.iteration.stmt, NULL, depth + 1, hooks);
+    break;
+  case NODE_CONDITION:
+    copy->v.condition.cond = copy_expr (node->v.condition.cond, hooks);
+    copy->v.condition.iftrue_stmt =
+      copy_list (node->v.condition.iftrue_stmt, NULL, depth, hooks);
+    copy->v.condition.iffalse_stmt =
+      copy_list (node->v.condition.iffalse_stmt, NULL, depth, hooks);
+    break;
+  default:
+    break;
+  }
+  *tail = copy;
+  return &copy->right;
+}
+
+/* Copy the statements from NODE up to STOP, DEPTH loops deep; HOOKS
+   may be NULL */
+NODE *
+copy_list (NODE *node, NODE *stop, unsigned depth, struct copy_hooks *hooks)
+{
+  NODE *head = NULL, **tail = &head;
+
+  for (; node != stop; node = node->right)
+    tail = copy_stmt (node, depth, tail, hooks);
+  return head;
+}
+
 
 /*
   All the functions below are designed to create
@@ -282,9 +609,23 @@ print_binop (NODE *node)
   case OPCODE_GE:
     printf ("OPCODE_GT");
     break;
+  case OPCODE_MOD:
+    printf ("OPCODE_MOD");
+    break;
+  case OPCODE_SHL:
+    printf ("OPCODE_SHL");
+    break;
+  case OPCODE_SHR:
+    printf ("OPCODE_SHR");
+    break;
+  case OPCODE_BAND:
+    printf ("OPCODE_BAND");
+    break;
   default:
     printf ("UNKNOWN OPCODE");
   }
+  if (node->safe_div)
+    printf (" (safe)");
   fputc ('\n', stdout);
 }
 
@@ -350,6 +691,8 @@ print_call (NODE *node)
 
   for (ptr = node->v.funcall.args; ptr; ptr = ptr->next)
     printf ("%4.4lu ", ptr->node->node_id);
+  if (node->v.funcall.tail)
+    printf ("(tail)");
 
   fputc ('\n', stdout);
 
@@ -20,6 +20,7 @@
 #ifndef _TREE_H
 #define _TREE_H
 
+#include <stddef.h>
 #include "symbol.h"
 
 enum node_type
@@ -57,7 +58,11 @@ enum opcode_type
   OPCODE_LT,
   OPCODE_GT,
   OPCODE_LE,
-  OPCODE_GE
+  OPCODE_GE,
+  OPCODE_MOD,
+  OPCODE_SHL,     /* Shift left by a constant */
+  OPCODE_SHR,     /* Shift right by a constant */
+  OPCODE_BAND     /* Bitwise and with a constant mask */
 };
 
 enum jump_type
@@ -69,11 +74,20 @@ enum jump_type
 struct node_struct
 {
   struct node_struct *memory_link;
+  struct node_struct *memory_prev;
   struct node_struct *left;
   struct node_struct *right;
 
+  SYMBOL *du_symbol;              /* Symbol whose chain holds the node */
+  struct node_struct *du_prev;    /* Neighbours in that chain */
+  struct node_struct *du_next;
+  int du_def;                     /* On the defs (1) or uses (0) chain */
+
   unsigned long node_id;          /* Used while printing the parse tree */
+  unsigned long order;            /* Walk order of the statement */
   enum node_type type;
+  int safe_div;                   /* DIV, MOD: the divisor is never 0,
+                                     see vra.c */
 
   union {
     enum opcode_type opcode;      /* type == NODE_UNOP
@@ -89,6 +103,7 @@ struct node_struct
     struct {
       SYMBOL *symbol;
       struct arglist_struct *args;
+      int tail;                   /* in tail position, see tailrec.c */
     } funcall;                    /* type == NODE_CALL */
 
     struct {
@@ -137,10 +152,21 @@ typedef struct arglist_struct ARGLIST;
 /* Generalized traversal interface */
 typedef void (*traverse_fp)(NODE *);
 
+/* Copying interface, see copy_list (); any hook may be NULL */
+struct copy_hooks
+{
+  SYMBOL *(*symbol)(SYMBOL *);        /* the symbol the copy uses */
+  NODE *(*var)(NODE *);               /* a copy of a variable read,
+                                         or NULL for the usual one */
+  NODE **(*stmt)(NODE *, unsigned, NODE **);
+                                      /* copy a statement, or NULL */
+};
+
 /* Global variables */
 extern NODE *root;  /* the root of a parse tree */
 
 extern unsigned int nodes_counter;
+extern unsigned long traverse_visits;  /* nodes visited by traverse */
 extern int print_offsets;
 
 /* Function prototypes */
@@ -149,7 +175,23 @@ void freenode (NODE *);
 void free_all_nodes (void);
 ARGLIST *make_arglist (NODE *, ARGLIST *);
 
+NODE *make_const (long);
+NODE *make_var (SYMBOL *);
+NODE *make_binop (enum opcode_type, NODE *, NODE *);
+NODE *make_expr (NODE *);
+NODE *make_asgn (SYMBOL *, NODE *);
+NODE *make_decl (SYMBOL *, NODE *);
+NODE *strip (NODE *);
+
+void du_link (NODE *, SYMBOL *);
+void du_unlink (NODE *);
+
 void traverse (NODE *, traverse_fp *);
+void traverse_expr (NODE *, traverse_fp *);
+size_t count_nodes (NODE *);
+
+NODE *copy_expr (NODE *, struct copy_hooks *);
+NODE *copy_list (NODE *, NODE *, unsigned, struct copy_hooks *);
 
 unsigned int get_last_node_id (void);
 void print_tree (NODE *);
@@ -0,0 +1,484 @@
+/*
+   V5: unroll.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "ptrmap.h"
+#include "optimize.h"
+#include "motion.h"
+#include "unroll.h"
+
+extern int verbose;
+
+/*
+  Loop unrolling.
+
+  A counted loop is a `while' comparing a variable with a constant,
+  whose body ends by stepping the variable by a constant, `i = i + C',
+  and does not otherwise write it or leave the loop by a jump.  The
+  statements in front of the loop in its list give the variable a
+  constant, unless one of them may write it: then the number of
+  trips is known.  A global variable may be read by the functions
+  the body calls, so its loop may not call any.
+
+  A loop whose copies all fit in the size budget is replaced by a
+  copy of its body for each trip, reading the value of the variable
+  on that trip, followed by the assignment of the value it ends with.
+  Otherwise the body is copied a few times into the loop, the copies
+  reading the variable plus the steps before them, the loop stepping
+  by all of them at once and stopping before it would run too far;
+  the trips left over follow the loop as copies reading constants.
+  The copies are put in compound statements of their own, like the
+  body was, and pass 2 folds the constants read.
+
+  The start, the bound and the step are bounded, so that the variable
+  never wraps around.  Inner loops are unrolled first.
+*/
+
+#define UNROLL_TRIPS 32           /* trips of a loop unrolled fully */
+#define UNROLL_FULL_SIZE 256      /* nodes of the copies of all trips */
+#define UNROLL_FACTOR 4           /* copies of a body in a loop */
+#define UNROLL_BODY_SIZE 64       /* nodes of a body copied in a loop */
+#define UNROLL_GROWTH_MIN 256     /* nodes the program may always grow */
+#define STEP_MAX  65536L          /* largest step of a counted loop */
+#define START_MAX 4294967296L     /* largest start or bound */
+
+static size_t budget;             /* nodes the program may grow */
+static size_t nfull, npartial, nadded;
+
+static SYMBOL *counter;           /* the variable being substituted */
+static long counter_add;          /* what the copy reads instead */
+static int counter_const;         /* the constant, or the variable plus it */
+
+
+/* Counted loops */
+
+static int scan_bad;
+static int scan_calls;
+
+static void
+note_call (NODE *node)
+{
+  scan_calls = 1;
+}
+
+traverse_fp unroll_call_fptab[] = {
+  NULL,        /* NODE_NOOP */
+  NULL,        /* NODE_UNOP */
+  NULL,        /* NODE_BINOP */
+  NULL,        /* NODE_CONST */
+  NULL,        /* NODE_VAR */
+  note_call,   /* NODE_CALL */
+  NULL,        /* NODE_ASGN */
+  NULL,        /* NODE_EXPR */
+  NULL,        /* NODE_RETURN */
+  NULL,        /* NODE_PRINT */
+  NULL,        /* NODE_JUMP */
+  NULL,        /* NODE_COMPOUND  */
+  NULL,        /* NODE_ITERATION */
+  NULL,        /* NODE_CONDITION */
+  NULL,        /* NODE_VAR_DECL */
+  NULL,        /* NODE_FNC_DECL */
+};
+
+/* Check the statements from NODE up to STOP, DEPTH loops deep in the
+   body, for writes of the counter and jumps out of the body */
+static void
+check_list (NODE *node, NODE *stop, unsigned depth)
+{
+  for (; node != stop && !scan_bad; node = node->right)
+    switch (node->type) {
+    case NODE_ASGN:
+      scan_bad = node->v.asgn.symbol == counter;
+      break;
+    case NODE_VAR_DECL:
+      scan_bad = node->v.vardecl.symbol == counter;
+      break;
+    case NODE_JUMP:
+      scan_bad = (node->v.jump.level ? node->v.jump.level : 1) > depth;
+      break;
+    case NODE_COMPOUND:
+      check_list (node->v.expr, NULL, depth);
+      break;
+    case NODE_ITERATION:
+      check_list (node->v.iteration.stmt, NULL, depth + 1);
+      break;
+    case NODE_CONDITION:
+      check_list (node->v.condition.iftrue_stmt, NULL, depth);
+      check_list (node->v.condition.iffalse_stmt, NULL, depth);
+      break;
+    case NODE_FNC_DECL:
+      scan_bad = 1;
+      break;
+    default:
+      break;
+    }
+}
+
+/* The step of an assignment `S = S + C' to the counter S, or 0 */
+static long
+step_of (NODE *node)
+{
+  NODE *e, *l, *r;
+
+  if (node->type != NODE_ASGN || node->v.asgn.symbol != counter)
+    return 0;
+  e = strip (node->v.asgn.expr);
+  if (e->type != NODE_BINOP || e->v.opcode != OPCODE_ADD)
+    return 0;
+  l = strip (e->left);
+  r = strip (e->right);
+  if (l->type == NODE_VAR && r->type == NODE_CONST)
+    {
+      NODE *t = l;
+      l = r;
+      r = t;
+    }
+  if (l->type != NODE_CONST || r->type != NODE_VAR
+      || r->v.symbol != counter
+      || l->v.number < -STEP_MAX || l->v.number > STEP_MAX)
+    return 0;
+  return l->v.number;
+}
+
+/* The trips of `while (I OP BOUND)' with I going from START by STEP,
+   or -1 if the loop would not stop before I wraps around */
+static long
+trips (enum opcode_type op, long start, long bound, long step)
+{
+  long d = bound - start;
+
+  switch (op) {
+  case OPCODE_LT:
+    if (start >= bound)
+      return 0;
+    return step > 0 ? (d + step - 1) / step : -1;
+  case OPCODE_LE:
+    if (start > bound)
+      return 0;
+    return step > 0 ? d / step + 1 : -1;
+  case OPCODE_GT:
+    if (start <= bound)
+      return 0;
+    return step < 0 ? (d + step + 1) / step : -1;
+  case OPCODE_GE:
+    if (start < bound)
+      return 0;
+    return step < 0 ? d / step + 1 : -1;
+  case OPCODE_EQ:
+    return start == bound;
+  case OPCODE_NE:
+    if (d % step == 0 && d / step >= 0)
+      return d / step;
+    return -1;
+  default:
+    return -1;
+  }
+}
+
+/* The operator comparing the operands the other way round */
+static enum opcode_type
+mirror (enum opcode_type op)
+{
+  switch (op) {
+  case OPCODE_LT:
+    return OPCODE_GT;
+  case OPCODE_GT:
+    return OPCODE_LT;
+  case OPCODE_LE:
+    return OPCODE_GE;
+  case OPCODE_GE:
+    return OPCODE_LE;
+  default:
+    return op;
+  }
+}
+
+
+/* Copying the body */
+
+/* The copy of a read of the counter */
+static NODE *
+copy_counter (NODE *node)
+{
+  if (node->v.symbol != counter)
+    return NULL;
+  if (counter_const)
+    return make_const (counter_add);
+  if (counter_add)
+    return make_binop (OPCODE_ADD, make_const (counter_add),
+		       make_var (counter));
+  return NULL;
+}
+
+static struct copy_hooks unroll_hooks = { NULL, copy_counter, NULL };
+
+/* A compound statement with a copy of the statements from NODE up
+   to STOP, reading the counter plus ADD, or ADD if CONSTANT */
+static NODE *
+copy_body (NODE *node, NODE *stop, long add, int constant)
+{
+  NODE *compound = addnode (NODE_COMPOUND);
+
+  counter_add = add;
+  counter_const = constant;
+  compound->v.expr = copy_list (node, stop, 0, &unroll_hooks);
+  return compound;
+}
+
+
+/* Unrolling */
+
+/* Try to unroll LOOP, whose counter the statements before it set to
+   the constants in KNOWN */
+static void
+try_loop (NODE *loop, struct ptrmap *known)
+{
+  NODE *cond = strip (loop->v.iteration.cond), *body, *step, *set, *var;
+  NODE *bound, *node;
+  enum opcode_type op;
+  long start, inc, n, m, i;
+  size_t size;
+
+  if (cond->type != NODE_BINOP || cond->v.opcode < OPCODE_EQ
+      || cond->v.opcode > OPCODE_GE)
+    return;
+  var = strip (cond->left);
+  bound = strip (cond->right);
+  op = cond->v.opcode;
+  if (var->type == NODE_CONST)
+    {
+      var = bound;
+      bound = strip (cond->left);
+      op = mirror (op);
+    }
+  if (var->type != NODE_VAR || bound->type != NODE_CONST)
+    return;
+  counter = var->v.symbol;
+  set = ptrmap_get (known, counter, 0);
+  if (!set)
+    return;
+  start = strip (set->type == NODE_ASGN ? set->v.asgn.expr
+		 : set->v.vardecl.expr)->v.number;
+  if (start < -START_MAX || start > START_MAX
+      || bound->v.number < -START_MAX || bound->v.number > START_MAX)
+    return;
+
+  /* The body ends with the step */
+  body = loop->v.iteration.stmt;
+  if (!body)
+    return;
+  node = body->type == NODE_COMPOUND ? body->v.expr : body;
+  if (!node)
+    return;
+  for (step = node; step->right; step = step->right)
+    ;
+  inc = step_of (step);
+  if (!inc)
+    return;
+  scan_bad = 0;
+  check_list (node, step, 0);
+  scan_calls = 0;
+  if (counter->v.var->qualifier == QUA_GLOBAL)
+    traverse (body, unroll_call_fptab);
+  if (scan_bad || scan_calls)
+    return;
+  n = trips (op, start, bound->v.number, inc);
+  if (n < 0)
+    return;
+
+  size = count_nodes (body);
+
+  if (n <= UNROLL_TRIPS && n * size <= UNROLL_FULL_SIZE
+      && nadded + n * size <= budget)
+    {
+      if (verbose > 1)
+	printf ("Unrolling loop, node %4.4lu (%ld trips)\n",
+		loop->node_id, n);
+      for (i = 0; i < n; i++)
+	motion_insert_before (loop, copy_body (node, step, start + i * inc,
+					       1));
+      /* The loop becomes the assignment of the last value */
+      traverse_expr (loop->v.iteration.cond, unlink_fptab);
+      traverse (body, unlink_fptab);
+      loop->type = NODE_ASGN;
+      loop->v.asgn.symbol = counter;
+      loop->v.asgn.expr = make_expr (make_const (start + n * inc));
+      du_link (loop, counter);
+      nfull++;
+      nadded += n * size;
+      return;
+    }
+
+  m = n / UNROLL_FACTOR;
+  if (m < 2 || size > UNROLL_BODY_SIZE
+      || nadded + (UNROLL_FACTOR + n % UNROLL_FACTOR) * size > budget)
+    return;
+  if (verbose > 1)
+    printf ("Unrolling loop, node %4.4lu (%ld trips, %d copies)\n",
+	    loop->node_id, n, UNROLL_FACTOR);
+
+  /* The trips left over, reading constants */
+  if (n % UNROLL_FACTOR)
+    {
+      motion_insert_after (loop,
+			   make_asgn (counter,
+				      make_expr (make_const (start + n * inc))));
+      for (i = n - 1; i >= m * UNROLL_FACTOR; i--)
+	motion_insert_after (loop, copy_body (node, step, start + i * inc,
+					      1));
+    }
+
+  /* The loop runs M times, stepping by all the copies */
+  node = body->type == NODE_COMPOUND ? body->v.expr : body;
+  set = NULL;
+  for (i = 0; i < UNROLL_FACTOR; i++)
+    {
+      NODE *copy = copy_body (node, step, i * inc, 0);
+      copy->right = set;
+      set = copy;
+    }
+  /* The copies were chained backwards */
+  body = NULL;
+  while (set)
+    {
+      NODE *next = set->right;
+      set->right = body;
+      body = set;
+      set = next;
+    }
+  for (set = body; set->right; set = set->right)
+    ;
+  set->right = make_asgn (counter,
+			  make_expr (make_binop (OPCODE_ADD,
+						 make_const (UNROLL_FACTOR * inc),
+						 make_var (counter))));
+  traverse (loop->v.iteration.stmt, unlink_fptab);
+  loop->v.iteration.stmt = addnode (NODE_COMPOUND);
+  loop->v.iteration.stmt->v.expr = body;
+
+  traverse_expr (loop->v.iteration.cond, unlink_fptab);
+  loop->v.iteration.cond =
+    make_expr (make_binop (inc > 0 ? OPCODE_GT : OPCODE_LT,
+			   make_const (start + m * UNROLL_FACTOR * inc),
+			   make_var (counter)));
+  npartial++;
+  nadded += (UNROLL_FACTOR + n % UNROLL_FACTOR) * size;
+}
+
+/* Does the expression NODE call a function? */
+static int
+has_call (NODE *node)
+{
+  scan_calls = 0;
+  if (node)
+    traverse_expr (node, unroll_call_fptab);
+  return scan_calls;
+}
+
+/* Unroll the loops of the list from NODE, the inner ones first.  The
+   constants assigned by the statements are known until a statement
+   that may write anything, a call or a nested one. */
+static void
+unroll_list (NODE *node)
+{
+  struct ptrmap known;
+  NODE *expr, *next;
+  SYMBOL *s;
+
+  ptrmap_init (&known);
+  for (; node; node = node->right)
+    switch (node->type) {
+    case NODE_ASGN:
+    case NODE_VAR_DECL:
+      if (node->type == NODE_ASGN)
+	{
+	  s = node->v.asgn.symbol;
+	  expr = node->v.asgn.expr;
+	}
+      else
+	{
+	  s = node->v.vardecl.symbol;
+	  expr = node->v.vardecl.expr;
+	}
+      if (has_call (expr))
+	ptrmap_free (&known);
+      else if (s)
+	ptrmap_put (&known, s, 0,
+		    expr && strip (expr)->type == NODE_CONST ? node : NULL);
+      break;
+    case NODE_CALL:
+      ptrmap_free (&known);
+      break;
+    case NODE_EXPR:
+    case NODE_PRINT:
+    case NODE_RETURN:
+      if (has_call (node->v.expr))
+	ptrmap_free (&known);
+      break;
+    case NODE_COMPOUND:
+      unroll_list (node->v.expr);
+      ptrmap_free (&known);
+      break;
+    case NODE_ITERATION:
+      unroll_list (node->v.iteration.stmt);
+      next = node->right;
+      if (!has_call (node->v.iteration.cond))
+	try_loop (node, &known);
+      /* Skip the trips left over, unrolled already */
+      while (node->right != next)
+	node = node->right;
+      ptrmap_free (&known);
+      break;
+    case NODE_CONDITION:
+      unroll_list (node->v.condition.iftrue_stmt);
+      unroll_list (node->v.condition.iffalse_stmt);
+      ptrmap_free (&known);
+      break;
+    case NODE_FNC_DECL:
+      unroll_list (node->v.fncdecl.stmt);
+      break;
+    default:
+      break;
+    }
+  ptrmap_free (&known);
+}
+
+/* Unroll the counted loops of the program rooted at *ROOTP.  Returns
+   the number of loops unrolled. */
+size_t
+unroll_run (NODE **rootp)
+{
+  nfull = npartial = nadded = 0;
+  budget = nodes_counter > UNROLL_GROWTH_MIN ? nodes_counter
+    : UNROLL_GROWTH_MIN;
+
+  motion_begin (rootp);
+  unroll_list (*rootp);
+  motion_end ();
+
+  if (verbose > 1)
+    printf ("Unrolling: %lu loops fully, %lu partially, %lu nodes added\n",
+	    (unsigned long) nfull, (unsigned long) npartial,
+	    (unsigned long) nadded);
+  return nfull + npartial;
+}
@@ -0,0 +1,936 @@
+/*
+   V5: vra.c
+
+   Copyright (C) 2003, 2004 Wojciech Polak.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "tree.h"
+#include "mm.h"
+#include "cfg.h"
+#include "ssa.h"
+#include "ipa.h"
+#include "optimize.h"
+#include "vra.h"
+
+extern int verbose;
+
+/*
+  Value-range analysis.
+
+  Every SSA value, see ssa.c, gets the interval [lo, hi] holding all
+  the values it may take.  The ranges are solved like SCCP solves its
+  lattice: they start empty, blocks are evaluated once an executable
+  edge reaches them, and a phi joins only the operands coming over
+  executable edges.  A range only grows; one that keeps growing is
+  widened to the end of the type, so that loops converge.
+
+  Arithmetic wraps around, so an operation that may overflow gives
+  the whole range.  A variable read where a branch on it decided the
+  way in gets the range the condition leaves it: the body of
+  `while (i < n)' reads i below LONG_MAX, so i + 1 does not wrap.
+  Those bounds come from values the reading site is not a user of, so
+  the solver sweeps the executable blocks until nothing changes.
+
+  The comparisons and conditions the ranges decide are replaced by
+  their values, and pass 5 then drops the branches never taken.  The
+  divisions and modulos whose divisor never holds 0 are marked, so a
+  code generator may leave out the check for division by zero.
+*/
+
+#define VRA_WIDEN 2                /* changes before a bound widens */
+#define VRA_DEPTH 32               /* dominators searched for branches */
+
+struct range
+{
+  int empty;                       /* no value seen yet */
+  long lo, hi;
+};
+
+static struct ssa *ssa;            /* form being solved */
+static struct range *ranges;       /* per value */
+static unsigned char *changes;     /* per value, up to VRA_WIDEN + 1 */
+static int refining;               /* evaluating a condition */
+static int folding;                /* rewriting the tree */
+
+static struct ssa_value **value_work;
+static size_t nvalue_work, value_work_size;
+static struct cfg_block **block_work;
+static size_t nblock_work, block_work_size;
+
+static size_t nfolded;
+static size_t nsafe;
+
+
+/* Intervals */
+
+static struct range
+range_make (long lo, long hi)
+{
+  struct range r;
+
+  r.empty = 0;
+  r.lo = lo;
+  r.hi = hi;
+  return r;
+}
+
+static struct range
+range_empty (void)
+{
+  struct range r;
+
+  r.empty = 1;
+  r.lo = r.hi = 0;
+  return r;
+}
+
+static struct range
+range_full (void)
+{
+  return range_make (LONG_MIN, LONG_MAX);
+}
+
+static struct range
+range_join (struct range a, struct range b)
+{
+  if (a.empty)
+    return b;
+  if (b.empty)
+    return a;
+  return range_make (a.lo < b.lo ? a.lo : b.lo, a.hi > b.hi ? a.hi : b.hi);
+}
+
+/* The range of a truth value: 1 if R never holds 0, 0 if it only
+   holds 0 */
+static struct range
+range_truth (struct range r)
+{
+  if (r.empty)
+    return r;
+  if (r.lo > 0 || r.hi < 0)
+    return range_make (1, 1);
+  if (r.lo == 0 && r.hi == 0)
+    return range_make (0, 0);
+  return range_make (0, 1);
+}
+
+static int
+add_overflows (long a, long b, long *p)
+{
+  if (b > 0 ? a > LONG_MAX - b : a < LONG_MIN - b)
+    return 1;
+  *p = a + b;
+  return 0;
+}
+
+static int
+sub_overflows (long a, long b, long *p)
+{
+  if (b < 0 ? a > LONG_MAX + b : a < LONG_MIN + b)
+    return 1;
+  *p = a - b;
+  return 0;
+}
+
+static int
+mul_overflows (long a, long b, long *p)
+{
+  if (a && b
+      && (a == -1 ? b == LONG_MIN
+	  : b == -1 ? a == LONG_MIN
+	  : a > 0 ? (b > 0 ? a > LONG_MAX / b : b < LONG_MIN / a)
+	  : (b > 0 ? a < LONG_MIN / b : a < LONG_MAX / b)))
+    return 1;
+  *p = a * b;
+  return 0;
+}
+
+static struct range
+range_mul (struct range a, struct range b)
+{
+  long p[4], lo, hi;
+  int i;
+
+  if ((a.lo == 0 && a.hi == 0) || (b.lo == 0 && b.hi == 0))
+    return range_make (0, 0);
+  if (mul_overflows (a.lo, b.lo, &p[0]) || mul_overflows (a.lo, b.hi, &p[1])
+      || mul_overflows (a.hi, b.lo, &p[2])
+      || mul_overflows (a.hi, b.hi, &p[3]))
+    return range_full ();
+  lo = hi = p[0];
+  for (i = 1; i < 4; i++)
+    {
+      if (p[i] < lo)
+	lo = p[i];
+      if (p[i] > hi)
+	hi = p[i];
+    }
+  return range_make (lo, hi);
+}
+
+/* A divided by a divisor in [LO, HI], which does not hold 0.  The
+   quotient is monotonic in either operand, so the corners bound it. */
+static struct range
+range_div_part (struct range a, long lo, long hi)
+{
+  long p[4], qlo, qhi;
+  int i;
+
+  if (lo > hi)
+    return range_empty ();
+  if (a.lo == LONG_MIN && lo <= -1 && hi >= -1)
+    return range_full ();
+  p[0] = a.lo / lo;
+  p[1] = a.lo / hi;
+  p[2] = a.hi / lo;
+  p[3] = a.hi / hi;
+  qlo = qhi = p[0];
+  for (i = 1; i < 4; i++)
+    {
+      if (p[i] < qlo)
+	qlo = p[i];
+      if (p[i] > qhi)
+	qhi = p[i];
+    }
+  return range_make (qlo, qhi);
+}
+
+/* A division by 0 fails, so only the other divisors count */
+static struct range
+range_div (struct range a, struct range b)
+{
+  return range_join (range_div_part (a, b.lo, b.hi < -1 ? b.hi : -1),
+		     range_div_part (a, b.lo > 1 ? b.lo : 1, b.hi));
+}
+
+/* The remainder is smaller than the divisor and has the sign of the
+   dividend */
+static struct range
+range_mod (struct range a, struct range b)
+{
+  long m = b.hi, lo, hi;
+
+  if (b.lo == LONG_MIN)
+    m = LONG_MAX;
+  else if (-b.lo > m)
+    m = -b.lo;
+  if (m == 0)
+    return range_full ();
+  lo = a.lo > 0 ? 0 : a.lo > 1 - m ? a.lo : 1 - m;
+  hi = a.hi < 0 ? 0 : a.hi < m - 1 ? a.hi : m - 1;
+  return range_make (lo, hi);
+}
+
+static struct range
+range_compare (enum opcode_type op, struct range a, struct range b)
+{
+  int t = 0, f = 0;
+
+  switch (op) {
+  case OPCODE_EQ:
+    t = a.lo == a.hi && b.lo == b.hi && a.lo == b.lo;
+    f = a.hi < b.lo || b.hi < a.lo;
+    break;
+  case OPCODE_NE:
+    f = a.lo == a.hi && b.lo == b.hi && a.lo == b.lo;
+    t = a.hi < b.lo || b.hi < a.lo;
+    break;
+  case OPCODE_LT:
+    t = a.hi < b.lo;
+    f = a.lo >= b.hi;
+    break;
+  case OPCODE_GT:
+    t = a.lo > b.hi;
+    f = a.hi <= b.lo;
+    break;
+  case OPCODE_LE:
+    t = a.hi <= b.lo;
+    f = a.lo > b.hi;
+    break;
+  case OPCODE_GE:
+    t = a.lo >= b.hi;
+    f = a.hi < b.lo;
+    break;
+  default:
+    break;
+  }
+  if (t)
+    return range_make (1, 1);
+  if (f)
+    return range_make (0, 0);
+  return range_make (0, 1);
+}
+
+static struct range
+range_binop (enum opcode_type op, struct range a, struct range b)
+{
+  long lo, hi;
+  int k;
+
+  if (a.empty || b.empty)
+    return range_empty ();
+
+  switch (op) {
+  case OPCODE_ADD:
+    if (add_overflows (a.lo, b.lo, &lo) || add_overflows (a.hi, b.hi, &hi))
+      return range_full ();
+    return range_make (lo, hi);
+  case OPCODE_SUB:
+    if (sub_overflows (a.lo, b.hi, &lo) || sub_overflows (a.hi, b.lo, &hi))
+      return range_full ();
+    return range_make (lo, hi);
+  case OPCODE_MUL:
+    return range_mul (a, b);
+  case OPCODE_DIV:
+    return range_div (a, b);
+  case OPCODE_MOD:
+    return range_mod (a, b);
+  case OPCODE_EQ:
+  case OPCODE_NE:
+  case OPCODE_LT:
+  case OPCODE_GT:
+  case OPCODE_LE:
+  case OPCODE_GE:
+    return range_compare (op, a, b);
+  case OPCODE_SHL:
+    if (b.lo != b.hi || (k = b.lo & 63) == 63
+	|| a.lo < (LONG_MIN >> k) || a.hi > (LONG_MAX >> k))
+      return range_full ();
+    return range_make (a.lo * (1L << k), a.hi * (1L << k));
+  case OPCODE_SHR:
+    /* Shifting moves toward 0 or -1 */
+    if (b.lo != b.hi)
+      return range_make (a.lo < 0 ? a.lo : 0, a.hi >= 0 ? a.hi : -1);
+    k = b.lo & 63;
+    return range_make (a.lo >> k, a.hi >> k);
+  case OPCODE_BAND:
+    if (a.lo >= 0 && b.lo >= 0)
+      return range_make (0, a.hi < b.hi ? a.hi : b.hi);
+    if (a.lo >= 0)
+      return range_make (0, a.hi);
+    if (b.lo >= 0)
+      return range_make (0, b.hi);
+    return range_full ();
+  default:
+    return range_full ();
+  }
+}
+
+
+/* Conditions */
+
+static struct range eval (NODE *, struct cfg_block *);
+
+static enum opcode_type
+negate (enum opcode_type op)
+{
+  switch (op) {
+  case OPCODE_EQ:
+    return OPCODE_NE;
+  case OPCODE_NE:
+    return OPCODE_EQ;
+  case OPCODE_LT:
+    return OPCODE_GE;
+  case OPCODE_GT:
+    return OPCODE_LE;
+  case OPCODE_LE:
+    return OPCODE_GT;
+  default:
+    return OPCODE_LT;
+  }
+}
+
+/* The operator comparing the operands the other way round */
+static enum opcode_type
+mirror (enum opcode_type op)
+{
+  switch (op) {
+  case OPCODE_LT:
+    return OPCODE_GT;
+  case OPCODE_GT:
+    return OPCODE_LT;
+  case OPCODE_LE:
+    return OPCODE_GE;
+  case OPCODE_GE:
+    return OPCODE_LE;
+  default:
+    return op;
+  }
+}
+
+/* Narrow R, the range of a value known to compare by OP with a value
+   in the range B */
+static struct range
+constrain (struct range r, enum opcode_type op, struct range b)
+{
+  if (r.empty || b.empty)
+    return range_empty ();
+
+  switch (op) {
+  case OPCODE_LT:
+    if (b.hi == LONG_MIN)
+      return range_empty ();
+    if (r.hi > b.hi - 1)
+      r.hi = b.hi - 1;
+    break;
+  case OPCODE_LE:
+    if (r.hi > b.hi)
+      r.hi = b.hi;
+    break;
+  case OPCODE_GT:
+    if (b.lo == LONG_MAX)
+      return range_empty ();
+    if (r.lo < b.lo + 1)
+      r.lo = b.lo + 1;
+    break;
+  case OPCODE_GE:
+    if (r.lo < b.lo)
+      r.lo = b.lo;
+    break;
+  case OPCODE_EQ:
+    if (r.lo < b.lo)
+      r.lo = b.lo;
+    if (r.hi > b.hi)
+      r.hi = b.hi;
+    break;
+  case OPCODE_NE:
+    if (b.lo != b.hi)
+      break;
+    if (r.lo == b.lo && r.hi == b.lo)
+      return range_empty ();
+    if (r.lo == b.lo)
+      r.lo++;
+    else if (r.hi == b.lo)
+      r.hi--;
+    break;
+  default:
+    break;
+  }
+  if (r.lo > r.hi)
+    return range_empty ();
+  return r;
+}
+
+static int
+is_value (NODE *node, struct ssa_value *v)
+{
+  return node->type == NODE_VAR && ssa_use_value (ssa, node) == v;
+}
+
+/* Narrow R, the range of V, by the condition COND evaluated at the
+   end of block B having the truth value TRUTH */
+static struct range
+assume (NODE *cond, int truth, struct ssa_value *v, struct range r,
+	struct cfg_block *b)
+{
+  enum opcode_type op;
+
+  if (r.empty)
+    return r;
+
+  switch (cond->type) {
+  case NODE_EXPR:
+    return assume (cond->v.expr, truth, v, r, b);
+  case NODE_VAR:
+    if (is_value (cond, v))
+      return constrain (r, truth ? OPCODE_NE : OPCODE_EQ, range_make (0, 0));
+    return r;
+  case NODE_UNOP:
+    if (cond->v.opcode == OPCODE_NOT)
+      return assume (cond->left, !truth, v, r, b);
+    return r;
+  case NODE_BINOP:
+    op = cond->v.opcode;
+    if ((op == OPCODE_AND && truth) || (op == OPCODE_OR && !truth))
+      return assume (cond->right, truth, v,
+		     assume (cond->left, truth, v, r, b), b);
+    if (op < OPCODE_EQ || op > OPCODE_GE)
+      return r;
+    if (!truth)
+      op = negate (op);
+    if (is_value (cond->left, v) && !is_value (cond->right, v))
+      return constrain (r, op, eval (cond->right, b));
+    if (is_value (cond->right, v) && !is_value (cond->left, v))
+      return constrain (r, mirror (op), eval (cond->left, b));
+    return r;
+  default:
+    return r;
+  }
+}
+
+/* Narrow R, the range of V, by the branch of P that leads to S */
+static struct range
+assume_edge (struct cfg_block *p, struct cfg_block *s, struct ssa_value *v,
+	     struct range r)
+{
+  if (!p->branch || p->succ[0] == p->succ[1])
+    return r;
+  return assume (cfg_branch_cond (p), p->succ[0] == s, v, r, p);
+}
+
+/* Narrow R, the range of V, by the branches deciding the way into
+   the blocks dominating B, and from B into S unless it is NULL.  A
+   block entered from one predecessor only is entered when the branch
+   of the predecessor goes its way. */
+static struct range
+refine (struct ssa_value *v, struct range r, struct cfg_block *b,
+	struct cfg_block *s)
+{
+  int saved = folding, depth;
+
+  refining = 1;
+  folding = 0;
+  if (s)
+    r = assume_edge (b, s, v, r);
+  for (depth = 0; b && depth < VRA_DEPTH && !r.empty; depth++, b = b->idom)
+    if (b->npreds == 1)
+      r = assume_edge (b->preds[0], b, v, r);
+  refining = 0;
+  folding = saved;
+  return r;
+}
+
+
+/* Evaluating the expressions */
+
+/* An expression without calls or divisions that may fail */
+static int
+pure (NODE *node)
+{
+  switch (node->type) {
+  case NODE_CONST:
+  case NODE_VAR:
+    return 1;
+  case NODE_UNOP:
+    return pure (node->left);
+  case NODE_BINOP:
+    if ((node->v.opcode == OPCODE_DIV || node->v.opcode == OPCODE_MOD)
+	&& !node->safe_div
+	&& (node->right->type != NODE_CONST || node->right->v.number == 0))
+      return 0;
+    return pure (node->left) && pure (node->right);
+  default:
+    return 0;
+  }
+}
+
+static void
+fold (NODE *node, long value)
+{
+  if (verbose > 1)
+    printf ("Folding node %4.4lu (range)\n", node->node_id);
+
+  traverse_expr (node, unlink_fptab);
+  node->left = node->right = NULL;
+  node->v.expr = NULL;
+  node->v.number = value;
+  node->type = NODE_CONST;
+  nfolded++;
+}
+
+/* While folding, replace NODE, whose value is a truth value in R,
+   by its value if R decides it */
+static void
+fold_truth (NODE *node, struct range r)
+{
+  if (folding && !r.empty && r.lo == r.hi && pure (node))
+    fold (node, r.lo);
+}
+
+/* While folding, mark a division by a divisor in R never 0 */
+static void
+mark_division (NODE *node, struct range r)
+{
+  if (!folding)
+    return;
+  node->safe_div = !r.empty && (r.lo > 0 || r.hi < 0);
+  if (node->safe_div)
+    {
+      if (verbose > 1)
+	printf ("Division at node %4.4lu is safe\n", node->node_id);
+      nsafe++;
+    }
+}
+
+/* The range of the variable read by NODE in block B */
+static struct range
+eval_var (NODE *node, struct cfg_block *b)
+{
+  struct ssa_value *v = ssa_use_value (ssa, node);
+
+  if (!v)
+    return range_full ();
+  if (refining || ranges[v->id].empty)
+    return ranges[v->id];
+  return refine (v, ranges[v->id], b, NULL);
+}
+
+/* The range of NODE evaluated in block B */
+static struct range
+eval (NODE *node, struct cfg_block *b)
+{
+  struct range l, r;
+  ARGLIST *arg;
+
+  if (!node)
+    return range_full ();
+
+  switch (node->type) {
+  case NODE_CONST:
+    return range_make (node->v.number, node->v.number);
+
+  case NODE_VAR:
+    return eval_var (node, b);
+
+  case NODE_EXPR:
+    return eval (node->v.expr, b);
+
+  case NODE_UNOP:
+    l = eval (node->left, b);
+    if (l.empty)
+      return l;
+    if (node->v.opcode == OPCODE_NOT)
+      {
+	l = range_truth (l);
+	r = range_make (1 - l.hi, 1 - l.lo);
+	fold_truth (node, r);
+	return r;
+      }
+    if (l.lo == LONG_MIN)
+      return range_full ();
+    return range_make (-l.hi, -l.lo);
+
+  case NODE_BINOP:
+    l = eval (node->left, b);
+    if (node->v.opcode == OPCODE_AND || node->v.opcode == OPCODE_OR)
+      {
+	/* The value deciding the operation */
+	long d = node->v.opcode == OPCODE_OR;
+
+	l = range_truth (l);
+	if (l.empty)
+	  return l;
+	/* Unless the left operand decides, the right one is the value
+	   if it decides or the left one is known */
+	if (l.lo == d && l.hi == d)
+	  r = l;
+	else
+	  {
+	    r = range_truth (eval (node->right, b));
+	    if (r.empty)
+	      return r;
+	    if ((r.lo != d || r.hi != d) && l.lo != l.hi)
+	      r = range_make (0, 1);
+	  }
+	fold_truth (node, r);
+	return r;
+      }
+    r = eval (node->right, b);
+    if (node->v.opcode == OPCODE_DIV || node->v.opcode == OPCODE_MOD)
+      mark_division (node, r);
+    r = range_binop (node->v.opcode, l, r);
+    if (node->v.opcode >= OPCODE_EQ && node->v.opcode <= OPCODE_GE)
+      fold_truth (node, r);
+    return r;
+
+  case NODE_CALL:
+    if (folding)
+      for (arg = node->v.funcall.args; arg; arg = arg->next)
+	eval (arg->node, b);
+    return range_full ();
+
+  default:
+    return range_full ();
+  }
+}
+
+
+/* Solving */
+
+static void
+update (struct ssa_value *v, struct range r)
+{
+  struct range *old = &ranges[v->id];
+  struct range n = range_join (*old, r);
+
+  if (n.empty || (!old->empty && n.lo == old->lo && n.hi == old->hi))
+    return;
+  if (!old->empty && changes[v->id]++ >= VRA_WIDEN)
+    {
+      if (n.lo < old->lo)
+	n.lo = LONG_MIN;
+      if (n.hi > old->hi)
+	n.hi = LONG_MAX;
+    }
+  *old = n;
+
+  if (nvalue_work == value_work_size)
+    {
+      value_work_size = value_work_size ? value_work_size * 2 : 64;
+      value_work = xrealloc (value_work,
+			     value_work_size * sizeof (*value_work));
+    }
+  value_work[nvalue_work++] = v;
+}
+
+static void mark_edge (struct cfg_block *, int);
+
+static void
+eval_phi (struct ssa_value *phi)
+{
+  struct cfg_block *b = phi->block;
+  struct ssa_block *sb = &ssa->blocks[b->index];
+  struct range r = range_empty ();
+  size_t i;
+
+  if (!sb->executable || phi->forward)
+    return;
+  for (i = 0; i < phi->nargs; i++)
+    {
+      struct ssa_value *op = ssa_phi_arg (phi, i);
+      struct range a = ranges[op->id];
+
+      if (!sb->edge_executable[i] || a.empty)
+	continue;
+      r = range_join (r, refine (op, a, b->preds[i], b));
+    }
+  update (phi, r);
+}
+
+static void
+eval_site (struct ssa_site *site)
+{
+  struct range r;
+
+  if (!ssa->blocks[site->block->index].executable)
+    return;
+  if (site->is_branch)
+    {
+      r = range_truth (eval (site->expr, site->block));
+      if (r.empty)
+	return;
+      if (r.hi == 1)
+	mark_edge (site->block, 0);
+      if (r.lo == 0)
+	mark_edge (site->block, 1);
+    }
+  else if (site->def)
+    update (site->def,
+	    site->expr ? eval (site->expr, site->block) : range_full ());
+}
+
+static void
+mark_edge (struct cfg_block *b, int k)
+{
+  struct cfg_block *s = b->succ[k];
+  struct ssa_block *sb;
+  struct ssa_value *phi;
+
+  if (!s)
+    return;
+  sb = &ssa->blocks[s->index];
+  if (sb->edge_executable[b->succ_pred[k]])
+    return;
+  sb->edge_executable[b->succ_pred[k]] = 1;
+
+  if (!sb->executable)
+    {
+      sb->executable = 1;
+      if (nblock_work == block_work_size)
+	{
+	  block_work_size = block_work_size ? block_work_size * 2 : 16;
+	  block_work = xrealloc (block_work,
+				 block_work_size * sizeof (*block_work));
+	}
+      block_work[nblock_work++] = s;
+    }
+  else
+    for (phi = sb->phis; phi; phi = phi->block_next)
+      eval_phi (phi);
+}
+
+static void
+visit_block (struct cfg_block *b)
+{
+  struct ssa_block *sb = &ssa->blocks[b->index];
+  struct ssa_value *phi;
+  size_t i;
+
+  for (phi = sb->phis; phi; phi = phi->block_next)
+    eval_phi (phi);
+  for (i = 0; i < sb->nsites; i++)
+    eval_site (sb->sites[i]);
+  if (!b->branch)
+    mark_edge (b, 0);
+}
+
+static void
+vra_solve (void)
+{
+  struct cfg *g = ssa->cfg;
+  size_t i, j;
+
+  for (i = 0; i < g->nrpo; i++)
+    {
+      struct cfg_block *b = g->rpo[i];
+      ssa->blocks[b->index].edge_executable = calloc (b->npreds ? b->npreds
+						      : 1, 1);
+      if (!ssa->blocks[b->index].edge_executable)
+	exit (EXIT_FAILURE);
+    }
+  ranges = xrealloc (NULL, (ssa->nvalues ? ssa->nvalues : 1)
+		     * sizeof (*ranges));
+  changes = calloc (ssa->nvalues ? ssa->nvalues : 1, 1);
+  if (!changes)
+    exit (EXIT_FAILURE);
+  for (i = 0; i < ssa->nvalues; i++)
+    if (ssa->values[i]->kind == SSA_ENTRY
+	|| ssa->values[i]->kind == SSA_CLOBBER)
+      ranges[i] = range_full ();
+    else
+      ranges[i] = range_empty ();
+
+  ssa->blocks[g->entry->index].executable = 1;
+  nblock_work = nvalue_work = 0;
+  block_work = xrealloc (block_work, sizeof (*block_work)
+			 * (block_work_size = block_work_size ? block_work_size
+			    : 16));
+  block_work[nblock_work++] = g->entry;
+
+  for (;;)
+    {
+      while (nblock_work || nvalue_work)
+	{
+	  if (nblock_work)
+	    {
+	      visit_block (block_work[--nblock_work]);
+	      continue;
+	    }
+	  {
+	    struct ssa_value *v = value_work[--nvalue_work];
+	    for (j = 0; j < v->nusers; j++)
+	      if (v->users[j].site)
+		eval_site (v->users[j].site);
+	      else
+		eval_phi (v->users[j].phi);
+	  }
+	}
+
+      /* The bounds taken from the branches have no users */
+      for (i = 0; i < g->nrpo; i++)
+	if (ssa->blocks[g->rpo[i]->index].executable)
+	  visit_block (g->rpo[i]);
+      if (!nblock_work && !nvalue_work)
+	break;
+    }
+}
+
+static void
+vra_print (void)
+{
+  struct cfg *g = ssa->cfg;
+  size_t i;
+
+  printf ("=== Value ranges of %s ===\n\n",
+	  g->function ? g->function->name : "the top level");
+  for (i = 0; i < ssa->nvalues; i++)
+    {
+      struct ssa_value *v = ssa->values[i];
+
+      if (v->forward)
+	continue;
+      printf ("%s.%lu ", v->symbol->name, (unsigned long) v->id);
+      if (ranges[i].empty)
+	printf ("empty\n");
+      else
+	printf ("[%ld, %ld]\n", ranges[i].lo, ranges[i].hi);
+    }
+  fputc ('\n', stdout);
+}
+
+
+/* Rewriting the tree */
+
+static void
+vra_rewrite (void)
+{
+  size_t i;
+  struct range r;
+
+  folding = 1;
+  for (i = 0; i < ssa->nsites; i++)
+    {
+      struct ssa_site *site = ssa->sites[i];
+      NODE *expr;
+
+      if (!ssa->blocks[site->block->index].executable)
+	continue;
+      if (!site->expr)
+	{
+	  if (site->stmt->type == NODE_CALL)
+	    eval (site->stmt, site->block);
+	  continue;
+	}
+      expr = site->expr->v.expr;
+      r = eval (expr, site->block);
+      if (site->is_branch && expr->type != NODE_CONST)
+	fold_truth (expr, range_truth (r));
+    }
+  folding = 0;
+}
+
+/* Run the value-range analysis on the program rooted at *ROOTP.
+   Returns the number of nodes folded. */
+size_t
+vra_run (NODE **rootp)
+{
+  struct cfg *graphs, *g;
+
+  nfolded = nsafe = 0;
+  ipa_analyze (*rootp);
+  graphs = cfg_build (*rootp);
+  for (g = graphs; g; g = g->next)
+    {
+      ssa = ssa_build (g);
+      vra_solve ();
+      if (verbose > 2)
+	vra_print ();
+      vra_rewrite ();
+      free (ranges);
+      free (changes);
+      ranges = NULL;
+      changes = NULL;
+      ssa_free (ssa);
+      ssa = NULL;
+    }
+  cfg_free (graphs);
+  ipa_free ();
+
+  free (value_work);
+  free (block_work);
+  value_work = NULL;
+  block_work = NULL;
+  value_work_size = block_work_size = 0;
+
+  if (verbose > 1)
+    printf ("Value ranges: %lu nodes folded, %lu divisions safe\n",
+	    (unsigned long) nfolded, (unsigned long) nsafe);
+  return nfolded;
+}